@@ -16,6 +16,9 @@ bool kIsDesktop =
 /// Indicates whether the current environment is running in macOS
 bool kIsMacOS = helper.getPlatformType() == 'macos';
 
+/// Indicates whether the current environment is running in Linux
+bool kIsLinux = helper.getPlatformType() == 'linux';
+
 /// Indicates the default padding for checkbox and radio button form fields on mobile platforms.
 const double kFormFieldSelectionPadding = 3.0;
 
@@ -1,4 +1,6 @@
+import 'dart:async';
 import 'dart:io';
+import 'dart:math';
 
 import 'package:flutter/foundation.dart';
 import 'package:flutter/material.dart';
@@ -6,6 +8,8 @@ import 'package:flutter/services.dart';
 import 'package:syncfusion_pdfviewer_platform_interface/pdfviewer_platform_interface.dart';
 import 'package:uuid/uuid.dart';
 
+import 'pdfviewer_helper.dart';
+
 /// Establishes communication between native(Android and iOS) code
 /// and flutter code using [MethodChannel]
 class PdfViewerPlugin {
@@ -14,21 +18,64 @@ class PdfViewerPlugin {
   List<dynamic>? _originalWidth;
   String? _documentID;
   String? _tempFilePath;
+  int _firstVisiblePage = 0;
+  int _lastVisiblePage = 0;
+  bool _wasMoving = false;
+  final Stopwatch _viewportHintStopwatch = Stopwatch();
+
+  /// Shortest interval between viewport hints within the same page range.
+  static const Duration _viewportHintInterval = Duration(milliseconds: 100);
+
+  /// Size of the chunks documents are uploaded in.
+  static const int _documentChunkSize = 4 * 1024 * 1024;
+
+  /// Upload of the document being opened, until it is finalized or aborted.
+  int? _uploadID;
+
+  /// Data and events of a document opened while its bytes are still arriving.
+  StreamSubscription<List<int>>? _progressiveData;
+  StreamSubscription<Map<Object?, Object?>>? _progressiveEvents;
+  final StreamController<List<int>> _pagesAvailable =
+      StreamController<List<int>>.broadcast();
 
   /// Initialize the PDF renderer.
+  ///
+  /// On Linux the document opens on a background thread and [onOpenProgress] is called with each open phase:
+  /// `documentParsed`, `pagesCounted`, `indexingGeometry` and `geometryIndexed`, along with the number of pages
+  /// indexed so far and the page count.
   Future<int> initializePdfRenderer(
     Uint8List documentBytes,
-    String? password,
-  ) async {
+    String? password, {
+    void Function(String phase, int pagesDone, int pageCount)? onOpenProgress,
+  }) async {
     _documentID = const Uuid().v1();
     String? pageCount;
-    if (_documentID != null) {
+    final String documentID = _documentID!;
+    final StreamSubscription<Map<Object?, Object?>>? openProgress =
+        kIsLinux && onOpenProgress != null
+            ? PdfViewerPlatform.instance.documentEvents
+                .where(
+                  (Map<Object?, Object?> event) =>
+                      event['documentID'] == documentID &&
+                      event['event'] == 'openProgress',
+                )
+                .listen(
+                  (Map<Object?, Object?> event) => onOpenProgress(
+                    event['phase']! as String,
+                    event['pagesDone']! as int,
+                    event['pageCount']! as int,
+                  ),
+                )
+            : null;
+    try {
       if (kIsWeb) {
         pageCount = await PdfViewerPlatform.instance.initializePdfRenderer(
           documentBytes,
           _documentID!,
           password,
         );
+      } else if (kIsLinux) {
+        pageCount = await _uploadDocument(documentBytes, password);
       } else {
         final tempDirectory = await Directory.systemTemp.createTemp('pdf_');
         final tempFile = File(
@@ -42,11 +89,231 @@ class PdfViewerPlugin {
           password,
         );
       }
+    } finally {
+      await openProgress?.cancel();
     }
     _pageCount = int.parse(pageCount!);
     return _pageCount;
   }
 
+  /// Streams the document to the platform in chunks that are copied straight into one preallocated native buffer,
+  /// instead of encoding the whole document into a single method call.
+  Future<String?> _uploadDocument(
+    Uint8List documentBytes,
+    String? password,
+  ) async {
+    final int? uploadID = await PdfViewerPlatform.instance.beginDocumentUpload(
+      documentBytes.length,
+    );
+    if (uploadID == null) {
+      return null;
+    }
+    _uploadID = uploadID;
+    try {
+      for (
+        int offset = 0;
+        offset < documentBytes.length;
+        offset += _documentChunkSize
+      ) {
+        if (_uploadID != uploadID) {
+          // The document was closed meanwhile, which aborted the upload
+          throw StateError('The document upload was aborted');
+        }
+        final int end = min(offset + _documentChunkSize, documentBytes.length);
+        await PdfViewerPlatform.instance.appendDocumentChunk(
+          uploadID,
+          offset,
+          Uint8List.sublistView(documentBytes, offset, end),
+        );
+      }
+    } catch (_) {
+      await _abortUpload();
+      rethrow;
+    }
+    // Finalizing ends the upload, whether or not the document opens
+    _uploadID = null;
+    return PdfViewerPlatform.instance.finalizeDocumentUpload(
+      uploadID,
+      _documentID!,
+      password,
+    );
+  }
+
+  /// Releases the native buffer of the upload in progress, if any.
+  Future<void> _abortUpload() async {
+    final int? uploadID = _uploadID;
+    _uploadID = null;
+    if (uploadID != null) {
+      await PdfViewerPlatform.instance
+          .abortDocumentUpload(uploadID)
+          .catchError((_) => false);
+    }
+  }
+
+  /// Initializes the PDF renderer from a document whose bytes are still arriving, such as a download in progress or
+  /// a file that is still being written.
+  ///
+  /// The bytes of [data] are forwarded as they arrive. The returned page count completes as soon as the document
+  /// structure is available, which for a linearized document is after its first part; [pagesAvailable] then reports
+  /// the pages that can be rendered while the rest of the document arrives.
+  ///
+  /// When the source can also be read out of order, such as a download supporting HTTP range requests, [readRange]
+  /// fetches the byte ranges the renderer needs next ahead of [data], so that a page far into a document that is not
+  /// linearized opens without waiting for the bytes before it.
+  Future<int> initializeProgressivePdfRenderer(
+    int length,
+    Stream<List<int>> data,
+    String? password, {
+    Future<List<int>> Function(int offset, int length)? readRange,
+  }) async {
+    final String documentID = _documentID = const Uuid().v1();
+    final Completer<int> pageCount = Completer<int>();
+    // End of the bytes [data] delivered so far, and starts of the ranges read ahead of it
+    int offset = 0;
+    final Set<int> fetchedRanges = <int>{};
+    int? uploadID;
+    final StreamSubscription<Map<Object?, Object?>> events = PdfViewerPlatform
+        .instance
+        .documentEvents
+        .where(
+          (Map<Object?, Object?> event) => event['documentID'] == documentID,
+        )
+        .listen((Map<Object?, Object?> event) {
+          switch (event['event']) {
+            case 'documentAvailable':
+              if (!pageCount.isCompleted) {
+                pageCount.complete(event['pageCount']! as int);
+              }
+            case 'documentFailed':
+              if (!pageCount.isCompleted) {
+                pageCount.completeError(
+                  StateError('Unable to open the document'),
+                );
+              }
+            case 'pagesAvailable':
+              _pagesAvailable.add(
+                (event['pageNumbers']! as Int32List).toList(),
+              );
+            case 'dataRequested':
+              if (readRange != null && uploadID != null) {
+                _fetchRanges(
+                  uploadID!,
+                  event['ranges']! as Int64List,
+                  readRange,
+                  () => offset,
+                  fetchedRanges,
+                );
+              }
+          }
+        });
+
+    try {
+      uploadID = await PdfViewerPlatform.instance.beginProgressiveDocument(
+        documentID,
+        length,
+        password,
+        readRange != null,
+      );
+    } catch (_) {
+      await events.cancel();
+      rethrow;
+    }
+    if (uploadID == null) {
+      await events.cancel();
+      throw StateError('Unable to open the document');
+    }
+
+    _progressiveData = data.listen(
+      (List<int> bytes) {
+        final Uint8List chunk =
+            bytes is Uint8List ? bytes : Uint8List.fromList(bytes);
+        // Waits for the platform to copy the chunk before reading the next one
+        _progressiveData?.pause(
+          PdfViewerPlatform.instance.appendDocumentChunk(
+            uploadID!,
+            offset,
+            chunk,
+          ),
+        );
+        offset += chunk.length;
+      },
+      onDone: () {
+        _progressiveData = null;
+        if (!pageCount.isCompleted) {
+          pageCount.completeError(StateError('Unable to open the document'));
+        }
+      },
+      cancelOnError: true,
+    );
+
+    try {
+      _pageCount = await pageCount.future;
+    } catch (_) {
+      // Nothing more arrives for a document that failed to open
+      await _progressiveData?.cancel();
+      _progressiveData = null;
+      await events.cancel();
+      rethrow;
+    }
+    _progressiveEvents = events;
+    return _pageCount;
+  }
+
+  /// Reads the byte range and sends it to the platform. Chunks of a document closed meanwhile are dropped there.
+  Future<void> _fetchRange(
+    int uploadID,
+    int start,
+    int size,
+    Future<List<int>> Function(int offset, int length) readRange,
+    Set<int> fetchedRanges,
+  ) async {
+    try {
+      final List<int> bytes = await readRange(start, size);
+      await PdfViewerPlatform.instance.appendDocumentChunk(
+        uploadID,
+        start,
+        bytes is Uint8List ? bytes : Uint8List.fromList(bytes),
+      );
+    } catch (_) {
+      // The data stream still delivers the range, a failed read is retried when it is asked for again
+      fetchedRanges.remove(start);
+    }
+  }
+
+  /// Reads the byte ranges the renderer asked for, as offset and size pairs, and sends them ahead of the data stream.
+  /// Ranges the stream already delivered or that are being fetched are skipped.
+  void _fetchRanges(
+    int uploadID,
+    Int64List ranges,
+    Future<List<int>> Function(int offset, int length) readRange,
+    int Function() streamOffset,
+    Set<int> fetchedRanges,
+  ) {
+    for (int i = 0; i + 1 < ranges.length; i += 2) {
+      final int start = ranges[i];
+      final int size = ranges[i + 1];
+      if (start + size <= streamOffset() || !fetchedRanges.add(start)) {
+        continue;
+      }
+      _fetchRange(uploadID, start, size, readRange, fetchedRanges);
+    }
+  }
+
+  /// Page numbers that became available in a progressively opened document.
+  Stream<List<int>> get pagesAvailable => _pagesAvailable.stream;
+
+  /// Whether the data of the specified page has arrived.
+  Future<bool> isPageAvailable(int pageNumber) async {
+    if (_documentID == null) {
+      return false;
+    }
+    return await PdfViewerPlatform.instance.isPageAvailable(
+          _documentID!,
+          pageNumber,
+        ) ??
+        false;
+  }
+
   /// Get the current document ID
   String get documentID => _documentID ?? '';
 
@@ -66,9 +333,240 @@ class PdfViewerPlugin {
     return _originalWidth;
   }
 
+  /// Retrieves the width and height of the PDF pages with a single call to the page geometry index of the platform.
+  Future<void> getPageGeometry() async {
+    final Map<Object?, Object?>? result = await PdfViewerPlatform.instance
+        .getPageGeometry(_documentID!);
+    if (result == null) {
+      return;
+    }
+    final Float64List geometry = result['geometry']! as Float64List;
+    final int stride = result['stride']! as int;
+    final List<double> widths = <double>[];
+    final List<double> heights = <double>[];
+    for (int i = 0; i + stride <= geometry.length; i += stride) {
+      widths.add(geometry[i + 1]);
+      heights.add(geometry[i + 2]);
+    }
+    _originalWidth = widths;
+    _originalHeight = heights;
+  }
+
+  /// Original width of PDF pages retrieved with [getPageGeometry].
+  List<double>? get pagesWidth => _originalWidth?.cast<double>();
+
+  /// Original height of PDF pages retrieved with [getPageGeometry].
+  List<double>? get pagesHeight => _originalHeight?.cast<double>();
+
+  /// Renders the pages given as page number, width and height triples in a single platform call.
+  ///
+  /// Returns the RGBA pixels of each page in request order, as views of one buffer. Pages that could not be rendered
+  /// are empty.
+  Future<List<Uint8List>?> renderPages(
+    Int32List requests, {
+    int? requestID,
+  }) async {
+    final Map<Object?, Object?>? result = await PdfViewerPlatform.instance
+        .renderPages(_documentID!, requests, requestID: requestID);
+    if (result == null) {
+      return null;
+    }
+    final Uint8List pixels = result['pixels']! as Uint8List;
+    final List<int> offsets = result['offsets']! as List<int>;
+    return <Uint8List>[
+      for (int i = 0; i + 1 < offsets.length; i++)
+        Uint8List.sublistView(pixels, offsets[i], offsets[i + 1]),
+    ];
+  }
+
+  /// Lays out the thumbnails of all pages at the specified height and starts generating them in the background.
+  ///
+  /// [thumbnailsReady] reports the atlases as their thumbnails are generated.
+  Future<Map<Object?, Object?>?> startThumbnails(int thumbnailHeight) async {
+    if (_documentID == null) {
+      return null;
+    }
+    return PdfViewerPlatform.instance.startThumbnails(
+      _documentID!,
+      thumbnailHeight,
+    );
+  }
+
+  /// Atlas indexes and page numbers of the thumbnails generated in the background.
+  Stream<Map<Object?, Object?>> get thumbnailsReady => PdfViewerPlatform
+      .instance
+      .documentEvents
+      .where(
+        (Map<Object?, Object?> event) =>
+            event['documentID'] == _documentID &&
+            event['event'] == 'thumbnailsReady',
+      );
+
+  /// Gets the pixels of the thumbnails of an atlas generated since the last call, or of all of them when [all] is set.
+  Future<Map<Object?, Object?>?> getThumbnailAtlas(
+    int atlasIndex, {
+    bool all = false,
+  }) async {
+    if (_documentID == null) {
+      return null;
+    }
+    return PdfViewerPlatform.instance.getThumbnailAtlas(
+      _documentID!,
+      atlasIndex,
+      all: all,
+    );
+  }
+
+  /// Sets the page range of the thumbnails on screen, the other atlases are freed first on memory pressure.
+  Future<void> setVisibleThumbnails(
+    int firstPageNumber,
+    int lastPageNumber,
+  ) async {
+    if (_documentID == null) {
+      return;
+    }
+    await PdfViewerPlatform.instance.setVisibleThumbnails(
+      _documentID!,
+      firstPageNumber,
+      lastPageNumber,
+    );
+  }
+
+  /// ID of the next text search run by the platform.
+  static int _nextSearchID = 0;
+  int? _searchID;
+
+  /// Searches the text through all pages of the document with the text engine of the platform and returns the number
+  /// of matches, or null when the search was cancelled.
+  ///
+  /// [onMatches] is called as the pages are searched, with the zero based page index and the bounds of each match on
+  /// the page, a match that wraps over lines having a rectangle per line.
+  Future<int?> searchText(
+    String query, {
+    bool matchCase = false,
+    bool wholeWord = false,
+    required void Function(int pageIndex, List<List<Rect>> matches) onMatches,
+  }) async {
+    final String documentID = _documentID!;
+    final int searchID = _searchID = _nextSearchID++;
+    final StreamSubscription<Map<Object?, Object?>> matches = PdfViewerPlatform
+        .instance
+        .documentEvents
+        .where(
+          (Map<Object?, Object?> event) =>
+              event['documentID'] == documentID &&
+              event['event'] == 'textFound' &&
+              event['searchID'] == searchID,
+        )
+        .listen((Map<Object?, Object?> event) {
+          final Int32List rectCounts = event['rectCounts']! as Int32List;
+          final Float64List rects = event['rects']! as Float64List;
+          final List<List<Rect>> bounds = <List<Rect>>[];
+          int offset = 0;
+          for (final int rectCount in rectCounts) {
+            bounds.add(<Rect>[
+              for (int i = 0; i < rectCount; i++, offset += 4)
+                Rect.fromLTRB(
+                  rects[offset],
+                  rects[offset + 1],
+                  rects[offset + 2],
+                  rects[offset + 3],
+                ),
+            ]);
+          }
+          onMatches((event['pageNumber']! as int) - 1, bounds);
+        });
+    try {
+      return await PdfViewerPlatform.instance.searchText(
+        documentID,
+        query,
+        searchID,
+        matchCase: matchCase,
+        wholeWord: wholeWord,
+      );
+    } on PlatformException catch (e) {
+      if (e.code == 'SearchCancelled') {
+        return null;
+      }
+      rethrow;
+    } finally {
+      await matches.cancel();
+      if (_searchID == searchID) {
+        _searchID = null;
+      }
+    }
+  }
+
+  /// Stops the pending text search.
+  void cancelTextSearch() {
+    if (_searchID != null) {
+      PdfViewerPlatform.instance
+          .cancelTextSearch(_searchID!)
+          .catchError((_) => false);
+      _searchID = null;
+    }
+  }
+
+  /// Gets the text of the specified page with the text engine of the platform.
+  Future<String?> getPageText(int pageNumber) async {
+    if (_documentID == null) {
+      return null;
+    }
+    return PdfViewerPlatform.instance.getPageText(_documentID!, pageNumber);
+  }
+
+  /// Reports the visible page range to the platform when it changes, along
+  /// with the visible region, the scroll [velocity] in points per second and
+  /// the grid tile [scale] that the platform prefetches ahead of. Hints within
+  /// the same range are sent at most every [_viewportHintInterval] while
+  /// scrolling, and once more when the scrolling stops.
+  void viewportHint(
+    int firstPage,
+    int lastPage, {
+    Float64List? visibleRect,
+    Offset velocity = Offset.zero,
+    double? scale,
+    bool horizontal = false,
+  }) {
+    if (_documentID == null) {
+      return;
+    }
+    final bool isMoving = velocity != Offset.zero;
+    if (firstPage == _firstVisiblePage &&
+        lastPage == _lastVisiblePage &&
+        isMoving == _wasMoving &&
+        (!isMoving || _viewportHintStopwatch.elapsed < _viewportHintInterval)) {
+      return;
+    }
+    _firstVisiblePage = firstPage;
+    _lastVisiblePage = lastPage;
+    _wasMoving = isMoving;
+    _viewportHintStopwatch
+      ..reset()
+      ..start();
+    PdfViewerPlatform.instance
+        .viewportHint(
+          _documentID!,
+          firstPage,
+          lastPage,
+          visibleRect: visibleRect,
+          velocityX: velocity.dx,
+          velocityY: velocity.dy,
+          scale: scale,
+          horizontal: horizontal,
+        )
+        .catchError((_) {});
+  }
+
   /// Dispose the rendered pages
   Future<void> closeDocument() async {
     imageCache.clear();
+    cancelTextSearch();
+    await _progressiveData?.cancel();
+    await _progressiveEvents?.cancel();
+    _progressiveData = null;
+    _progressiveEvents = null;
+    await _abortUpload();
     if (_documentID != null) {
       await PdfViewerPlatform.instance.closeDocument(_documentID!);
     }
@@ -79,6 +577,9 @@ class PdfViewerPlugin {
       }
     }
     _pageCount = 0;
+    _firstVisiblePage = 0;
+    _lastVisiblePage = 0;
+    _wasMoving = false;
     _originalWidth = null;
     _originalHeight = null;
     _tempFilePath = null;
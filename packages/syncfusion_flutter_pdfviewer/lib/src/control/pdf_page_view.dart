@@ -1,4 +1,5 @@
 import 'dart:async';
+import 'dart:math';
 import 'dart:ui' as ui;
 
 import 'package:async/async.dart';
@@ -22,6 +23,9 @@ import 'pdf_scrollable.dart';
 import 'pdfviewer_canvas.dart';
 import 'single_page_view.dart';
 
+/// ID of the next native page or tile render request.
+int _nextRenderRequestID = 0;
+
 /// Wrapper class of [Image] widget which shows the PDF pages as an image
 class PdfPageView extends StatefulWidget {
   /// Constructs PdfPageView instance with the given parameters.
@@ -255,10 +259,26 @@ class PdfPageViewState extends State<PdfPageView> {
 
   RawImage? _pdfPage;
   RawImage? _tileImage;
+
+  /// Native texture that displays the page on Linux, used instead of [_pdfPage]
+  Texture? _pageTexture;
+  Future<int?>? _pageTextureID;
+  int? _pageTextureRequestID;
+
+  /// Whether the latest page image request came during a fast scroll
+  bool _isDraftRequested = false;
+
+  /// Whether [_pageTexture] holds, or is being rendered with, a draft
+  bool _isDraftImage = false;
   CancelableOperation<Uint8List?>? _tileImageOperation;
   CancelableOperation<Uint8List?>? _pageImageOperation;
   Timer? _pageTimer;
   TileImage? _tileImageCache;
+
+  /// Fixed grid tiles shown over the page on Linux, used instead of [_tileImage]
+  Map<int, GridTileImage> _gridTiles = <int, GridTileImage>{};
+  double? _gridTileScale;
+  CancelableOperation<Map<Object?, Object?>?>? _gridTileOperation;
   double _dpr = 1.0;
   int _numberOfActivePointers = 0;
   bool _isZooming = false;
@@ -316,7 +336,7 @@ class PdfPageViewState extends State<PdfPageView> {
                 !widget.isSinglePageView
             ? pageSpacing
             : 0.0;
-    if (_pdfPage != null) {
+    if (_pdfPage != null || _pageTexture != null) {
       _calculateHeightPercentage();
       if (!kIsDesktop) {
         PaintingBinding.instance.imageCache.clear();
@@ -339,7 +359,7 @@ class PdfPageViewState extends State<PdfPageView> {
                           height: widget.height,
                           child: Semantics(
                             label: widget.semanticLabel,
-                            child: _pdfPage,
+                            child: _pageTexture ?? _pdfPage,
                           ),
                         ),
                         if (_tileImageCache != null && _tileImage != null)
@@ -362,6 +382,7 @@ class PdfPageViewState extends State<PdfPageView> {
                               child: _tileImage,
                             ),
                           ),
+                        ..._buildGridTiles(),
                       ],
                     ),
                     Container(
@@ -385,7 +406,7 @@ class PdfPageViewState extends State<PdfPageView> {
                           height: widget.height,
                           child: Semantics(
                             label: widget.semanticLabel,
-                            child: _pdfPage,
+                            child: _pageTexture ?? _pdfPage,
                           ),
                         ),
                         if (_tileImageCache != null && _tileImage != null)
@@ -408,6 +429,7 @@ class PdfPageViewState extends State<PdfPageView> {
                               child: _tileImage,
                             ),
                           ),
+                        ..._buildGridTiles(),
                       ],
                     ),
                     Container(
@@ -917,14 +939,16 @@ class PdfPageViewState extends State<PdfPageView> {
         widget.pdfDocument!.pages[widget.pageIndex].size;
     final double ratio = 1 / _heightPercentage;
     final double imageFactor = ratio * zoomLevel;
-    if (widget.pdfDocument != null && _previousImageFactor != imageFactor) {
+    final bool isDraft = kIsLinux && _isDraftRequested;
+    if (widget.pdfDocument != null &&
+        (_previousImageFactor != imageFactor || (_isDraftImage && !isDraft))) {
       _previousImageFactor = imageFactor;
       if (ratio < 0.5 ||
           zoomLevel > 1.75 ||
           (!kIsDesktop && imageFactor > 2) ||
           (kIsDesktop && imageFactor > 4)) {
         _isTile = true;
-        if (_pdfPage != null) {
+        if ((_pdfPage != null || _pageTexture != null) && !_isDraftImage) {
           return;
         }
 
@@ -942,18 +966,29 @@ class PdfPageViewState extends State<PdfPageView> {
         }
       } else {
         _tileImageCache = null;
+        if (_gridTiles.isNotEmpty && mounted) {
+          setState(_clearGridTiles);
+        }
         _isTile = false;
         _imageWidth = (widget.width * zoomLevel * _dpr).toInt();
         _imageHeight = (widget.height * zoomLevel * _dpr).toInt();
       }
 
+      if (kIsLinux) {
+        await _getPageTexture(isDraft: isDraft && !_isTile);
+        return;
+      }
+
       try {
-        _pageImageOperation = CancelableOperation<Uint8List?>.fromFuture(
+        final int requestID = _nextRenderRequestID++;
+        _pageImageOperation = _createRenderOperation(
+          requestID,
           PdfViewerPlatform.instance.getPage(
             widget.pageIndex + 1,
             _imageWidth,
             _imageHeight,
             widget.documentID,
+            requestID: requestID,
           ),
         );
         await _pageImageOperation?.value.then((Uint8List? pageImage) {
@@ -977,6 +1012,64 @@ class PdfPageViewState extends State<PdfPageView> {
     }
   }
 
+  /// Renders the page into a native texture, so the page pixels are neither
+  /// sent over the platform channel nor decoded in Dart.
+  ///
+  /// A draft is rendered at half the resolution and without anti-aliasing,
+  /// the texture stretches it over the page until the full quality render
+  /// replaces it.
+  Future<void> _getPageTexture({bool isDraft = false}) async {
+    final Future<int?> textureIDFuture =
+        _pageTextureID ??= PdfViewerPlatform.instance.createPageTexture(
+          widget.documentID,
+        );
+    try {
+      final int? textureID = await textureIDFuture;
+      if (textureID == null || !mounted || _pageTextureID != textureIDFuture) {
+        return;
+      }
+      final int requestID = _nextRenderRequestID++;
+      _pageTextureRequestID = requestID;
+      _isDraftImage = isDraft;
+      final bool? isRendered = await PdfViewerPlatform.instance
+          .renderPageTexture(
+            textureID,
+            widget.pageIndex + 1,
+            isDraft ? max(1, _imageWidth ~/ 2) : _imageWidth,
+            isDraft ? max(1, _imageHeight ~/ 2) : _imageHeight,
+            widget.documentID,
+            requestID: requestID,
+            quality: isDraft ? PdfRenderQuality.draft : PdfRenderQuality.full,
+          );
+      if (_pageTextureRequestID == requestID) {
+        _pageTextureRequestID = null;
+      }
+      if (isRendered == true && mounted && _pageTextureID == textureIDFuture) {
+        setState(() {
+          _pageTexture = Texture(textureId: textureID);
+        });
+      }
+    } catch (_) {}
+  }
+
+  /// Releases the native page texture and stops its pending render.
+  void _disposePageTexture() {
+    if (_pageTextureRequestID != null) {
+      PdfViewerPlatform.instance
+          .cancelRender(_pageTextureRequestID!)
+          .catchError((_) {});
+      _pageTextureRequestID = null;
+    }
+    _pageTextureID?.then((int? textureID) {
+      if (textureID != null) {
+        PdfViewerPlatform.instance.disposePageTexture(textureID);
+      }
+    }, onError: (_) {});
+    _pageTextureID = null;
+    _pageTexture = null;
+    _isDraftImage = false;
+  }
+
   /// Method to rebuild the widget
   void rebuild() {
     if (mounted) {
@@ -1006,6 +1099,23 @@ class PdfPageViewState extends State<PdfPageView> {
     }
   }
 
+  /// Wraps the native render so that cancelling the operation also stops the
+  /// render on platforms that support native cancellation.
+  CancelableOperation<Uint8List?> _createRenderOperation(
+    int requestID,
+    Future<Uint8List?> render,
+  ) {
+    bool isCompleted = false;
+    return CancelableOperation<Uint8List?>.fromFuture(
+      render.whenComplete(() => isCompleted = true),
+      onCancel: () {
+        if (!isCompleted && kIsLinux) {
+          PdfViewerPlatform.instance.cancelRender(requestID).catchError((_) {});
+        }
+      },
+    );
+  }
+
   /// Create image from the given raw pixels
   Future<ui.Image> _createImage(Uint8List pixels, int width, int height) {
     final Completer<ui.Image> comp = Completer<ui.Image>();
@@ -1119,13 +1229,26 @@ class PdfPageViewState extends State<PdfPageView> {
 
       double ratio = 1 / _heightPercentage;
       ratio = ratio < 1 && kIsDesktop ? 1 : ratio;
+      if (kIsLinux) {
+        if (zoomLevel == transformationController.value[0]) {
+          await _getGridTiles(
+            transformationController,
+            exposed,
+            zoomLevel,
+            ratio,
+          );
+        }
+        return;
+      }
       if (zoomLevel == transformationController.value[0]) {
         try {
           final Size tileImageSize = Size(
             exposed.width * _dpr * ratio,
             exposed.height * _dpr * ratio,
           );
-          _tileImageOperation = CancelableOperation<Uint8List?>.fromFuture(
+          final int requestID = _nextRenderRequestID++;
+          _tileImageOperation = _createRenderOperation(
+            requestID,
             PdfViewerPlatform.instance.getTileImage(
               widget.pageIndex + 1,
               zoomLevel * _dpr * ratio,
@@ -1134,6 +1257,7 @@ class PdfPageViewState extends State<PdfPageView> {
               tileImageSize.width,
               tileImageSize.height,
               widget.documentID,
+              requestID: requestID,
             ),
           );
           final Future<Uint8List?> imageFuture = _tileImageOperation!.value;
@@ -1178,8 +1302,139 @@ class PdfPageViewState extends State<PdfPageView> {
     }
   }
 
-  /// Get the page image
-  void getPageImage(Size viewportSize, double zoomLevel) {
+  /// Get the fixed grid tiles covering the exposed region of the page on Linux
+  Future<void> _getGridTiles(
+    TransformationController transformationController,
+    Rect exposed,
+    double zoomLevel,
+    double ratio,
+  ) async {
+    final double? knownScale = _gridTileScale;
+    final List<int> knownTiles = <int>[];
+    for (final GridTileImage tile in _gridTiles.values) {
+      knownTiles
+        ..add(tile.column)
+        ..add(tile.row);
+    }
+    final int requestID = _nextRenderRequestID++;
+    final CancelableOperation<Map<Object?, Object?>?> operation =
+        CancelableOperation<Map<Object?, Object?>?>.fromFuture(
+          PdfViewerPlatform.instance.getGridTiles(
+            widget.pageIndex + 1,
+            zoomLevel * _dpr * ratio,
+            exposed.left / zoomLevel,
+            exposed.top / zoomLevel,
+            exposed.width / zoomLevel,
+            exposed.height / zoomLevel,
+            widget.documentID,
+            knownScale: knownScale,
+            knownTiles: Int32List.fromList(knownTiles),
+            requestID: requestID,
+          ),
+          onCancel: () {
+            PdfViewerPlatform.instance
+                .cancelRender(requestID)
+                .catchError((_) {});
+          },
+        );
+    _gridTileOperation = operation;
+    try {
+      final Map<Object?, Object?>? result = await operation.value;
+      if (result == null ||
+          !mounted ||
+          operation.isCanceled ||
+          zoomLevel != transformationController.value[0]) {
+        return;
+      }
+      final double scale = result['scale']! as double;
+      final int tileSize = result['tileSize']! as int;
+      final bool isSameScale = scale == knownScale;
+      final Map<int, GridTileImage> gridTiles = <int, GridTileImage>{};
+      for (final Object? value in result['tiles']! as List<Object?>) {
+        final Map<Object?, Object?> tile = value! as Map<Object?, Object?>;
+        final int column = tile['column']! as int;
+        final int row = tile['row']! as int;
+        final int key = GridTileImage.getKey(column, row);
+        final Uint8List? pixels = tile['pixels'] as Uint8List?;
+        if (pixels == null) {
+          if (isSameScale && _gridTiles.containsKey(key)) {
+            gridTiles[key] = _gridTiles[key]!;
+          }
+          continue;
+        }
+        final int width = tile['width']! as int;
+        final int height = tile['height']! as int;
+        final ui.Image image = await _createImage(pixels, width, height);
+        gridTiles[key] = GridTileImage(
+          column,
+          row,
+          RawImage(image: image, fit: BoxFit.fill),
+          Rect.fromLTWH(
+            column * tileSize / scale,
+            row * tileSize / scale,
+            width / scale,
+            height / scale,
+          ),
+        );
+      }
+      if (!mounted || operation.isCanceled) {
+        for (final GridTileImage tile in gridTiles.values) {
+          if (!identical(_gridTiles[tile.key], tile)) {
+            tile.image.image?.dispose();
+          }
+        }
+        return;
+      }
+      setState(() {
+        for (final GridTileImage tile in _gridTiles.values) {
+          if (!identical(gridTiles[tile.key], tile)) {
+            tile.image.image?.dispose();
+          }
+        }
+        _gridTiles = gridTiles;
+        _gridTileScale = scale;
+      });
+    } catch (_) {
+    } finally {
+      if (identical(_gridTileOperation, operation)) {
+        _gridTileOperation = null;
+      }
+    }
+  }
+
+  /// Positions the fixed grid tiles over the page
+  List<Widget> _buildGridTiles() {
+    return <Widget>[
+      for (final GridTileImage tile in _gridTiles.values)
+        Positioned(
+          top: tile.bounds.top / _heightPercentage,
+          left: tile.bounds.left / _heightPercentage,
+          width: tile.bounds.width / _heightPercentage,
+          height: tile.bounds.height / _heightPercentage,
+          child: tile.image,
+        ),
+    ];
+  }
+
+  /// Releases the fixed grid tiles
+  void _clearGridTiles() {
+    _gridTileOperation?.cancel();
+    _gridTileOperation = null;
+    for (final GridTileImage tile in _gridTiles.values) {
+      tile.image.image?.dispose();
+    }
+    _gridTiles = <int, GridTileImage>{};
+    _gridTileScale = null;
+  }
+
+  /// Get the page image, a draft when [isDraft] is true during a fast scroll.
+  /// A later request that is not a draft refines it.
+  void getPageImage(
+    Size viewportSize,
+    double zoomLevel, {
+    bool isDraft = false,
+  }) {
+    _isDraftRequested = isDraft;
     _pageTimer ??= Timer(Durations.short2, () {
       if (widget.pdfPages.isEmpty) {
         return;
@@ -1206,6 +1461,12 @@ class PdfPageViewState extends State<PdfPageView> {
       _pdfPage = null;
       _tileImage = null;
     }
+    _disposePageTexture();
+    if (dispose || !mounted) {
+      _clearGridTiles();
+    } else {
+      setState(_clearGridTiles);
+    }
     _tileImageOperation?.cancel();
     _pageImageOperation?.cancel();
     _tileImageOperation = null;
@@ -1247,3 +1508,27 @@ class TileImage {
   /// Image size
   Size imageSize;
 }
+
+/// Information about a fixed grid tile
+class GridTileImage {
+  /// Constructor of GridTileImage
+  GridTileImage(this.column, this.row, this.image, this.bounds);
+
+  /// Column of the tile in the grid
+  final int column;
+
+  /// Row of the tile in the grid
+  final int row;
+
+  /// Tile image
+  final RawImage image;
+
+  /// Bounds of the tile in page points
+  final Rect bounds;
+
+  /// Key of the tile in the grid
+  int get key => getKey(column, row);
+
+  /// Gets the key of the tile at the specified column and row
+  static int getKey(int column, int row) => (column << 16) | row;
+}
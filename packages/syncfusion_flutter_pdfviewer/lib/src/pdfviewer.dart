@@ -1219,6 +1219,9 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
   late BoxConstraints _viewportConstraints;
   int _previousPageNumber = 0;
   PdfDocument? _document;
+
+  /// Fraction of the pages the platform has indexed while opening the document, null while it is unknown.
+  double? _openProgress;
   bool _hasError = false;
   bool _panEnabled = true;
   bool _isMobileView = false;
@@ -1239,6 +1242,11 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
   bool _isPageChanged = false;
   bool _isSinglePageViewPageChanged = false;
   final List<int> _renderedImages = <int>[];
+  Offset? _previousSceneOffset;
+  final Stopwatch _sceneStopwatch = Stopwatch();
+
+  /// Refines the draft page images once the viewport stops moving.
+  Timer? _draftSettleTimer;
   final Map<int, String> _pageTextExtractor = <int, String>{};
   Size _totalImageSize = Size.zero;
   late PdfScrollDirection _scrollDirection;
@@ -1562,6 +1570,7 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
     _textExtractionEngine = null;
     _decryptionEngine?.dispose();
     _decryptionEngine = null;
+    _draftSettleTimer?.cancel();
     _disposeCollection(_originalHeight);
     _disposeCollection(_originalWidth);
     _renderedImages.clear();
@@ -1643,6 +1652,7 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
     imageCache.clear();
     _renderedImages.clear();
     _hasError = false;
+    _openProgress = null;
     _isDocumentLoadInitiated = false;
     _pdfPagesKey.clear();
     _maxPdfPageWidth = 0;
@@ -2318,14 +2328,17 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
         _retrieveFormFieldsDetails();
         _retrieveAnnotations();
         _pdfTextExtractor = PdfTextExtractor(_document!);
-        if (!kIsWeb) {
+        // Linux searches with the text engine of the platform instead
+        if (!kIsWeb && !kIsLinux) {
           _performTextExtraction();
         }
       }
       final int pageCount = await _plugin.initializePdfRenderer(
         _renderDigitalSignatures() ?? _pdfBytes,
         _password,
+        onOpenProgress: _handleOpenProgress,
       );
+      _openProgress = null;
       _pdfViewerController._pageCount = pageCount;
       if (pageCount > 0) {
         _pdfViewerController._pageNumber = 1;
@@ -2335,6 +2348,7 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
       _getPageSizes();
     } catch (e) {
       _pdfViewerController._reset();
+      _openProgress = null;
       _hasError = true;
       _textExtractionEngine?.dispose();
       _textExtractionEngine = null;
@@ -3621,11 +3635,28 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
     );
   }
 
+  /// Shows how far the platform got opening the document in the loading indicator.
+  void _handleOpenProgress(String phase, int pagesDone, int pageCount) {
+    if (!mounted) {
+      return;
+    }
+    setState(() {
+      _openProgress =
+          phase == 'geometryIndexed'
+              ? 1.0
+              : pageCount > 0 &&
+                  (phase == 'indexingGeometry' || phase == 'pagesCounted')
+              ? pagesDone / pageCount
+              : null;
+    });
+  }
+
   Widget _getEmptyLinearProgressView() {
     return Stack(
       children: <Widget>[
         _getEmptyContainer(),
         LinearProgressIndicator(
+          value: _isDecrypting ? null : _openProgress,
           valueColor: AlwaysStoppedAnimation<Color>(
             _pdfViewerThemeData!.progressBarColor ??
                 _effectiveThemeData!.progressBarColor ??
@@ -4072,6 +4103,18 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
     }
     _renderedImages.clear();
     final double zoomLevel = _transformationController.value[0];
+    final Offset sceneVelocity = _updateSceneVelocity();
+    final bool isDraft =
+        kIsLinux &&
+        widget.pageLayoutMode != PdfPageLayoutMode.single &&
+        _isFastScroll(sceneVelocity, zoomLevel);
+    if (isDraft) {
+      _draftSettleTimer?.cancel();
+      _draftSettleTimer = Timer(
+        const Duration(milliseconds: 150),
+        _checkVisiblePages,
+      );
+    }
     if (widget.pageLayoutMode == PdfPageLayoutMode.single) {
       if (!_pageTextExtractor.containsKey(
         _pdfViewerController.pageNumber - 1,
@@ -4125,6 +4168,7 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
           _pdfPagesKey[pageNumber]?.currentState?.getPageImage(
             _viewportSize,
             zoomLevel,
+            isDraft: isDraft,
           );
         } else {
           _pdfPagesKey[pageNumber]?.currentState?.clearPageImage();
@@ -4158,12 +4202,93 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
           _pdfPagesKey[pageNumber]?.currentState?.getPageImage(
             _viewportSize,
             zoomLevel,
+            isDraft: isDraft,
           );
         } else {
           _pdfPagesKey[pageNumber]?.currentState?.clearPageImage();
         }
       }
     }
+    if (kIsLinux && _renderedImages.isNotEmpty) {
+      _sendViewportHint(
+        _renderedImages.reduce(min),
+        _renderedImages.reduce(max),
+        zoomLevel,
+        sceneVelocity,
+      );
+    }
+  }
+
+  /// Returns the velocity of the viewport in layout units per second since the
+  /// previous check of the visible pages.
+  Offset _updateSceneVelocity() {
+    final Offset offset = _transformationController.toScene(Offset.zero);
+    final double elapsed = _sceneStopwatch.elapsedMicroseconds / 1e6;
+    final Offset? previousOffset = _previousSceneOffset;
+    _previousSceneOffset = offset;
+    _sceneStopwatch
+      ..reset()
+      ..start();
+    // Velocities over long pauses are stale, the viewport is then settled
+    if (previousOffset == null || elapsed <= 0 || elapsed >= 0.25) {
+      return Offset.zero;
+    }
+    return (offset - previousOffset) / elapsed;
+  }
+
+  /// Whether the viewport travels more than one and a half viewports per
+  /// second, too fast for full quality page renders to keep up.
+  bool _isFastScroll(Offset sceneVelocity, double zoomLevel) {
+    final double viewportExtent =
+        (_scrollDirection == PdfScrollDirection.horizontal
+            ? _viewportSize.width
+            : _viewportSize.height) /
+        zoomLevel;
+    return viewportExtent > 0 && sceneVelocity.distance > viewportExtent * 1.5;
+  }
+
+  /// Reports the visible pages to the Linux platform, with the visible region
+  /// and the scroll velocity in PDF points so that it prefetches ahead of the
+  /// viewport.
+  void _sendViewportHint(
+    int firstPage,
+    int lastPage,
+    double zoomLevel,
+    Offset sceneVelocity,
+  ) {
+    final Offset offset = _transformationController.toScene(Offset.zero);
+    if (widget.pageLayoutMode == PdfPageLayoutMode.single ||
+        _originalHeight == null ||
+        _originalHeight!.length < firstPage ||
+        _pdfPages[firstPage] == null ||
+        _pdfPages[firstPage]!.pageSize.height <= 0) {
+      _plugin.viewportHint(firstPage, lastPage);
+      return;
+    }
+
+    // Points per layout unit of the first page
+    final double factor =
+        _originalHeight![firstPage - 1] /
+        _pdfPages[firstPage]!.pageSize.height;
+    final double pageOffset = _pdfPages[firstPage]!.pageOffset;
+    final bool horizontal = _scrollDirection == PdfScrollDirection.horizontal;
+    final Float64List visibleRect = Float64List.fromList(<double>[
+      (horizontal ? offset.dx - pageOffset : offset.dx) * factor,
+      (horizontal ? offset.dy : offset.dy - pageOffset) * factor,
+      _viewportSize.width / zoomLevel * factor,
+      _viewportSize.height / zoomLevel * factor,
+    ]);
+    _plugin.viewportHint(
+      firstPage,
+      lastPage,
+      visibleRect: visibleRect,
+      velocity: sceneVelocity * factor,
+      scale:
+          zoomLevel > 1.75
+              ? zoomLevel * View.of(context).devicePixelRatio / factor
+              : null,
+      horizontal: horizontal,
+    );
   }
 
   bool _isPageVisible(int currentPageNumber) {
@@ -5978,6 +6103,8 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
           _handleTextSearch,
         );
         setState(() {});
+      } else if (kIsLinux) {
+        _performNativeTextSearch();
       } else {
         if (_isTextExtractionCompleted) {
           final String searchText =
@@ -6421,6 +6548,66 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
     );
   }
 
+  /// Perform text search for Linux on the document already loaded by the platform, which reports the matches of
+  /// each page as they are found.
+  Future<void> _performNativeTextSearch() async {
+    _pdfViewerController._pdfTextSearchResult._addListener(_handleTextSearch);
+    setState(() {});
+    _pdfViewerController._pdfTextSearchResult.clear();
+    final String searchText = _pdfViewerController._searchText;
+    final TextSearchOption? searchOption =
+        _pdfViewerController._textSearchOption;
+    final List<MatchedItem> textCollection = _textCollection!;
+    int? matchCount;
+    try {
+      matchCount = await _plugin.searchText(
+        searchText,
+        matchCase:
+            searchOption == TextSearchOption.caseSensitive ||
+            searchOption == TextSearchOption.both,
+        wholeWord:
+            searchOption == TextSearchOption.wholeWords ||
+            searchOption == TextSearchOption.both,
+        onMatches: (int pageIndex, List<List<Rect>> matches) {
+          if (!identical(_textCollection, textCollection)) {
+            return;
+          }
+          for (final List<Rect> bounds in matches) {
+            _textCollection!.add(
+              MatchedItemHelper.initialize(searchText, bounds, pageIndex),
+            );
+          }
+          if (_pdfViewerController._pdfTextSearchResult._totalSearchTextCount ==
+              0) {
+            _pdfViewerController._pdfTextSearchResult._updateResult(true);
+            _pdfViewerController._pdfTextSearchResult._currentOccurrenceIndex =
+                1;
+            _isPageChanged = false;
+            if (_pdfPages.isNotEmpty) {
+              _jumpToSearchInstance();
+            }
+          }
+          _pdfViewerController._pdfTextSearchResult._totalSearchTextCount =
+              _textCollection!.length;
+        },
+      );
+    } catch (e) {
+      matchCount = 0;
+    }
+    // Cleared or superseded by another search meanwhile
+    if (matchCount == null || !identical(_textCollection, textCollection)) {
+      return;
+    }
+    if (_textCollection!.isEmpty) {
+      _pdfViewerController._pdfTextSearchResult._currentOccurrenceIndex = 0;
+      _pdfViewerController._pdfTextSearchResult._totalSearchTextCount = 0;
+      _pdfViewerController._pdfTextSearchResult._updateResult(false);
+    }
+    _pdfViewerController._pdfTextSearchResult._updateSearchCompletedStatus(
+      true,
+    );
+  }
+
   /// Text search is run in separate thread
   static Future<void> _findTextAsync(SendPort sendPort) async {
     final ReceivePort receivePort = ReceivePort();
@@ -6438,8 +6625,11 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
     replyPort.send('SearchCompleted');
   }
 
-  /// Terminates the text search isolate.
+  /// Terminates the text search isolate, or the text search of the platform on Linux.
   void _killTextSearchIsolate() {
+    if (kIsLinux) {
+      _plugin.cancelTextSearch();
+    }
     if (_textSearchIsolate != null) {
       _textSearchIsolate?.kill(priority: Isolate.immediate);
     }
@@ -6681,6 +6871,9 @@ class SfPdfViewerState extends State<SfPdfViewer> with WidgetsBindingObserver {
   }
 
   /// Extracts and stores the width and height of each page from the PDF document.
+  ///
+  /// Annotations, form fields and text selection map into the same pages, so the layout takes its sizes from here
+  /// rather than from the page geometry index of the platform.
   void _getPageSizes() {
     _originalWidth = <double>[];
     _originalHeight = <double>[];
@@ -5,6 +5,17 @@ import 'package:syncfusion_pdfviewer_platform_interface/pdfviewer_platform_inter
 class MethodChannelPdfViewer extends PdfViewerPlatform {
   final MethodChannel _channel = MethodChannel('syncfusion_flutter_pdfviewer');
 
+  /// Binary channel the document chunks are streamed over.
+  static const String _uploadChannel = 'syncfusion_flutter_pdfviewer/upload';
+
+  /// Size of the upload ID and offset that precede each chunk.
+  static const int _documentChunkHeaderSize = 16;
+
+  /// Channel of the document events sent by the platform.
+  late final Stream<Map<Object?, Object?>> _documentEvents = const EventChannel(
+    'syncfusion_flutter_pdfviewer/events',
+  ).receiveBroadcastStream().cast<Map<Object?, Object?>>();
+
   /// Initializes the PDF renderer instance in respective platform by loading the PDF from the provided byte information.
   /// If success, returns page count else returns error message from respective platform
   @override
@@ -35,6 +46,90 @@ class MethodChannelPdfViewer extends PdfViewerPlatform {
     });
   }
 
+  /// Starts a chunked upload of a document and returns its upload ID.
+  @override
+  Future<int?> beginDocumentUpload(int length) async {
+    return _channel.invokeMethod<int>('beginDocumentUpload', <String, dynamic>{
+      'length': length,
+    });
+  }
+
+  /// Sends the chunk over the binary upload channel, prefixed with the upload ID and offset.
+  @override
+  Future<void> appendDocumentChunk(
+    int uploadID,
+    int offset,
+    Uint8List chunk,
+  ) async {
+    final ByteData message = ByteData(_documentChunkHeaderSize + chunk.length);
+    message.setInt64(0, uploadID, Endian.little);
+    message.setInt64(8, offset, Endian.little);
+    message.buffer
+        .asUint8List(message.offsetInBytes + _documentChunkHeaderSize)
+        .setAll(0, chunk);
+    await ServicesBinding.instance.defaultBinaryMessenger.send(
+      _uploadChannel,
+      message,
+    );
+  }
+
+  /// Gives up a chunked upload and releases its native buffer.
+  @override
+  Future<bool?> abortDocumentUpload(int uploadID) async {
+    return _channel.invokeMethod<bool>('abortDocumentUpload', <String, dynamic>{
+      'uploadID': uploadID,
+    });
+  }
+
+  /// Initializes the PDF renderer instance from the uploaded document.
+  @override
+  Future<String?> finalizeDocumentUpload(
+    int uploadID,
+    String documentID, [
+    String? password,
+  ]) async {
+    return _channel.invokeMethod<String>(
+      'finalizeDocumentUpload',
+      <String, dynamic>{
+        'uploadID': uploadID,
+        'documentID': documentID,
+        'password': password,
+      },
+    );
+  }
+
+  /// Starts opening a document while its bytes are still arriving and returns its upload ID.
+  @override
+  Future<int?> beginProgressiveDocument(
+    String documentID,
+    int length, [
+    String? password,
+    bool rangeRequests = false,
+  ]) async {
+    return _channel.invokeMethod<int>(
+      'beginProgressiveDocument',
+      <String, dynamic>{
+        'documentID': documentID,
+        'length': length,
+        'password': password,
+        'rangeRequests': rangeRequests,
+      },
+    );
+  }
+
+  /// Whether the data of the specified page has arrived.
+  @override
+  Future<bool?> isPageAvailable(String documentID, int pageNumber) async {
+    return _channel.invokeMethod<bool>('isPageAvailable', <String, dynamic>{
+      'documentID': documentID,
+      'pageNumber': pageNumber,
+    });
+  }
+
+  /// Events of the documents.
+  @override
+  Stream<Map<Object?, Object?>> get documentEvents => _documentEvents;
+
   /// Gets the height of all pages in the document.
   @override
   Future<List?> getPagesHeight(String documentID) async {
@@ -53,13 +148,17 @@ class MethodChannelPdfViewer extends PdfViewerPlatform {
     int pageNumber,
     int width,
     int height,
-    String documentID,
-  ) async {
+    String documentID, {
+    int? requestID,
+    PdfRenderQuality quality = PdfRenderQuality.full,
+  }) async {
     return _channel.invokeMethod<Uint8List>('getPage', <String, dynamic>{
       'index': pageNumber,
       'width': width,
       'height': height,
       'documentID': documentID,
+      'requestID': requestID,
+      'quality': quality.index,
     });
   }
 
@@ -72,8 +171,10 @@ class MethodChannelPdfViewer extends PdfViewerPlatform {
     double y,
     double width,
     double height,
-    String documentID,
-  ) async {
+    String documentID, {
+    int? requestID,
+    PdfRenderQuality quality = PdfRenderQuality.full,
+  }) async {
     return _channel.invokeMethod<Uint8List>('getTileImage', <String, dynamic>{
       'pageNumber': pageNumber,
       'scale': currentScale,
@@ -82,9 +183,282 @@ class MethodChannelPdfViewer extends PdfViewerPlatform {
       'width': width,
       'height': height,
       'documentID': documentID,
+      'requestID': requestID,
+      'quality': quality.index,
+    });
+  }
+
+  /// Gets the geometry of the pages in a single call.
+  @override
+  Future<Map<Object?, Object?>?> getPageGeometry(
+    String documentID, {
+    Int32List? ranges,
+    bool includePageBoxes = false,
+  }) async {
+    return _channel.invokeMethod<Map<Object?, Object?>>(
+      'getPageGeometry',
+      <String, dynamic>{
+        'documentID': documentID,
+        'ranges': ranges,
+        'includePageBoxes': includePageBoxes,
+      },
+    );
+  }
+
+  /// Gets the fixed size grid tiles covering the specified region of the page.
+  @override
+  Future<Map<Object?, Object?>?> getGridTiles(
+    int pageNumber,
+    double scale,
+    double x,
+    double y,
+    double width,
+    double height,
+    String documentID, {
+    double? knownScale,
+    Int32List? knownTiles,
+    int? requestID,
+  }) async {
+    return _channel
+        .invokeMethod<Map<Object?, Object?>>('getGridTiles', <String, dynamic>{
+      'pageNumber': pageNumber,
+      'scale': scale,
+      'x': x,
+      'y': y,
+      'width': width,
+      'height': height,
+      'documentID': documentID,
+      'knownScale': knownScale,
+      'knownTiles': knownTiles,
+      'requestID': requestID,
+    });
+  }
+
+  /// Renders many pages of the document in a single call.
+  @override
+  Future<Map<Object?, Object?>?> renderPages(
+    String documentID,
+    Int32List requests, {
+    int? requestID,
+  }) async {
+    return _channel
+        .invokeMethod<Map<Object?, Object?>>('renderPages', <String, dynamic>{
+      'documentID': documentID,
+      'requests': requests,
+      'requestID': requestID,
+    });
+  }
+
+  /// Lays out the thumbnails of all pages and starts generating them in the background.
+  @override
+  Future<Map<Object?, Object?>?> startThumbnails(
+    String documentID,
+    int thumbnailHeight,
+  ) async {
+    return _channel.invokeMethod<Map<Object?, Object?>>(
+      'startThumbnails',
+      <String, dynamic>{
+        'documentID': documentID,
+        'thumbnailHeight': thumbnailHeight,
+      },
+    );
+  }
+
+  /// Gets the pixels of the thumbnails of an atlas generated since the last call.
+  @override
+  Future<Map<Object?, Object?>?> getThumbnailAtlas(
+    String documentID,
+    int atlasIndex, {
+    bool all = false,
+  }) async {
+    return _channel.invokeMethod<Map<Object?, Object?>>(
+      'getThumbnailAtlas',
+      <String, dynamic>{
+        'documentID': documentID,
+        'atlasIndex': atlasIndex,
+        'all': all,
+      },
+    );
+  }
+
+  /// Sets the page range of the thumbnails on screen.
+  @override
+  Future<bool?> setVisibleThumbnails(
+    String documentID,
+    int firstPageNumber,
+    int lastPageNumber,
+  ) async {
+    return _channel.invokeMethod<bool>('setVisibleThumbnails', <String, dynamic>{
+      'documentID': documentID,
+      'firstPageNumber': firstPageNumber,
+      'lastPageNumber': lastPageNumber,
+    });
+  }
+
+  /// Searches the text through all pages of the document.
+  @override
+  Future<int?> searchText(
+    String documentID,
+    String query,
+    int searchID, {
+    bool matchCase = false,
+    bool wholeWord = false,
+  }) async {
+    return _channel.invokeMethod<int>('searchText', <String, dynamic>{
+      'documentID': documentID,
+      'query': query,
+      'searchID': searchID,
+      'matchCase': matchCase,
+      'wholeWord': wholeWord,
+    });
+  }
+
+  /// Stops a text search.
+  @override
+  Future<bool?> cancelTextSearch(int searchID) async {
+    return _channel.invokeMethod<bool>('cancelTextSearch', <String, dynamic>{
+      'searchID': searchID,
+    });
+  }
+
+  /// Gets the text of a page.
+  @override
+  Future<String?> getPageText(String documentID, int pageNumber) async {
+    return _channel.invokeMethod<String>('getPageText', <String, dynamic>{
+      'documentID': documentID,
+      'pageNumber': pageNumber,
+    });
+  }
+
+  /// Cancels the page or tile render started with the specified request ID.
+  @override
+  Future<void> cancelRender(int requestID) async {
+    return _channel.invokeMethod('cancelRender', <String, dynamic>{
+      'requestID': requestID,
+    });
+  }
+
+  /// Creates an external texture that displays a page and returns its texture ID.
+  @override
+  Future<int?> createPageTexture(String documentID) async {
+    return _channel.invokeMethod<int>('createPageTexture', <String, dynamic>{
+      'documentID': documentID,
+    });
+  }
+
+  /// Renders the specified page into the texture at the specified width and height.
+  @override
+  Future<bool?> renderPageTexture(
+    int textureID,
+    int pageNumber,
+    int width,
+    int height,
+    String documentID, {
+    int? requestID,
+    PdfRenderQuality quality = PdfRenderQuality.full,
+  }) async {
+    return _channel.invokeMethod<bool>('renderPageTexture', <String, dynamic>{
+      'textureID': textureID,
+      'pageNumber': pageNumber,
+      'width': width,
+      'height': height,
+      'documentID': documentID,
+      'requestID': requestID,
+      'quality': quality.index,
+    });
+  }
+
+  /// Releases the page texture.
+  @override
+  Future<void> disposePageTexture(int textureID) async {
+    return _channel.invokeMethod('disposePageTexture', <String, dynamic>{
+      'textureID': textureID,
     });
   }
 
+  /// Reports the range of pages shown in the viewport and the scrolling the platform prefetches ahead of.
+  @override
+  Future<void> viewportHint(
+    String documentID,
+    int firstPage,
+    int lastPage, {
+    Float64List? visibleRect,
+    double velocityX = 0,
+    double velocityY = 0,
+    double? scale,
+    bool horizontal = false,
+  }) async {
+    return _channel.invokeMethod('viewportHint', <String, dynamic>{
+      'documentID': documentID,
+      'firstPage': firstPage,
+      'lastPage': lastPage,
+      'visibleRect': visibleRect,
+      'velocityX': velocityX,
+      'velocityY': velocityY,
+      'scale': scale,
+      'horizontal': horizontal,
+    });
+  }
+
+  /// Starts the helper processes that render page and tile images in parallel, 0 stops them.
+  @override
+  Future<int?> setRenderProcessCount(int processCount) async {
+    return _channel.invokeMethod<int>('setRenderProcessCount', <String, dynamic>{
+      'processCount': processCount,
+    });
+  }
+
+  /// Runs the PDF renderer on the platform thread, in time slices, when [enabled] is true.
+  @override
+  Future<void> setCooperativeRendering(bool enabled) async {
+    return _channel.invokeMethod('setCooperativeRendering', <String, dynamic>{
+      'enabled': enabled,
+    });
+  }
+
+  /// Limits the memory held by the render caches, 0 restores the default.
+  @override
+  Future<int?> setMemoryBudget(int bytes) async {
+    return _channel.invokeMethod<int>('setMemoryBudget', <String, dynamic>{
+      'bytes': bytes,
+    });
+  }
+
+  /// Gets the memory held by the render caches of a document or of all documents.
+  @override
+  Future<Map<Object?, Object?>?> getMemoryUsage({String? documentID}) async {
+    return _channel.invokeMethod<Map<Object?, Object?>>(
+      'getMemoryUsage',
+      <String, dynamic>{'documentID': documentID},
+    );
+  }
+
+  /// Gets the render statistics of a document or of all documents, optionally clearing them.
+  @override
+  Future<Map<Object?, Object?>?> getRenderStats({
+    String? documentID,
+    bool reset = false,
+  }) async {
+    return _channel.invokeMethod<Map<Object?, Object?>>(
+      'getRenderStats',
+      <String, dynamic>{'documentID': documentID, 'reset': reset},
+    );
+  }
+
+  /// Keeps rendered tiles, thumbnails and text indexes on disk across sessions when [enabled] is true.
+  @override
+  Future<void> setDiskCacheEnabled(bool enabled) async {
+    return _channel.invokeMethod('setDiskCacheEnabled', <String, dynamic>{
+      'enabled': enabled,
+    });
+  }
+
+  /// Removes every file the disk cache holds.
+  @override
+  Future<void> clearDiskCache() async {
+    return _channel.invokeMethod('clearDiskCache');
+  }
+
   /// Closes the PDF document.
   @override
   Future<void> closeDocument(String documentID) async {
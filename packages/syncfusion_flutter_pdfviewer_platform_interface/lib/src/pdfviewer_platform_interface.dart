@@ -5,6 +5,16 @@ import 'dart:typed_data';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 import 'package:syncfusion_pdfviewer_platform_interface/src/method_channel_pdfviewer.dart';
 
+/// Quality of a page or tile render.
+enum PdfRenderQuality {
+  /// Anti-aliased text, images and paths.
+  full,
+
+  /// Without anti-aliasing, several times faster to render. Meant for pages passing by during a fast scroll, replaced
+  /// by a [full] render once the viewport settles.
+  draft,
+}
+
 /// The interface that implementations of syncfusion_flutter_pdfviewer must implement.
 ///
 /// Platform implementations should extend this class rather than implement it as `syncfusion_flutter_pdfviewer`
@@ -55,6 +65,72 @@ abstract class PdfViewerPlatform extends PlatformInterface {
     throw UnimplementedError('loadPdfFromFile() has not been implemented.');
   }
 
+  /// Starts a chunked upload of a document of the specified [length] in bytes and returns its upload ID.
+  ///
+  /// The chunks are sent with [appendDocumentChunk] and the renderer is initialized with [finalizeDocumentUpload].
+  Future<int?> beginDocumentUpload(int length) async {
+    throw UnimplementedError('beginDocumentUpload() has not been implemented.');
+  }
+
+  /// Copies the [chunk] into the document buffer of the upload at the specified byte [offset].
+  Future<void> appendDocumentChunk(
+    int uploadID,
+    int offset,
+    Uint8List chunk,
+  ) async {
+    throw UnimplementedError('appendDocumentChunk() has not been implemented.');
+  }
+
+  /// Gives up an upload started with [beginDocumentUpload] that will not be finalized, releasing its native buffer.
+  ///
+  /// Returns false when the upload is unknown, already finalized or aborted.
+  Future<bool?> abortDocumentUpload(int uploadID) async {
+    throw UnimplementedError('abortDocumentUpload() has not been implemented.');
+  }
+
+  /// Initializes the PDF renderer instance from the uploaded document.
+  ///
+  /// If success, returns page count else returns error message from respective platform
+  Future<String?> finalizeDocumentUpload(
+    int uploadID,
+    String documentID, [
+    String? password,
+  ]) async {
+    throw UnimplementedError(
+      'finalizeDocumentUpload() has not been implemented.',
+    );
+  }
+
+  /// Starts opening a document of the specified [length] in bytes while its bytes are still arriving and returns
+  /// the upload ID its byte ranges are sent with, using [appendDocumentChunk] in any order.
+  ///
+  /// [documentEvents] reports `linearizationDetected`, `documentAvailable` with the `pageCount`, `pagesAvailable`
+  /// with the `pageNumbers` that can be rendered, and `documentFailed`. When [rangeRequests] is true it also reports
+  /// `dataRequested` with the `ranges` PDFium needs next as offset and size pairs, for callers that can read the
+  /// document out of order.
+  Future<int?> beginProgressiveDocument(
+    String documentID,
+    int length, [
+    String? password,
+    bool rangeRequests = false,
+  ]) async {
+    throw UnimplementedError(
+      'beginProgressiveDocument() has not been implemented.',
+    );
+  }
+
+  /// Whether the data of the specified page of a progressively opened document has arrived.
+  Future<bool?> isPageAvailable(String documentID, int pageNumber) async {
+    throw UnimplementedError('isPageAvailable() has not been implemented.');
+  }
+
+  /// Events of the documents, each a map with the `event` name and the `documentID`.
+  ///
+  /// While a document opens, `openProgress` events report the `phase` with the `pagesDone` and `pageCount`.
+  Stream<Map<Object?, Object?>> get documentEvents {
+    throw UnimplementedError('documentEvents has not been implemented.');
+  }
+
   /// Gets the height of all pages in the document.
   Future<List?> getPagesHeight(String documentID) async {
     throw UnimplementedError('getPagesHeight() has not been implemented.');
@@ -75,16 +151,24 @@ abstract class PdfViewerPlatform extends PlatformInterface {
   }
 
   /// Gets the image bytes of the specified page from the document at the specified width and height.
+  ///
+  /// The optional [requestID] identifies the render so that it can be stopped with [cancelRender]. The RGBA pixels are
+  /// rendered at the [quality], which only Linux honors; other platforms render at full quality.
   Future<Uint8List?> getPage(
     int pageNumber,
     int width,
     int height,
-    String documentID,
-  ) async {
+    String documentID, {
+    int? requestID,
+    PdfRenderQuality quality = PdfRenderQuality.full,
+  }) async {
     throw UnimplementedError('getPage() has not been implemented.');
   }
 
   /// Gets the image's bytes information of the specified portion of the page.
+  ///
+  /// The optional [requestID] identifies the render so that it can be stopped with [cancelRender]. The RGBA pixels are
+  /// rendered at the [quality], which only Linux honors; other platforms render at full quality.
   Future<Uint8List?> getTileImage(
     int pageNumber,
     double scale,
@@ -92,9 +176,259 @@ abstract class PdfViewerPlatform extends PlatformInterface {
     double y,
     double width,
     double height,
+    String documentID, {
+    int? requestID,
+    PdfRenderQuality quality = PdfRenderQuality.full,
+  }) async {
+    throw UnimplementedError('getTileImage() has not been implemented.');
+  }
+
+  /// Gets the geometry of the pages in a single call.
+  ///
+  /// The result holds the `pageCount`, the `stride` and the packed `geometry`, which has the page number, width,
+  /// height, rotation and the left, top, right and bottom of the crop box for each page, followed by the `labels` of
+  /// the same pages. The optional [ranges] hold first and last page number pairs. The rotation and crop box are NaN
+  /// unless [includePageBoxes] is true, as reading them requires loading the pages.
+  ///
+  /// The width and height are those PDFium renders with: the crop box clipped to the media box, swapped for pages
+  /// rotated by 90 or 270 degrees. They can differ from the page sizes of syncfusion_flutter_pdf, which does not clip
+  /// the crop box, so the viewer lays out its pages with the latter.
+  Future<Map<Object?, Object?>?> getPageGeometry(
+    String documentID, {
+    Int32List? ranges,
+    bool includePageBoxes = false,
+  }) async {
+    throw UnimplementedError('getPageGeometry() has not been implemented.');
+  }
+
+  /// Gets the fixed size grid tiles covering the region of the page given by [x], [y], [width] and [height] in page points.
+  ///
+  /// The result holds the quantized `scale` the tiles were rendered at, the `tileSize` and the `tiles` list, where each
+  /// tile has its `column`, `row`, `width`, `height` and RGBA `pixels`. Tiles listed as column and row pairs in
+  /// [knownTiles] for the same [knownScale] are returned without pixels.
+  Future<Map<Object?, Object?>?> getGridTiles(
+    int pageNumber,
+    double scale,
+    double x,
+    double y,
+    double width,
+    double height,
+    String documentID, {
+    double? knownScale,
+    Int32List? knownTiles,
+    int? requestID,
+  }) async {
+    throw UnimplementedError('getGridTiles() has not been implemented.');
+  }
+
+  /// Renders many pages of the document in a single call, such as a strip of thumbnails.
+  ///
+  /// The [requests] hold page number, width and height triples. The result holds the RGBA `pixels` of all pages
+  /// packed together and the `offsets` of each page in them, followed by the end offset of the last page. A page that
+  /// could not be rendered has equal start and end offsets. The optional [requestID] identifies the render so that it
+  /// can be stopped with [cancelRender].
+  Future<Map<Object?, Object?>?> renderPages(
     String documentID,
+    Int32List requests, {
+    int? requestID,
+  }) async {
+    throw UnimplementedError('renderPages() has not been implemented.');
+  }
+
+  /// Lays out thumbnails of all pages of the document at the specified [thumbnailHeight] in pixels, packed into a few
+  /// atlas images, and starts generating them in the background.
+  ///
+  /// The result holds the `atlases` as width and height pairs and the `layout` of the pages in page order, with the
+  /// atlas index, x, y, width, height and source of each thumbnail, `stride` values per page. The source is 0 while
+  /// pending, 1 for a thumbnail embedded in the document, 2 for a rendered one, 3 when the page failed and 4 for one
+  /// read back from the disk cache.
+  /// [documentEvents] reports `thumbnailsReady` with the `atlasIndex`, the `pageNumbers` generated and whether the
+  /// atlas is `complete`.
+  Future<Map<Object?, Object?>?> startThumbnails(
+    String documentID,
+    int thumbnailHeight,
   ) async {
-    throw UnimplementedError('getTileImage() has not been implemented.');
+    throw UnimplementedError('startThumbnails() has not been implemented.');
+  }
+
+  /// Gets the thumbnails of an atlas generated since the last call, or every generated one when [all] is set, and
+  /// whether the atlas is `complete`.
+  ///
+  /// The result holds their `pageNumbers` and the tightly packed RGBA `pixels` of each thumbnail one after another,
+  /// starting at its `offsets` entry, to be drawn at its place in the layout returned by [startThumbnails]. At most a
+  /// few atlases are kept in native memory, an atlas scrolled out of view may be generated again later.
+  Future<Map<Object?, Object?>?> getThumbnailAtlas(
+    String documentID,
+    int atlasIndex, {
+    bool all = false,
+  }) async {
+    throw UnimplementedError('getThumbnailAtlas() has not been implemented.');
+  }
+
+  /// Sets the first and last page number of the thumbnails on screen.
+  ///
+  /// Under memory pressure the atlases holding none of them are freed first, after the cached tiles. Their thumbnails
+  /// are generated again and reported by `thumbnailsReady` once one of them is set visible.
+  Future<bool?> setVisibleThumbnails(
+    String documentID,
+    int firstPageNumber,
+    int lastPageNumber,
+  ) async {
+    throw UnimplementedError('setVisibleThumbnails() has not been implemented.');
+  }
+
+  /// Searches the [query] through all pages of the document and returns the number of matches.
+  ///
+  /// The search runs in the background and [documentEvents] reports `textFound` with the `searchID`, the
+  /// `pageNumber` and the matches of each page as they are found: `rectCounts` holds the number of rectangles of each
+  /// match and `rects` the rectangles of all matches as left, top, right and bottom values in points from the top left
+  /// corner of the crop box of the unrotated page. A newer search of the same document cancels this one, as does
+  /// [cancelTextSearch] with the [searchID].
+  Future<int?> searchText(
+    String documentID,
+    String query,
+    int searchID, {
+    bool matchCase = false,
+    bool wholeWord = false,
+  }) async {
+    throw UnimplementedError('searchText() has not been implemented.');
+  }
+
+  /// Stops the text search started with the specified search ID.
+  Future<bool?> cancelTextSearch(int searchID) async {
+    throw UnimplementedError('cancelTextSearch() has not been implemented.');
+  }
+
+  /// Gets the text of the specified page.
+  Future<String?> getPageText(String documentID, int pageNumber) async {
+    throw UnimplementedError('getPageText() has not been implemented.');
+  }
+
+  /// Cancels the page or tile render started with the specified [requestID].
+  ///
+  /// The cancelled [getPage] or [getTileImage] call completes with a `RenderCancelled` error.
+  Future<void> cancelRender(int requestID) async {
+    throw UnimplementedError('cancelRender() has not been implemented.');
+  }
+
+  /// Creates an external texture that displays a page and returns its texture ID.
+  Future<int?> createPageTexture(String documentID) async {
+    throw UnimplementedError('createPageTexture() has not been implemented.');
+  }
+
+  /// Renders the specified page into the texture created with [createPageTexture] at the specified width and height.
+  ///
+  /// The optional [requestID] identifies the render so that it can be stopped with [cancelRender]. The page is rendered
+  /// at the [quality].
+  Future<bool?> renderPageTexture(
+    int textureID,
+    int pageNumber,
+    int width,
+    int height,
+    String documentID, {
+    int? requestID,
+    PdfRenderQuality quality = PdfRenderQuality.full,
+  }) async {
+    throw UnimplementedError('renderPageTexture() has not been implemented.');
+  }
+
+  /// Releases the texture created with [createPageTexture].
+  Future<void> disposePageTexture(int textureID) async {
+    throw UnimplementedError('disposePageTexture() has not been implemented.');
+  }
+
+  /// Reports the range of pages shown in the viewport, so that the platform can release the resources of pages far from it.
+  ///
+  /// The optional [visibleRect] is the visible region as left, top, width and height in points from the top left
+  /// corner of [firstPage], [velocityX] and [velocityY] the scroll velocity in points per second and [scale] the device
+  /// pixels per point of the grid tiles, null while pages are displayed whole. [horizontal] tells whether the pages are
+  /// laid out left to right. With them the platform renders the pages or grid tiles ahead of the viewport in the
+  /// direction of travel at a low priority, so that they are cached by the time they are requested.
+  Future<void> viewportHint(
+    String documentID,
+    int firstPage,
+    int lastPage, {
+    Float64List? visibleRect,
+    double velocityX = 0,
+    double velocityY = 0,
+    double? scale,
+    bool horizontal = false,
+  }) async {
+    throw UnimplementedError('viewportHint() has not been implemented.');
+  }
+
+  /// Starts [processCount] helper processes that render page and tile images in parallel, and returns the number of
+  /// processes that started.
+  ///
+  /// The helpers are forked from the application process and render from copies of its documents. Their renders are
+  /// queued like any other, but tiles they render are not kept in the tile cache, and the memory they use is not
+  /// counted by [setMemoryBudget].
+  ///
+  /// A [processCount] of 0 stops the helper processes. Documents opened while their bytes are still arriving are
+  /// always rendered in the application process.
+  Future<int?> setRenderProcessCount(int processCount) async {
+    throw UnimplementedError('setRenderProcessCount() has not been implemented.');
+  }
+
+  /// Runs the PDF renderer on the platform thread instead of a background thread when [enabled] is true.
+  ///
+  /// For deployments that must keep the renderer on the platform thread. Renders then run in slices of a few
+  /// milliseconds, between which the platform handles input and frames, and each method call completes once its render
+  /// is done.
+  Future<void> setCooperativeRendering(bool enabled) async {
+    throw UnimplementedError('setCooperativeRendering() has not been implemented.');
+  }
+
+  /// Limits the memory held by the render caches of all documents to [bytes] and returns the limit in effect.
+  ///
+  /// A [bytes] of 0 restores the default, a quarter of the physical memory between 256 MB and 1 GB. The bytes of open
+  /// documents are not held against the limit, as they cannot be released. Over the limit, cached tiles are released
+  /// first, then the thumbnail atlases out of view (see [setVisibleThumbnails]), then the pages away from the
+  /// viewport. Low memory warnings of the system release the same caches, and on a critical warning every page with
+  /// the images decoded for it.
+  Future<int?> setMemoryBudget(int bytes) async {
+    throw UnimplementedError('setMemoryBudget() has not been implemented.');
+  }
+
+  /// Gets the memory held by the render caches in bytes, for the document when [documentID] is given and for all
+  /// documents otherwise.
+  ///
+  /// The map holds the `documentData`, `pageHandles`, `tiles` and `thumbnails` bytes, their `total` and the `limit`
+  /// set with [setMemoryBudget].
+  Future<Map<Object?, Object?>?> getMemoryUsage({String? documentID}) async {
+    throw UnimplementedError('getMemoryUsage() has not been implemented.');
+  }
+
+  /// Gets the render statistics of the document when [documentID] is given, and of all documents opened in the
+  /// session otherwise. When [reset] is true the returned statistics are cleared, so that periodic reads each cover
+  /// the time since the previous one.
+  ///
+  /// The `phases` map holds the `open`, `pageLoad`, `rasterize`, `abandonedRasterize`, `farmRender`, `convert` and
+  /// `transfer` phases, each with its `count`, `total` and `max` duration and its `p50`, `p90` and `p99` estimates, all
+  /// in microseconds. `abandonedRasterize` times the renders that were cancelled or preempted, and no phase includes
+  /// the time a job yields to the UI thread in cooperative rendering. The `buckets` of a phase form a histogram:
+  /// bucket 0 counts durations under a microsecond and bucket i those from 2^(i-1) up to 2^i microseconds, so the
+  /// buckets of many sessions can be added up. The `counters` map holds the `pageCacheHits`, `rendersCancelled`,
+  /// `rendersPreempted` and `rendersFailed` counts.
+  Future<Map<Object?, Object?>?> getRenderStats({
+    String? documentID,
+    bool reset = false,
+  }) async {
+    throw UnimplementedError('getRenderStats() has not been implemented.');
+  }
+
+  /// Keeps rendered tiles, thumbnails and the text indexes built for searches on disk across sessions when [enabled]
+  /// is true, off by default.
+  ///
+  /// Encrypted documents and documents opened with a password are never written to disk. Disabling the cache keeps
+  /// the files already written, [clearDiskCache] removes them.
+  Future<void> setDiskCacheEnabled(bool enabled) async {
+    throw UnimplementedError('setDiskCacheEnabled() has not been implemented.');
+  }
+
+  /// Removes every file the disk cache holds.
+  Future<void> clearDiskCache() async {
+    throw UnimplementedError('clearDiskCache() has not been implemented.');
   }
 
   /// Closes the PDF document.
@@ -0,0 +1,122 @@
+#include "bitmap_buffer_pool.h"
+
+namespace pdfviewer
+{
+  // Smallest size class, smaller bitmaps share it
+  static const gsize kMinimumBufferSize = 64 * 1024;
+  // Upper bound of the memory kept by idle buffers
+  static const gsize kMaximumRetainedBytes = 64 * 1024 * 1024;
+
+  // Rounds the size up to its size class. Between two powers of two the
+  // classes are a quarter of the smaller one apart.
+  static gsize GetSizeClass(gsize size)
+  {
+    if (size <= kMinimumBufferSize)
+      return kMinimumBufferSize;
+
+    gsize power = kMinimumBufferSize;
+    while (power * 2 < size)
+      power <<= 1;
+    gsize step = power / 4;
+    return (size + step - 1) / step * step;
+  }
+
+  BitmapBufferPool &BitmapBufferPool::Shared()
+  {
+    static BitmapBufferPool pool;
+    return pool;
+  }
+
+  BitmapBufferPool::~BitmapBufferPool()
+  {
+    for (auto &sizeClass : free_buffers_)
+    {
+      for (guint8 *buffer : sizeClass.second)
+        g_free(buffer);
+    }
+  }
+
+  guint8 *BitmapBufferPool::Acquire(gsize size, gsize *capacity)
+  {
+    *capacity = GetSizeClass(size);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = free_buffers_.find(*capacity);
+      if (it != free_buffers_.end() && !it->second.empty())
+      {
+        guint8 *buffer = it->second.back();
+        it->second.pop_back();
+        retained_bytes_ -= *capacity;
+        return buffer;
+      }
+    }
+    return static_cast<guint8 *>(g_try_malloc(*capacity));
+  }
+
+  void BitmapBufferPool::Release(guint8 *buffer, gsize capacity)
+  {
+    if (!buffer)
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (retained_bytes_ + capacity <= kMaximumRetainedBytes)
+      {
+        free_buffers_[capacity].push_back(buffer);
+        retained_bytes_ += capacity;
+        return;
+      }
+    }
+    g_free(buffer);
+  }
+
+  void BitmapBufferPool::Trim()
+  {
+    std::map<gsize, std::vector<guint8 *>> buffers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffers.swap(free_buffers_);
+      retained_bytes_ = 0;
+    }
+    for (auto &sizeClass : buffers)
+    {
+      for (guint8 *buffer : sizeClass.second)
+        g_free(buffer);
+    }
+  }
+
+  PooledBitmap::PooledBitmap(int width, int height)
+      : buffer_(nullptr), capacity_(0), bitmap_(nullptr)
+  {
+    if (width <= 0 || height <= 0)
+      return;
+
+    int stride = width * 4;
+    buffer_ = BitmapBufferPool::Shared().Acquire(static_cast<gsize>(stride) * height, &capacity_);
+    if (buffer_)
+    {
+      bitmap_ = FPDFBitmap_CreateEx(width, height, FPDFBitmap_BGRx, buffer_, stride);
+    }
+  }
+
+  PooledBitmap::~PooledBitmap()
+  {
+    if (bitmap_)
+      FPDFBitmap_Destroy(bitmap_);
+    BitmapBufferPool::Shared().Release(buffer_, capacity_);
+  }
+
+  guint8 *PooledBitmap::TakeBuffer(gsize *capacity)
+  {
+    if (bitmap_)
+    {
+      FPDFBitmap_Destroy(bitmap_);
+      bitmap_ = nullptr;
+    }
+    guint8 *buffer = buffer_;
+    *capacity = capacity_;
+    buffer_ = nullptr;
+    capacity_ = 0;
+    return buffer;
+  }
+} // namespace pdfviewer
@@ -0,0 +1,68 @@
+#ifndef PDFVIEWER_BITMAP_BUFFER_POOL_H_
+#define PDFVIEWER_BITMAP_BUFFER_POOL_H_
+
+#include <glib.h>
+#include <fpdfview.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace pdfviewer
+{
+  // Pool of pixel buffers grouped in size classes a quarter of a power of two
+  // apart, so a buffer wastes less than a quarter of its size.
+  //
+  // Page and tile bitmaps are large and short-lived; reusing their memory
+  // avoids mapping and faulting in fresh pages for every render.
+  class BitmapBufferPool
+  {
+  public:
+    // Returns the pool shared by all documents
+    static BitmapBufferPool &Shared();
+
+    ~BitmapBufferPool();
+
+    // Returns a buffer of at least |size| bytes and stores its real size in
+    // |capacity|, or returns null if the memory could not be allocated.
+    guint8 *Acquire(gsize size, gsize *capacity);
+    // Returns the buffer to the pool, or frees it when the pool is full.
+    void Release(guint8 *buffer, gsize capacity);
+    // Frees the idle buffers, on memory pressure
+    void Trim();
+
+  private:
+    BitmapBufferPool() : retained_bytes_(0) {}
+
+    std::mutex mutex_;
+    std::map<gsize, std::vector<guint8 *>> free_buffers_;
+    gsize retained_bytes_;
+  };
+
+  // BGRx bitmap whose pixels live in a buffer borrowed from the shared pool.
+  // PDFium only renders subpixel text and takes its fast paths into opaque
+  // bitmaps.
+  class PooledBitmap
+  {
+  public:
+    PooledBitmap(int width, int height);
+    ~PooledBitmap();
+
+    PooledBitmap(const PooledBitmap &) = delete;
+    PooledBitmap &operator=(const PooledBitmap &) = delete;
+
+    // Bitmap handle for PDFium, null if the allocation failed
+    FPDF_BITMAP bitmap() const { return bitmap_; }
+
+    // Destroys the bitmap handle and hands its pixel buffer over to the caller,
+    // who must return it with BitmapBufferPool::Release.
+    guint8 *TakeBuffer(gsize *capacity);
+
+  private:
+    guint8 *buffer_;
+    gsize capacity_;
+    FPDF_BITMAP bitmap_;
+  };
+} // namespace pdfviewer
+
+#endif
@@ -0,0 +1,342 @@
+#include "disk_cache.h"
+
+#include <gio/gio.h>
+#include <glib/gstdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include "pdfviewer.h"
+
+namespace pdfviewer
+{
+  // Upper bound of the disk space held by cached tiles
+  static const gsize kMaximumDiskCacheBytes = 512 * 1024 * 1024;
+  // Start of a cache file, followed by the pixel size as a little endian 64
+  // bit integer and the deflated pixels
+  static const char kTileMagic[4] = {'S', 'F', 'T', 'C'};
+  static const gsize kTileHeaderSize = sizeof(kTileMagic) + sizeof(guint64);
+  static const gchar *const kTileSuffix = ".tile";
+  // Writes queued beyond this are dropped, the tiles are stored again the
+  // next time they are rendered
+  static const size_t kMaximumQueuedWrites = 64;
+
+  static std::atomic<bool> diskCacheEnabled(false);
+
+  std::string GetCacheDirectory(const gchar *name)
+  {
+    gchar *path = g_build_filename(g_get_user_cache_dir(), "syncfusion_pdfviewer", name, nullptr);
+    std::string directory = path;
+    g_free(path);
+    return directory;
+  }
+
+  bool IsDiskCacheEnabled()
+  {
+    return diskCacheEnabled.load(std::memory_order_relaxed);
+  }
+
+  void SetDiskCacheEnabled(bool enabled)
+  {
+    diskCacheEnabled.store(enabled, std::memory_order_relaxed);
+  }
+
+  void ClearCacheDirectory(const gchar *name, const gchar *suffix)
+  {
+    std::string directory = GetCacheDirectory(name);
+    GDir *dir = g_dir_open(directory.c_str(), 0, nullptr);
+    if (!dir)
+      return;
+
+    while (const gchar *file = g_dir_read_name(dir))
+    {
+      if (!g_str_has_suffix(file, suffix))
+        continue;
+      gchar *path = g_build_filename(directory.c_str(), file, nullptr);
+      g_remove(path);
+      g_free(path);
+    }
+    g_dir_close(dir);
+  }
+
+  // Runs the converter over the whole input, growing the output as needed.
+  // Returns the number of bytes written, or -1 on failure.
+  static gssize Convert(GConverter *converter, const guint8 *input, gsize input_size, std::vector<guint8> *output)
+  {
+    gsize read = 0;
+    gsize written = 0;
+    while (true)
+    {
+      if (written == output->size())
+        output->resize(std::max<gsize>(output->size() * 2, 4096));
+
+      gsize bytesRead = 0;
+      gsize bytesWritten = 0;
+      GError *error = nullptr;
+      GConverterResult result = g_converter_convert(converter, input + read, input_size - read,
+                                                    output->data() + written, output->size() - written,
+                                                    G_CONVERTER_INPUT_AT_END, &bytesRead, &bytesWritten, &error);
+      read += bytesRead;
+      written += bytesWritten;
+      if (result == G_CONVERTER_FINISHED)
+        return static_cast<gssize>(written);
+      if (result == G_CONVERTER_ERROR)
+      {
+        // The output is full, it grows on the next round
+        bool noSpace = g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NO_SPACE);
+        g_error_free(error);
+        if (!noSpace)
+          return -1;
+        output->resize(output->size() * 2);
+      }
+    }
+  }
+
+  DiskTileCache &DiskTileCache::Shared()
+  {
+    static DiskTileCache cache;
+    return cache;
+  }
+
+  DiskTileCache::DiskTileCache()
+      : directory_(GetCacheDirectory("tiles")), loaded_(false), disk_usage_(0), stopping_(false), generation_(0)
+  {
+  }
+
+  DiskTileCache::~DiskTileCache()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    writes_condition_.notify_all();
+    if (writer_.joinable())
+      writer_.join();
+    for (Write &write : writes_)
+      g_bytes_unref(write.pixels);
+  }
+
+  void DiskTileCache::EnsureLoaded()
+  {
+    if (loaded_)
+      return;
+    loaded_ = true;
+
+    GDir *dir = g_dir_open(directory_.c_str(), 0, nullptr);
+    if (!dir)
+      return;
+
+    // Oldest modification first, each file is then put in front of the list
+    std::vector<std::pair<gint64, Entry>> files;
+    while (const gchar *name = g_dir_read_name(dir))
+    {
+      if (!g_str_has_suffix(name, kTileSuffix))
+        continue;
+      gchar *path = g_build_filename(directory_.c_str(), name, nullptr);
+      GStatBuf stat;
+      if (g_stat(path, &stat) == 0)
+        files.emplace_back(static_cast<gint64>(stat.st_mtime), Entry{name, static_cast<gsize>(stat.st_size)});
+      g_free(path);
+    }
+    g_dir_close(dir);
+
+    std::sort(files.begin(), files.end(), [](const std::pair<gint64, Entry> &a, const std::pair<gint64, Entry> &b)
+              { return a.first < b.first; });
+    for (auto &file : files)
+    {
+      files_.push_front(file.second);
+      entries_[file.second.name] = files_.begin();
+      disk_usage_ += file.second.size;
+    }
+    EvictToBudget();
+  }
+
+  GBytes *DiskTileCache::Lookup(const std::string &key, gsize size)
+  {
+    if (key.empty() || !IsDiskCacheEnabled())
+      return nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    EnsureLoaded();
+    auto it = entries_.find(key + kTileSuffix);
+    if (it == entries_.end())
+      return nullptr;
+
+    gchar *path = g_build_filename(directory_.c_str(), it->second->name.c_str(), nullptr);
+    gchar *contents = nullptr;
+    gsize length = 0;
+    GBytes *pixels = nullptr;
+    if (g_file_get_contents(path, &contents, &length, nullptr) && length >= kTileHeaderSize &&
+        memcmp(contents, kTileMagic, sizeof(kTileMagic)) == 0)
+    {
+      guint64 storedSize = 0;
+      memcpy(&storedSize, contents + sizeof(kTileMagic), sizeof(storedSize));
+      if (GUINT64_FROM_LE(storedSize) == size)
+      {
+        std::vector<guint8> output(size);
+        GZlibDecompressor *decompressor = g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_RAW);
+        gssize written = Convert(G_CONVERTER(decompressor), reinterpret_cast<const guint8 *>(contents) + kTileHeaderSize,
+                                 length - kTileHeaderSize, &output);
+        g_object_unref(decompressor);
+        if (written == static_cast<gssize>(size))
+          pixels = g_bytes_new(output.data(), size);
+      }
+    }
+    g_free(contents);
+
+    if (!pixels)
+    {
+      // Unreadable or stale, it is rendered and stored again
+      g_remove(path);
+      g_free(path);
+      Remove(it->second);
+      return nullptr;
+    }
+
+    // Refreshes the use order, on disk too
+    g_utime(path, nullptr);
+    g_free(path);
+    files_.splice(files_.begin(), files_, it->second);
+    return pixels;
+  }
+
+  void DiskTileCache::Store(const std::string &key, GBytes *pixels)
+  {
+    if (key.empty() || !IsDiskCacheEnabled())
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_ || writes_.size() >= kMaximumQueuedWrites)
+        return;
+      writes_.push_back(Write{key, g_bytes_ref(pixels)});
+      if (!writer_.joinable())
+        writer_ = std::thread(&DiskTileCache::RunWriter, this);
+    }
+    writes_condition_.notify_one();
+  }
+
+  void DiskTileCache::Clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++generation_;
+    for (Write &write : writes_)
+      g_bytes_unref(write.pixels);
+    writes_.clear();
+    files_.clear();
+    entries_.clear();
+    disk_usage_ = 0;
+    // Files written by an earlier session are not listed until loaded
+    loaded_ = true;
+    ClearCacheDirectory("tiles", kTileSuffix);
+  }
+
+  void DiskTileCache::RunWriter()
+  {
+    while (true)
+    {
+      Write write;
+      guint64 generation = 0;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        writes_condition_.wait(lock, [this]
+                               { return stopping_ || !writes_.empty(); });
+        if (stopping_)
+          return;
+        write = writes_.front();
+        writes_.pop_front();
+        generation = generation_;
+      }
+
+      // Rendered pages are mostly flat color, the fastest level compresses
+      // them well
+      gsize size = 0;
+      const guint8 *pixels = static_cast<const guint8 *>(g_bytes_get_data(write.pixels, &size));
+      std::vector<guint8> compressed(std::max<gsize>(size / 4, 1));
+      GZlibCompressor *compressor = g_zlib_compressor_new(G_ZLIB_COMPRESSOR_FORMAT_RAW, 1);
+      gssize written = Convert(G_CONVERTER(compressor), pixels, size, &compressed);
+      g_object_unref(compressor);
+      g_bytes_unref(write.pixels);
+      if (written < 0)
+        continue;
+
+      std::vector<guint8> buffer(kTileHeaderSize);
+      memcpy(buffer.data(), kTileMagic, sizeof(kTileMagic));
+      guint64 storedSize = GUINT64_TO_LE(static_cast<guint64>(size));
+      memcpy(buffer.data() + sizeof(kTileMagic), &storedSize, sizeof(storedSize));
+      buffer.insert(buffer.end(), compressed.begin(), compressed.begin() + written);
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (generation != generation_ || !IsDiskCacheEnabled())
+        continue;
+      EnsureLoaded();
+      std::string name = write.key + kTileSuffix;
+      gchar *path = g_build_filename(directory_.c_str(), name.c_str(), nullptr);
+      bool stored = g_mkdir_with_parents(directory_.c_str(), 0700) == 0 &&
+                    g_file_set_contents(path, reinterpret_cast<const gchar *>(buffer.data()),
+                                        static_cast<gssize>(buffer.size()), nullptr);
+      g_free(path);
+      if (!stored)
+        continue;
+
+      auto it = entries_.find(name);
+      if (it != entries_.end())
+      {
+        disk_usage_ -= it->second->size;
+        files_.erase(it->second);
+        entries_.erase(it);
+      }
+      files_.push_front(Entry{name, buffer.size()});
+      entries_[name] = files_.begin();
+      disk_usage_ += buffer.size();
+      EvictToBudget();
+    }
+  }
+
+  void DiskTileCache::EvictToBudget()
+  {
+    while (disk_usage_ > kMaximumDiskCacheBytes && !files_.empty())
+    {
+      auto last = std::prev(files_.end());
+      gchar *path = g_build_filename(directory_.c_str(), last->name.c_str(), nullptr);
+      g_remove(path);
+      g_free(path);
+      Remove(last);
+    }
+  }
+
+  void DiskTileCache::Remove(std::list<Entry>::iterator entry)
+  {
+    disk_usage_ -= entry->size;
+    entries_.erase(entry->name);
+    files_.erase(entry);
+  }
+
+  // Identity of the document in the disk cache keys, empty when it must not
+  // be cached
+  static std::string GetCacheIdentity(PdfDocument *document)
+  {
+    if (!IsDiskCacheEnabled() || document->isEncrypted())
+      return "";
+    return document->identity();
+  }
+
+  std::string GetTileCacheKey(PdfDocument *document, int page_index, int zoom_bucket, int column, int row)
+  {
+    std::string identity = GetCacheIdentity(document);
+    if (identity.empty())
+      return "";
+    return identity + "-p" + std::to_string(page_index) + "-z" + std::to_string(zoom_bucket) + "-c" +
+           std::to_string(column) + "-r" + std::to_string(row);
+  }
+
+  std::string GetThumbnailCacheKey(PdfDocument *document, int page_index, int height)
+  {
+    std::string identity = GetCacheIdentity(document);
+    if (identity.empty())
+      return "";
+    return identity + "-p" + std::to_string(page_index) + "-t" + std::to_string(height);
+  }
+} // namespace pdfviewer
@@ -0,0 +1,101 @@
+#ifndef PDFVIEWER_DISK_CACHE_H_
+#define PDFVIEWER_DISK_CACHE_H_
+
+#include <glib.h>
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace pdfviewer
+{
+  class PdfDocument;
+
+  // Returns the directory of the named cache in the user cache directory,
+  // which may not exist yet
+  std::string GetCacheDirectory(const gchar *name);
+
+  // Whether text indexes, rendered tiles and thumbnails are kept on disk
+  // across sessions, off unless Dart enables it
+  bool IsDiskCacheEnabled();
+  void SetDiskCacheEnabled(bool enabled);
+  // Removes the files of the named cache with the given suffix
+  void ClearCacheDirectory(const gchar *name, const gchar *suffix);
+
+  // Rendered tiles and thumbnails kept on disk across sessions.
+  //
+  // Each entry is a file holding the raw pixels compressed with deflate,
+  // named after its key. The cache is byte-budgeted: once the files exceed
+  // the budget the least recently used ones are removed. The use order
+  // survives restarts through the modification times of the files, which a
+  // hit refreshes. Files are compressed and written by a thread of their own,
+  // so that storing a tile never delays the render that produced it.
+  class DiskTileCache
+  {
+  public:
+    static DiskTileCache &Shared();
+
+    ~DiskTileCache();
+
+    DiskTileCache(const DiskTileCache &) = delete;
+    DiskTileCache &operator=(const DiskTileCache &) = delete;
+
+    // Returns the pixels stored under the key, or null on a miss, when the
+    // stored pixels are not of the expected size or the cache is disabled
+    GBytes *Lookup(const std::string &key, gsize size);
+    // Queues the pixels to be compressed and stored under the key, taking a
+    // reference to them. Dropped when too many writes are queued already.
+    void Store(const std::string &key, GBytes *pixels);
+    // Removes every stored file and drops the queued writes
+    void Clear();
+
+  private:
+    DiskTileCache();
+
+    struct Entry
+    {
+      std::string name;
+      gsize size;
+    };
+
+    struct Write
+    {
+      std::string key;
+      GBytes *pixels;
+    };
+
+    // Reads the entries already on disk the first time the cache is used
+    void EnsureLoaded();
+    void EvictToBudget();
+    void Remove(std::list<Entry>::iterator entry);
+    void RunWriter();
+
+    std::mutex mutex_;
+    std::string directory_;
+    bool loaded_;
+    // Most recently used file first
+    std::list<Entry> files_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+    gsize disk_usage_;
+
+    // Writes waiting for the writer thread, started with the first one
+    std::deque<Write> writes_;
+    std::condition_variable writes_condition_;
+    std::thread writer_;
+    bool stopping_;
+    // Incremented by Clear, a write compressed before it is discarded
+    guint64 generation_;
+  };
+
+  // Key of a grid tile of a page at a zoom bucket. Empty, so that nothing is
+  // cached, when the document has no identity yet or is encrypted.
+  std::string GetTileCacheKey(PdfDocument *document, int page_index, int zoom_bucket, int column, int row);
+  // Key of the thumbnail of a page at a height in pixels, like the tile keys
+  std::string GetThumbnailCacheKey(PdfDocument *document, int page_index, int height);
+} // namespace pdfviewer
+
+#endif
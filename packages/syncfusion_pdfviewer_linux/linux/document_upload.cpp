@@ -0,0 +1,130 @@
+#include "document_upload.h"
+
+#include <cstring>
+#include <iterator>
+#include <unordered_map>
+
+namespace pdfviewer
+{
+  const gchar *const kDocumentUploadChannel = "syncfusion_flutter_pdfviewer/upload";
+
+  DocumentUpload *DocumentUpload::Create(gsize length)
+  {
+    if (length == 0)
+      return nullptr;
+
+    guint8 *buffer = static_cast<guint8 *>(g_try_malloc(length));
+    if (!buffer)
+      return nullptr;
+    return new DocumentUpload(buffer, length);
+  }
+
+  DocumentUpload::DocumentUpload(guint8 *buffer, gsize length)
+      : buffer_(buffer), length_(length), failed_(false) {}
+
+  DocumentUpload::~DocumentUpload()
+  {
+    g_free(buffer_);
+  }
+
+  bool DocumentUpload::Append(gsize offset, const guint8 *chunk, gsize size)
+  {
+    if (!buffer_ || offset > length_ || size > length_ - offset)
+    {
+      failed_ = true;
+      return false;
+    }
+    if (size == 0)
+      return true;
+
+    memcpy(buffer_ + offset, chunk, size);
+
+    // Merge the range with the received ranges it overlaps or touches
+    gsize start = offset;
+    gsize end = offset + size;
+    auto it = received_.upper_bound(start);
+    if (it != received_.begin() && std::prev(it)->second >= start)
+    {
+      --it;
+      start = it->first;
+    }
+    while (it != received_.end() && it->first <= end)
+    {
+      if (it->second > end)
+        end = it->second;
+      it = received_.erase(it);
+    }
+    received_[start] = end;
+    return true;
+  }
+
+  bool DocumentUpload::IsRangeReceived(gsize offset, gsize size) const
+  {
+    if (offset > length_ || size > length_ - offset)
+      return false;
+
+    auto it = received_.upper_bound(offset);
+    if (it == received_.begin())
+      return size == 0;
+    --it;
+    return it->second >= offset + size;
+  }
+
+  GBytes *DocumentUpload::TakeBuffer()
+  {
+    GBytes *bytes = g_bytes_new_take(buffer_, length_);
+    buffer_ = nullptr;
+    return bytes;
+  }
+
+  // Uploads in progress by ID. Only accessed from the render worker thread,
+  // which also orders the chunks of an upload before its finalization.
+  static std::unordered_map<gint64, DocumentUpload *> uploads;
+  static gint64 nextUploadID = 1;
+
+  gint64 BeginDocumentUpload(gsize length)
+  {
+    DocumentUpload *upload = DocumentUpload::Create(length);
+    if (!upload)
+      return 0;
+
+    gint64 upload_id = nextUploadID++;
+    uploads[upload_id] = upload;
+    return upload_id;
+  }
+
+  gboolean AppendDocumentChunk(gint64 upload_id, gsize offset, const guint8 *chunk, gsize size)
+  {
+    DocumentUpload *upload = GetDocumentUpload(upload_id);
+    return upload && upload->Append(offset, chunk, size);
+  }
+
+  DocumentUpload *GetDocumentUpload(gint64 upload_id)
+  {
+    auto it = uploads.find(upload_id);
+    return it != uploads.end() ? it->second : nullptr;
+  }
+
+  GBytes *FinishDocumentUpload(gint64 upload_id)
+  {
+    auto it = uploads.find(upload_id);
+    if (it == uploads.end())
+      return nullptr;
+
+    DocumentUpload *upload = it->second;
+    uploads.erase(it);
+    GBytes *bytes = upload->IsComplete() ? upload->TakeBuffer() : nullptr;
+    delete upload;
+    return bytes;
+  }
+
+  void CancelDocumentUpload(gint64 upload_id)
+  {
+    auto it = uploads.find(upload_id);
+    if (it == uploads.end())
+      return;
+
+    delete it->second;
+    uploads.erase(it);
+  }
+} // namespace pdfviewer
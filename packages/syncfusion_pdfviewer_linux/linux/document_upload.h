@@ -0,0 +1,69 @@
+#ifndef PDFVIEWER_DOCUMENT_UPLOAD_H_
+#define PDFVIEWER_DOCUMENT_UPLOAD_H_
+
+#include <glib.h>
+
+#include <map>
+
+namespace pdfviewer
+{
+  // Name of the binary channel the document chunks are streamed over. Each
+  // message holds the upload ID and the byte offset of the chunk as little
+  // endian 64 bit integers, followed by the chunk bytes.
+  extern const gchar *const kDocumentUploadChannel;
+  // Size of the upload ID and offset header of a chunk message
+  const gsize kDocumentChunkHeaderSize = 16;
+
+  // Document bytes streamed from Dart into one preallocated buffer. Chunks may
+  // arrive in any order, the received byte ranges are tracked so that a
+  // partially received document can already be read.
+  class DocumentUpload
+  {
+  public:
+    // Returns null when the buffer cannot be allocated
+    static DocumentUpload *Create(gsize length);
+
+    ~DocumentUpload();
+
+    DocumentUpload(const DocumentUpload &) = delete;
+    DocumentUpload &operator=(const DocumentUpload &) = delete;
+
+    // Copies the chunk at the byte offset. Returns false when it does not fit,
+    // the upload is then failed and can no longer complete.
+    bool Append(gsize offset, const guint8 *chunk, gsize size);
+    // Whether every byte of the range was received
+    bool IsRangeReceived(gsize offset, gsize size) const;
+    bool IsComplete() const { return !failed_ && IsRangeReceived(0, length_); }
+
+    const guint8 *data() const { return buffer_; }
+    gsize length() const { return length_; }
+
+    // Gives up the buffer without copying it. The caller owns the reference.
+    GBytes *TakeBuffer();
+
+  private:
+    DocumentUpload(guint8 *buffer, gsize length);
+
+    guint8 *buffer_;
+    gsize length_;
+    bool failed_;
+    // Received byte ranges, merged, from start to end offset
+    std::map<gsize, gsize> received_;
+  };
+
+  // Starts an upload of a document of the given length. Returns the upload ID,
+  // or 0 when the buffer cannot be allocated.
+  gint64 BeginDocumentUpload(gsize length);
+  // Copies a chunk into the buffer of the upload at the byte offset. Returns
+  // false when the upload is unknown or the chunk does not fit.
+  gboolean AppendDocumentChunk(gint64 upload_id, gsize offset, const guint8 *chunk, gsize size);
+  // Returns the upload, which stays owned by the registry, or null
+  DocumentUpload *GetDocumentUpload(gint64 upload_id);
+  // Ends the upload and returns its buffer, without copying it, once every
+  // byte was received. Returns null otherwise. The caller owns the reference.
+  GBytes *FinishDocumentUpload(gint64 upload_id);
+  // Ends the upload and releases its buffer
+  void CancelDocumentUpload(gint64 upload_id);
+} // namespace pdfviewer
+
+#endif
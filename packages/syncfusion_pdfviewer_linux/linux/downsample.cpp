@@ -0,0 +1,114 @@
+#include "downsample.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define PDFVIEWER_DOWNSAMPLE_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PDFVIEWER_DOWNSAMPLE_NEON 1
+#endif
+
+namespace pdfviewer
+{
+  // Averages the 2x2 blocks of target pixels [start, width) of a row. The
+  // rounding matches the vector paths, which average the two source rows
+  // first and then the two pixels of each pair.
+  static void DownsampleRowScalar(const guint8 *top, const guint8 *bottom, guint8 *target, int start, int width)
+  {
+    for (int x = start; x < width; ++x)
+    {
+      for (int channel = 0; channel < 4; ++channel)
+      {
+        int left = (top[x * 8 + channel] + bottom[x * 8 + channel] + 1) >> 1;
+        int right = (top[x * 8 + 4 + channel] + bottom[x * 8 + 4 + channel] + 1) >> 1;
+        target[x * 4 + channel] = static_cast<guint8>((left + right + 1) >> 1);
+      }
+    }
+  }
+
+#if defined(PDFVIEWER_DOWNSAMPLE_X86)
+  // 4 target pixels per step
+  static int DownsampleRowSse2(const guint8 *top, const guint8 *bottom, guint8 *target, int width)
+  {
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+      __m128i first = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(top + x * 8)),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i *>(bottom + x * 8)));
+      __m128i second = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(top + x * 8 + 16)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(bottom + x * 8 + 16)));
+      // Split the pixels into the left and right one of each pair
+      __m128 firstFloats = _mm_castsi128_ps(first);
+      __m128 secondFloats = _mm_castsi128_ps(second);
+      __m128i left = _mm_castps_si128(_mm_shuffle_ps(firstFloats, secondFloats, _MM_SHUFFLE(2, 0, 2, 0)));
+      __m128i right = _mm_castps_si128(_mm_shuffle_ps(firstFloats, secondFloats, _MM_SHUFFLE(3, 1, 3, 1)));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(target + x * 4), _mm_avg_epu8(left, right));
+    }
+    return x;
+  }
+
+  // 8 target pixels per step
+  __attribute__((target("avx2"))) static int DownsampleRowAvx2(const guint8 *top, const guint8 *bottom,
+                                                               guint8 *target, int width)
+  {
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+      __m256i first = _mm256_avg_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(top + x * 8)),
+                                      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bottom + x * 8)));
+      __m256i second = _mm256_avg_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(top + x * 8 + 32)),
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bottom + x * 8 + 32)));
+      // The shuffle works within 128 bit lanes, the permute restores the
+      // pixel order across them
+      __m256 firstFloats = _mm256_castsi256_ps(first);
+      __m256 secondFloats = _mm256_castsi256_ps(second);
+      __m256i left = _mm256_castps_si256(_mm256_shuffle_ps(firstFloats, secondFloats, _MM_SHUFFLE(2, 0, 2, 0)));
+      __m256i right = _mm256_castps_si256(_mm256_shuffle_ps(firstFloats, secondFloats, _MM_SHUFFLE(3, 1, 3, 1)));
+      __m256i average = _mm256_permute4x64_epi64(_mm256_avg_epu8(left, right), _MM_SHUFFLE(3, 1, 2, 0));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(target + x * 4), average);
+    }
+    return x;
+  }
+
+  static bool HasAvx2()
+  {
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    return hasAvx2;
+  }
+#elif defined(PDFVIEWER_DOWNSAMPLE_NEON)
+  // 4 target pixels per step
+  static int DownsampleRowNeon(const guint8 *top, const guint8 *bottom, guint8 *target, int width)
+  {
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+      // Loads 8 pixels split into the left and right one of each pair
+      uint32x4x2_t topPairs = vld2q_u32(reinterpret_cast<const uint32_t *>(top + x * 8));
+      uint32x4x2_t bottomPairs = vld2q_u32(reinterpret_cast<const uint32_t *>(bottom + x * 8));
+      uint8x16_t left = vrhaddq_u8(vreinterpretq_u8_u32(topPairs.val[0]), vreinterpretq_u8_u32(bottomPairs.val[0]));
+      uint8x16_t right = vrhaddq_u8(vreinterpretq_u8_u32(topPairs.val[1]), vreinterpretq_u8_u32(bottomPairs.val[1]));
+      vst1q_u8(target + x * 4, vrhaddq_u8(left, right));
+    }
+    return x;
+  }
+#endif
+
+  void Downsample2x(const guint8 *source, int source_stride, guint8 *target, int target_stride, int width,
+                    int height)
+  {
+    for (int y = 0; y < height; ++y)
+    {
+      const guint8 *top = source + static_cast<gsize>(y) * 2 * source_stride;
+      const guint8 *bottom = top + source_stride;
+      guint8 *row = target + static_cast<gsize>(y) * target_stride;
+      int done = 0;
+#if defined(PDFVIEWER_DOWNSAMPLE_X86)
+      done = HasAvx2() ? DownsampleRowAvx2(top, bottom, row, width) : 0;
+      done += DownsampleRowSse2(top + done * 8, bottom + done * 8, row + done * 4, width - done);
+#elif defined(PDFVIEWER_DOWNSAMPLE_NEON)
+      done = DownsampleRowNeon(top, bottom, row, width);
+#endif
+      DownsampleRowScalar(top, bottom, row, done, width);
+    }
+  }
+} // namespace pdfviewer
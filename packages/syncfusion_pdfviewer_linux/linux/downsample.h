@@ -0,0 +1,15 @@
+#ifndef PDFVIEWER_DOWNSAMPLE_H_
+#define PDFVIEWER_DOWNSAMPLE_H_
+
+#include <glib.h>
+
+namespace pdfviewer
+{
+  // Halves RGBA pixels in both directions with a 2x2 box filter. The source
+  // holds twice the target width and height. Uses AVX2 when the CPU has it,
+  // SSE2 on other x86-64 CPUs and NEON on ARM64, with a scalar fallback.
+  void Downsample2x(const guint8 *source, int source_stride, guint8 *target, int target_stride, int width,
+                    int height);
+} // namespace pdfviewer
+
+#endif
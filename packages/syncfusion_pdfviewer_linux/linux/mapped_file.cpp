@@ -0,0 +1,66 @@
+#include "mapped_file.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace pdfviewer
+{
+  // The cross-reference table and trailer PDFium reads first sit at the end of
+  // the file, this much of the tail is read ahead when the file opens
+  static const gsize kTrailerReadAhead = 64 * 1024;
+
+  MappedFile *MappedFile::Open(const gchar *file_path)
+  {
+    if (!file_path)
+      return nullptr;
+
+    GMappedFile *file = g_mapped_file_new(file_path, FALSE, nullptr);
+    if (!file)
+      return nullptr;
+
+    if (g_mapped_file_get_length(file) == 0 || !g_mapped_file_get_contents(file))
+    {
+      g_mapped_file_unref(file);
+      return nullptr;
+    }
+    return new MappedFile(file);
+  }
+
+  MappedFile::MappedFile(GMappedFile *file) : file_(file)
+  {
+    gchar *contents = g_mapped_file_get_contents(file_);
+    gsize length = g_mapped_file_get_length(file_);
+
+    // PDFium jumps between objects through the cross-reference table, so
+    // sequential read-ahead would mostly fetch pages it never touches
+    madvise(contents, length, MADV_RANDOM);
+    if (length > kTrailerReadAhead)
+    {
+      gsize page_size = static_cast<gsize>(sysconf(_SC_PAGESIZE));
+      gsize tail = (length - kTrailerReadAhead) & ~(page_size - 1);
+      madvise(contents + tail, length - tail, MADV_WILLNEED);
+    }
+
+    file_access_.m_FileLen = static_cast<unsigned long>(length);
+    file_access_.m_GetBlock = GetBlock;
+    file_access_.m_Param = this;
+  }
+
+  MappedFile::~MappedFile()
+  {
+    g_mapped_file_unref(file_);
+  }
+
+  int MappedFile::GetBlock(void *param, unsigned long position, unsigned char *buffer, unsigned long size)
+  {
+    MappedFile *self = static_cast<MappedFile *>(param);
+    gsize length = g_mapped_file_get_length(self->file_);
+    if (position > length || size > length - position)
+      return 0;
+
+    memcpy(buffer, g_mapped_file_get_contents(self->file_) + position, size);
+    return 1;
+  }
+} // namespace pdfviewer
@@ -0,0 +1,40 @@
+#ifndef PDFVIEWER_MAPPED_FILE_H_
+#define PDFVIEWER_MAPPED_FILE_H_
+
+#include <glib.h>
+#include <fpdfview.h>
+
+namespace pdfviewer
+{
+  // Read-only memory mapping of a PDF file, served to PDFium through the
+  // m_GetBlock callback of FPDF_FILEACCESS.
+  //
+  // PDFium reads straight out of the kernel page cache, so large files do not
+  // need a private heap copy and only the parts PDFium touches are paged in.
+  class MappedFile
+  {
+  public:
+    // Maps the file, returns null when it cannot be opened or is empty
+    static MappedFile *Open(const gchar *file_path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // File access to pass to FPDF_LoadCustomDocument, valid while the mapping
+    // is alive
+    FPDF_FILEACCESS *fileAccess() { return &file_access_; }
+    gsize size() const { return file_access_.m_FileLen; }
+
+  private:
+    explicit MappedFile(GMappedFile *file);
+
+    static int GetBlock(void *param, unsigned long position, unsigned char *buffer, unsigned long size);
+
+    GMappedFile *file_;
+    FPDF_FILEACCESS file_access_;
+  };
+} // namespace pdfviewer
+
+#endif
@@ -0,0 +1,120 @@
+#include "memory_budget.h"
+
+#include <fpdfview.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+namespace pdfviewer
+{
+  // Bounds of the default limit, a quarter of the physical memory
+  static const gsize kMinimumDefaultLimit = 256 * 1024 * 1024;
+  static const gsize kMaximumDefaultLimit = 1024 * 1024 * 1024;
+  // How long renders limit the image cache after a critical reclaim
+  static const gint64 kImageCacheLimitDuration = 60 * G_USEC_PER_SEC;
+  // Share of the limit the evictable usage must grow by before a reclaim that
+  // ended over the limit is tried again
+  static const gsize kReclaimGrowthDivisor = 8;
+
+  static gsize GetDefaultLimit()
+  {
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGE_SIZE);
+    if (pages <= 0 || pageSize <= 0)
+      return kMinimumDefaultLimit;
+    gsize physical = static_cast<gsize>(pages) * static_cast<gsize>(pageSize);
+    return std::min(std::max(physical / 4, kMinimumDefaultLimit), kMaximumDefaultLimit);
+  }
+
+  gsize MemoryUsage::Total() const
+  {
+    gsize total = 0;
+    for (gsize value : bytes)
+      total += value;
+    return total;
+  }
+
+  MemoryBudget &MemoryBudget::Shared()
+  {
+    static MemoryBudget budget;
+    return budget;
+  }
+
+  MemoryBudget::MemoryBudget() : total_{}, limit_(GetDefaultLimit()), reclaim_floor_(0), image_cache_limited_until_(0)
+  {
+  }
+
+  // Adds a signed amount to a counter, releases never take it below zero
+  static void AddBytes(gsize *value, gssize bytes)
+  {
+    if (bytes >= 0)
+      *value += static_cast<gsize>(bytes);
+    else
+      *value -= std::min(*value, static_cast<gsize>(-bytes));
+  }
+
+  void MemoryBudget::Charge(const std::string &document_id, MemoryCategory category, gssize bytes)
+  {
+    if (bytes == 0)
+      return;
+
+    int index = static_cast<int>(category);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = documents_.emplace(document_id, MemoryUsage{}).first;
+    AddBytes(&it->second.bytes[index], bytes);
+    AddBytes(&total_.bytes[index], bytes);
+    // Closed documents have released everything, their entry goes with it
+    if (it->second.Total() == 0)
+      documents_.erase(it);
+  }
+
+  MemoryUsage MemoryBudget::GetUsage(const std::string &document_id)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = documents_.find(document_id);
+    return it != documents_.end() ? it->second : MemoryUsage{};
+  }
+
+  MemoryUsage MemoryBudget::GetTotalUsage()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_;
+  }
+
+  void MemoryBudget::SetLimit(gsize bytes)
+  {
+    limit_.store(bytes > 0 ? bytes : GetDefaultLimit(), std::memory_order_relaxed);
+  }
+
+  bool MemoryBudget::IsOverLimit()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_.Evictable() > limit();
+  }
+
+  bool MemoryBudget::NeedsReclaim()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    gsize evictable = total_.Evictable();
+    return evictable > limit() && evictable > reclaim_floor_ + limit() / kReclaimGrowthDivisor;
+  }
+
+  void MemoryBudget::EndReclaim()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    gsize evictable = total_.Evictable();
+    reclaim_floor_ = evictable > limit() ? evictable : 0;
+  }
+
+  void MemoryBudget::LimitImageCache()
+  {
+    image_cache_limited_until_.store(g_get_monotonic_time() + kImageCacheLimitDuration, std::memory_order_relaxed);
+  }
+
+  int MemoryBudget::AdjustRenderFlags(int flags) const
+  {
+    if (g_get_monotonic_time() < image_cache_limited_until_.load(std::memory_order_relaxed))
+      return flags | FPDF_RENDER_LIMITEDIMAGECACHE;
+    return flags;
+  }
+} // namespace pdfviewer
@@ -0,0 +1,119 @@
+#ifndef PDFVIEWER_MEMORY_BUDGET_H_
+#define PDFVIEWER_MEMORY_BUDGET_H_
+
+#include <glib.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace pdfviewer
+{
+  // Kinds of memory the caches hold for a document
+  enum class MemoryCategory
+  {
+    // Document bytes held in memory. Mapped files are backed by the file and
+    // are not counted.
+    kDocumentData,
+    // Estimated memory of the open page handles, decoded images included
+    kPageHandles,
+    // Grid tiles of the shared tile cache and prerendered page images
+    kTiles,
+    // Thumbnail atlas bitmaps
+    kThumbnails,
+    kCount,
+  };
+
+  // Bytes held per category by a document, or by all documents
+  struct MemoryUsage
+  {
+    gsize bytes[static_cast<int>(MemoryCategory::kCount)];
+
+    gsize Get(MemoryCategory category) const { return bytes[static_cast<int>(category)]; }
+    gsize Total() const;
+    // Bytes the caches can give up, everything but the document data
+    gsize Evictable() const { return Total() - Get(MemoryCategory::kDocumentData); }
+  };
+
+  // Eviction tiers, in the order memory is given up. Each tier also applies
+  // the ones before it.
+  enum class MemoryTier
+  {
+    // Cached grid tiles and idle bitmap buffers, the cheapest to recreate
+    kTiles,
+    // Thumbnail atlases holding no thumbnail of the visible range
+    kThumbnails,
+    // Page handles outside the visible pages
+    kPageHandles,
+    // Every page handle, with renders limiting PDFium's decoded image cache
+    // through FPDF_RENDER_LIMITEDIMAGECACHE for a while afterwards
+    kImageCaches,
+  };
+
+  // Global budget of the memory held by the caches of all documents.
+  //
+  // The caches charge what they hold to the document it belongs to, so the
+  // usage is known per document and in total. Only the evictable usage is
+  // held against the limit, the document data stays while the document is
+  // open. The tile cache gives up its least recently used tiles as soon as
+  // the evictable usage exceeds the limit, and the render worker reclaims
+  // further tiers with ReclaimMemory when tiles are not enough or the system
+  // warns about low memory.
+  class MemoryBudget
+  {
+  public:
+    // Returns the budget shared by all documents
+    static MemoryBudget &Shared();
+
+    MemoryBudget(const MemoryBudget &) = delete;
+    MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+    // Adds the bytes, negative when released, to the usage of the document
+    void Charge(const std::string &document_id, MemoryCategory category, gssize bytes);
+
+    // Usage of the document, zero for unknown documents
+    MemoryUsage GetUsage(const std::string &document_id);
+    // Usage of all documents
+    MemoryUsage GetTotalUsage();
+
+    // Limit of the total usage in bytes, a share of the physical memory
+    // unless set
+    gsize limit() const { return limit_.load(std::memory_order_relaxed); }
+    // Sets the limit in bytes, 0 restores the default
+    void SetLimit(gsize bytes);
+    // Whether the evictable usage exceeds the limit
+    bool IsOverLimit();
+    // Whether the evictable usage exceeds the limit and grew noticeably since
+    // a reclaim last ended over it, when it had nothing left to give up
+    bool NeedsReclaim();
+    // Records the evictable usage a reclaim ended with
+    void EndReclaim();
+
+    // Makes renders limit PDFium's decoded image cache for a while
+    void LimitImageCache();
+    // Returns the FPDF_RenderPage flags with FPDF_RENDER_LIMITEDIMAGECACHE
+    // added while the image cache is limited
+    int AdjustRenderFlags(int flags) const;
+
+  private:
+    MemoryBudget();
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, MemoryUsage> documents_;
+    MemoryUsage total_;
+    std::atomic<gsize> limit_;
+    // Evictable usage a reclaim last ended with over the limit, 0 when it got
+    // under the limit
+    gsize reclaim_floor_;
+    // Monotonic time until which renders limit the image cache
+    std::atomic<gint64> image_cache_limited_until_;
+  };
+
+  // Frees cached memory tier by tier, up to and including |tier|, until the
+  // evictable usage falls to |target| bytes. Must run on the render worker,
+  // as it closes page handles.
+  void ReclaimMemory(MemoryTier tier, gsize target);
+} // namespace pdfviewer
+
+#endif
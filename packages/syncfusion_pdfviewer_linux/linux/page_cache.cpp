@@ -0,0 +1,177 @@
+#include "page_cache.h"
+
+#include <fpdf_edit.h>
+
+#include <iterator>
+
+#include "memory_budget.h"
+#include "render_stats.h"
+#include "render_worker.h"
+
+namespace pdfviewer
+{
+  // Maximum number of open pages per document
+  static const size_t kMaximumCachedPages = 32;
+  // Maximum estimated memory held by the open pages of a document
+  static const gsize kMaximumCachedBytes = 256 * 1024 * 1024;
+  // Pages this close to the visible range survive viewport changes
+  static const int kVisibleRangeMargin = 2;
+
+  // Estimates the memory a loaded page holds: the parsed page objects plus the
+  // images PDFium decodes and caches when the page is rendered.
+  static gsize EstimatePageCost(FPDF_PAGE page)
+  {
+    gsize cost = 64 * 1024;
+    int objectCount = FPDFPage_CountObjects(page);
+    for (int i = 0; i < objectCount; ++i)
+    {
+      RenderWorker::YieldSlice();
+      FPDF_PAGEOBJECT object = FPDFPage_GetObject(page, i);
+      cost += 256;
+      if (FPDFPageObj_GetType(object) != FPDF_PAGEOBJ_IMAGE)
+        continue;
+
+      FPDF_IMAGEOBJ_METADATA metadata = {};
+      if (FPDFImageObj_GetImageMetadata(object, nullptr, &metadata))
+      {
+        cost += static_cast<gsize>(metadata.width) * metadata.height * 4;
+      }
+    }
+    return cost;
+  }
+
+  PageCache::PageCache(const gchar *document_id)
+      : document_id_(document_id ? document_id : ""), memory_usage_(0), visible_first_(-1), visible_last_(-1)
+  {
+  }
+
+  // The document closes after its pages, no render can hold one then
+  PageCache::~PageCache()
+  {
+    for (Entry &entry : pages_)
+      entry.pins = 0;
+    Clear();
+  }
+
+  FPDF_PAGE PageCache::Get(FPDF_DOCUMENT document, int index)
+  {
+    auto it = entries_.find(index);
+    if (it != entries_.end())
+    {
+      RenderStats::Shared().Count(document_id_.c_str(), RenderCounter::kPageCacheHits);
+      pages_.splice(pages_.begin(), pages_, it->second);
+      return it->second->page;
+    }
+
+    FPDF_PAGE page = nullptr;
+    {
+      ScopedPhaseTimer timer(document_id_.c_str(), RenderPhase::kPageLoad);
+      page = FPDF_LoadPage(document, index);
+    }
+    if (!page)
+      return nullptr;
+
+    gsize cost = EstimatePageCost(page);
+    pages_.push_front(Entry{index, page, cost, 0});
+    entries_[index] = pages_.begin();
+    memory_usage_ += cost;
+    MemoryBudget::Shared().Charge(document_id_, MemoryCategory::kPageHandles, static_cast<gssize>(cost));
+    EvictToBudget(index);
+    return page;
+  }
+
+  void PageCache::Pin(int index)
+  {
+    auto it = entries_.find(index);
+    if (it != entries_.end())
+      ++it->second->pins;
+  }
+
+  void PageCache::Unpin(int index)
+  {
+    auto it = entries_.find(index);
+    if (it == entries_.end() || it->second->pins == 0 || --it->second->pins > 0)
+      return;
+
+    if (!IsNearVisibleRange(index))
+      Evict(it->second);
+    else
+      EvictToBudget(-1);
+  }
+
+  void PageCache::SetVisibleRange(int first, int last)
+  {
+    visible_first_ = first;
+    visible_last_ = last;
+    for (auto it = pages_.begin(); it != pages_.end();)
+    {
+      auto current = it++;
+      if (current->pins == 0 && !IsNearVisibleRange(current->index))
+        Evict(current);
+    }
+  }
+
+  void PageCache::ReleaseInvisible()
+  {
+    for (auto it = pages_.begin(); it != pages_.end();)
+    {
+      auto current = it++;
+      if (current->pins == 0 &&
+          (visible_first_ < 0 || current->index < visible_first_ || current->index > visible_last_))
+        Evict(current);
+    }
+  }
+
+  void PageCache::Clear()
+  {
+    for (auto it = pages_.begin(); it != pages_.end();)
+    {
+      auto current = it++;
+      if (current->pins == 0)
+        Evict(current);
+    }
+  }
+
+  bool PageCache::IsNearVisibleRange(int index) const
+  {
+    if (visible_first_ < 0)
+      return true;
+    return index >= visible_first_ - kVisibleRangeMargin && index <= visible_last_ + kVisibleRangeMargin;
+  }
+
+  void PageCache::Evict(std::list<Entry>::iterator it)
+  {
+    FPDF_ClosePage(it->page);
+    memory_usage_ -= it->cost;
+    MemoryBudget::Shared().Charge(document_id_, MemoryCategory::kPageHandles, -static_cast<gssize>(it->cost));
+    entries_.erase(it->index);
+    pages_.erase(it);
+  }
+
+  // Closes pages until the cache fits its budget, never closing |keep_index|
+  // or a pinned page. Pages away from the visible range are closed before
+  // visible ones, each group in least recently used order.
+  void PageCache::EvictToBudget(int keep_index)
+  {
+    while (pages_.size() > 1 &&
+           (pages_.size() > kMaximumCachedPages || memory_usage_ > kMaximumCachedBytes))
+    {
+      auto victim = pages_.end();
+      for (auto it = pages_.rbegin(); it != pages_.rend(); ++it)
+      {
+        if (it->index == keep_index || it->pins > 0)
+          continue;
+        if (victim == pages_.end())
+          victim = std::prev(it.base());
+        if (!IsNearVisibleRange(it->index))
+        {
+          victim = std::prev(it.base());
+          break;
+        }
+      }
+      if (victim == pages_.end())
+        return;
+      Evict(victim);
+    }
+  }
+} // namespace pdfviewer
@@ -0,0 +1,77 @@
+#ifndef PDFVIEWER_PAGE_CACHE_H_
+#define PDFVIEWER_PAGE_CACHE_H_
+
+#include <glib.h>
+#include <fpdfview.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace pdfviewer
+{
+  // Bounded LRU of loaded page handles of a single document.
+  //
+  // Keeping pages open lets consecutive renders of the same page reuse the
+  // parsed content stream and PDFium's decoded image cache. The cache is
+  // bounded both by page count and by an estimate of the memory held by each
+  // page, and pages far from the visible range reported by Dart go first.
+  // Pinned pages are never closed, so a render that yields to other jobs at
+  // the pause points of PDFium keeps its page. The estimate is charged to the
+  // document in the global memory budget.
+  class PageCache
+  {
+  public:
+    explicit PageCache(const gchar *document_id);
+    ~PageCache();
+
+    PageCache(const PageCache &) = delete;
+    PageCache &operator=(const PageCache &) = delete;
+
+    // Returns the page handle, loading it on a miss. The handle stays owned by
+    // the cache and is valid until the next call on the cache, or until the
+    // page is unpinned.
+    FPDF_PAGE Get(FPDF_DOCUMENT document, int index);
+    // Keeps the cached page open until the matching Unpin, whatever the
+    // visible range and the budget
+    void Pin(int index);
+    // Releases a pin, closing the page if it was kept beyond the visible
+    // range or the budget only by its pins
+    void Unpin(int index);
+    // Updates the visible page range (zero based) and closes the pages that are
+    // too far from it to be rendered again soon.
+    void SetVisibleRange(int first, int last);
+    // Closes the pages outside the visible range, margin excluded, or every
+    // page while no range is known. Pinned pages stay open.
+    void ReleaseInvisible();
+    // Closes every cached page that is not pinned
+    void Clear();
+
+    // Estimated memory held by the cached pages
+    gsize memoryUsage() const { return memory_usage_; }
+
+  private:
+    struct Entry
+    {
+      int index;
+      FPDF_PAGE page;
+      gsize cost;
+      // Renders in progress on the page
+      int pins;
+    };
+
+    bool IsNearVisibleRange(int index) const;
+    void Evict(std::list<Entry>::iterator it);
+    void EvictToBudget(int keep_index);
+
+    // Most recently used page first
+    std::list<Entry> pages_;
+    std::unordered_map<int, std::list<Entry>::iterator> entries_;
+    std::string document_id_;
+    gsize memory_usage_;
+    int visible_first_;
+    int visible_last_;
+  };
+} // namespace pdfviewer
+
+#endif
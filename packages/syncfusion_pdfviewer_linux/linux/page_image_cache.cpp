@@ -0,0 +1,98 @@
+#include "page_image_cache.h"
+
+#include <iterator>
+
+#include "bitmap_buffer_pool.h"
+#include "memory_budget.h"
+
+namespace pdfviewer
+{
+  // Maximum number of prerendered page images per document, the pages a fling
+  // is predicted to reach
+  static const size_t kMaximumPageImages = 4;
+
+  PageImageCache::PageImageCache(const gchar *document_id)
+      : document_id_(document_id ? document_id : ""), request_page_index_(-1), request_width_(0),
+        request_height_(0), request_flags_(0)
+  {
+  }
+
+  PageImageCache::~PageImageCache()
+  {
+    Clear();
+  }
+
+  void PageImageCache::SetLastRequest(int page_index, int width, int height, int flags)
+  {
+    request_page_index_ = page_index;
+    request_width_ = width;
+    request_height_ = height;
+    request_flags_ = flags;
+  }
+
+  bool PageImageCache::GetLastRequest(int *page_index, int *width, int *height, int *flags) const
+  {
+    if (request_page_index_ < 0)
+      return false;
+
+    *page_index = request_page_index_;
+    *width = request_width_;
+    *height = request_height_;
+    *flags = request_flags_;
+    return true;
+  }
+
+  std::list<PageImageCache::Entry>::const_iterator PageImageCache::Find(int page_index, int width, int height,
+                                                                      int flags) const
+  {
+    for (auto it = images_.begin(); it != images_.end(); ++it)
+    {
+      if (it->page_index == page_index && it->width == width && it->height == height && it->flags == flags)
+        return it;
+    }
+    return images_.end();
+  }
+
+  bool PageImageCache::Contains(int page_index, int width, int height, int flags) const
+  {
+    return Find(page_index, width, height, flags) != images_.end();
+  }
+
+  guint8 *PageImageCache::Take(int page_index, int width, int height, int flags, gsize *capacity)
+  {
+    auto it = Find(page_index, width, height, flags);
+    if (it == images_.end())
+      return nullptr;
+
+    guint8 *pixels = it->pixels;
+    *capacity = it->capacity;
+    MemoryBudget::Shared().Charge(document_id_, MemoryCategory::kTiles, -static_cast<gssize>(it->capacity));
+    images_.erase(it);
+    return pixels;
+  }
+
+  void PageImageCache::Insert(int page_index, int width, int height, int flags, guint8 *pixels, gsize capacity)
+  {
+    auto it = Find(page_index, width, height, flags);
+    if (it != images_.end())
+      Evict(it);
+
+    images_.push_front(Entry{page_index, width, height, flags, pixels, capacity});
+    MemoryBudget::Shared().Charge(document_id_, MemoryCategory::kTiles, static_cast<gssize>(capacity));
+    while (images_.size() > kMaximumPageImages)
+      Evict(std::prev(images_.end()));
+  }
+
+  void PageImageCache::Clear()
+  {
+    while (!images_.empty())
+      Evict(images_.begin());
+  }
+
+  void PageImageCache::Evict(std::list<Entry>::const_iterator it)
+  {
+    MemoryBudget::Shared().Charge(document_id_, MemoryCategory::kTiles, -static_cast<gssize>(it->capacity));
+    BitmapBufferPool::Shared().Release(it->pixels, it->capacity);
+    images_.erase(it);
+  }
+} // namespace pdfviewer
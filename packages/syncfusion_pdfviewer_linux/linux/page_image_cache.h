@@ -0,0 +1,70 @@
+#ifndef PDFVIEWER_PAGE_IMAGE_CACHE_H_
+#define PDFVIEWER_PAGE_IMAGE_CACHE_H_
+
+#include <glib.h>
+
+#include <list>
+#include <string>
+
+namespace pdfviewer
+{
+  // Few whole page images of a single document, prerendered ahead of a fling.
+  //
+  // The images are tightly packed RGBA rows in buffers of the shared bitmap
+  // buffer pool, rendered at the size and with the flags of the last page
+  // image Dart requested, scaled to each page. A request matching an image
+  // takes it out of the cache instead of rendering the page. Only used on the
+  // render worker. The images are charged to the document in the global
+  // memory budget, as tiles.
+  class PageImageCache
+  {
+  public:
+    explicit PageImageCache(const gchar *document_id);
+    ~PageImageCache();
+
+    PageImageCache(const PageImageCache &) = delete;
+    PageImageCache &operator=(const PageImageCache &) = delete;
+
+    // Remembers the page image Dart requested, the pages ahead are
+    // prerendered alike
+    void SetLastRequest(int page_index, int width, int height, int flags);
+    // Returns the last requested page image, false before any request
+    bool GetLastRequest(int *page_index, int *width, int *height, int *flags) const;
+
+    bool Contains(int page_index, int width, int height, int flags) const;
+    // Removes the image from the cache and hands its buffer over to the
+    // caller, who must return it with BitmapBufferPool::Release. Returns
+    // null on a miss.
+    guint8 *Take(int page_index, int width, int height, int flags, gsize *capacity);
+    // Stores the image, taking ownership of the pooled buffer. The oldest
+    // image goes when the cache is full.
+    void Insert(int page_index, int width, int height, int flags, guint8 *pixels, gsize capacity);
+    // Releases every image
+    void Clear();
+
+  private:
+    struct Entry
+    {
+      int page_index;
+      int width;
+      int height;
+      int flags;
+      guint8 *pixels;
+      gsize capacity;
+    };
+
+    std::list<Entry>::const_iterator Find(int page_index, int width, int height, int flags) const;
+    void Evict(std::list<Entry>::const_iterator it);
+
+    // Most recently inserted image first
+    std::list<Entry> images_;
+    std::string document_id_;
+    // Last requested page image, a negative page before any request
+    int request_page_index_;
+    int request_width_;
+    int request_height_;
+    int request_flags_;
+  };
+} // namespace pdfviewer
+
+#endif
@@ -0,0 +1,100 @@
+#include "pdf_page_texture.h"
+
+#include "bitmap_buffer_pool.h"
+
+// Frame buffer borrowed from the bitmap buffer pool
+typedef struct
+{
+  guint8 *pixels;
+  gsize capacity;
+  uint32_t width;
+  uint32_t height;
+} PdfPageFrame;
+
+struct _PdfPageTexture
+{
+  FlPixelBufferTexture parent_instance;
+
+  GMutex mutex;
+  // Latest frame presented by the render worker
+  PdfPageFrame front;
+  // Frame handed to the engine by the last copy_pixels call, it stays valid
+  // until the next call as the engine uploads it after copy_pixels returns
+  PdfPageFrame displayed;
+  // Frame replaced while the engine was still reading it
+  PdfPageFrame retired;
+};
+
+G_DEFINE_TYPE(PdfPageTexture, pdf_page_texture, fl_pixel_buffer_texture_get_type())
+
+static void pdf_page_frame_release(PdfPageFrame *frame)
+{
+  pdfviewer::BitmapBufferPool::Shared().Release(frame->pixels, frame->capacity);
+  *frame = PdfPageFrame{};
+}
+
+static gboolean pdf_page_texture_copy_pixels(FlPixelBufferTexture *texture, const uint8_t **out_buffer,
+                                             uint32_t *width, uint32_t *height, GError **error)
+{
+  PdfPageTexture *self = PDF_PAGE_TEXTURE(texture);
+  g_mutex_lock(&self->mutex);
+  // The previous upload has finished, so a frame retired since then is free
+  if (self->retired.pixels)
+  {
+    pdf_page_frame_release(&self->retired);
+  }
+  self->displayed = self->front;
+  *out_buffer = self->front.pixels;
+  *width = self->front.width;
+  *height = self->front.height;
+  g_mutex_unlock(&self->mutex);
+  return *out_buffer != nullptr;
+}
+
+static void pdf_page_texture_finalize(GObject *object)
+{
+  PdfPageTexture *self = PDF_PAGE_TEXTURE(object);
+  pdf_page_frame_release(&self->front);
+  pdf_page_frame_release(&self->retired);
+  g_mutex_clear(&self->mutex);
+
+  G_OBJECT_CLASS(pdf_page_texture_parent_class)->finalize(object);
+}
+
+static void pdf_page_texture_class_init(PdfPageTextureClass *klass)
+{
+  G_OBJECT_CLASS(klass)->finalize = pdf_page_texture_finalize;
+  FL_PIXEL_BUFFER_TEXTURE_CLASS(klass)->copy_pixels = pdf_page_texture_copy_pixels;
+}
+
+static void pdf_page_texture_init(PdfPageTexture *self)
+{
+  g_mutex_init(&self->mutex);
+}
+
+PdfPageTexture *pdf_page_texture_new()
+{
+  return PDF_PAGE_TEXTURE(g_object_new(pdf_page_texture_get_type(), nullptr));
+}
+
+void pdf_page_texture_present(PdfPageTexture *self, guint8 *pixels, gsize capacity,
+                              uint32_t width, uint32_t height)
+{
+  g_mutex_lock(&self->mutex);
+  PdfPageFrame previous = self->front;
+  self->front = PdfPageFrame{pixels, capacity, width, height};
+  if (previous.pixels && previous.pixels == self->displayed.pixels)
+  {
+    // The engine may still be uploading it, release it on the next copy
+    if (self->retired.pixels)
+    {
+      pdf_page_frame_release(&self->retired);
+    }
+    self->retired = previous;
+  }
+  else if (previous.pixels)
+  {
+    pdf_page_frame_release(&previous);
+  }
+  g_mutex_unlock(&self->mutex);
+}
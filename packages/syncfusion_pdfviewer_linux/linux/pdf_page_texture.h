@@ -0,0 +1,25 @@
+#ifndef PDFVIEWER_PDF_PAGE_TEXTURE_H_
+#define PDFVIEWER_PDF_PAGE_TEXTURE_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// External texture that shows a rendered PDF page.
+//
+// The render worker presents finished RGBA frames while the engine's raster
+// thread reads the latest one, so frames are double buffered under a mutex.
+G_DECLARE_FINAL_TYPE(PdfPageTexture, pdf_page_texture, PDF, PAGE_TEXTURE, FlPixelBufferTexture)
+
+PdfPageTexture *pdf_page_texture_new();
+
+// Replaces the displayed frame with |pixels|, tightly packed RGBA rows taken
+// from the shared bitmap buffer pool. The texture takes ownership of the buffer
+// and returns it to the pool once the engine no longer reads from it.
+void pdf_page_texture_present(PdfPageTexture *self, guint8 *pixels, gsize capacity,
+                              uint32_t width, uint32_t height);
+
+G_END_DECLS
+
+#endif
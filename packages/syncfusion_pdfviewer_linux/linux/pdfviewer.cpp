@@ -1,8 +1,23 @@
+#include <algorithm>
+#include <cstring>
 #include <unordered_map>
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <fpdfview.h>
+#include <fpdf_doc.h>
+#include <fpdf_edit.h>
+#include <fpdf_transformpage.h>
 
+#include "bitmap_buffer_pool.h"
+#include "memory_budget.h"
 #include "pdfviewer.h"
+#include "prefetcher.h"
+#include "render_farm.h"
+#include "render_stats.h"
+#include "render_worker.h"
+#include "text_index.h"
+#include "thumbnail_atlas.h"
+#include "tile_engine.h"
 
 namespace pdfviewer
 {
@@ -22,7 +37,14 @@ namespace pdfviewer
     }
   };
 
-  // Repository to store active PDF documents
+  // Number of pages indexed between two geometry progress reports
+  static const int kGeometryProgressInterval = 1024;
+  // Bytes hashed at the start and at the end of the file for the identity,
+  // incremental updates append to the end
+  static const gsize kIdentitySampleSize = 64 * 1024;
+
+  // Repository to store active PDF documents. Only accessed from the render
+  // worker thread, which serializes every PDFium call.
   std::unordered_map<GString *, PdfDocument *, GStringHash, GStringEqual> documentRepo;
 
   // Function to retrieve a PDF document by ID
@@ -51,67 +73,138 @@ namespace pdfviewer
 
     if (it != documentRepo.end())
     {
-      FPDF_CloseDocument(it->second->pdfDocument());
+      TileCache::Shared().RemoveDocument(doc_id);
+      RenderFarm::Shared().RemoveDocument(doc_id);
       delete it->second;
+      RenderStats::Shared().RemoveDocument(doc_id);
       g_string_free(it->first, TRUE);
       documentRepo.erase(it);
-      if (documentRepo.empty())
+      CloseProgressiveDocument(doc_id);
+      if (documentRepo.empty() && !HasProgressiveDocuments())
       {
         FPDF_DestroyLibrary();
       }
       return TRUE;
     }
+
+    // The document may still be waiting for its data
+    if (CloseProgressiveDocument(doc_id) && documentRepo.empty() && !HasProgressiveDocuments())
+    {
+      FPDF_DestroyLibrary();
+    }
     return FALSE;
   }
 
+  // Time since |start| not spent yielding to the main loop, |yielded| being
+  // the yielded time at the start
+  static gint64 GetElapsedTime(gint64 start, gint64 yielded)
+  {
+    return g_get_monotonic_time() - start - (GetYieldedTime() - yielded);
+  }
+
   // Function to initialize the PDF renderer
-  PdfDocument *InitializePdfRenderer(GBytes *data, const gchar *password, const gchar *doc_id)
+  PdfDocument *InitializePdfRenderer(GBytes *data, const gchar *password, const gchar *doc_id,
+                                     const OpenProgress &progress)
   {
     if (!data || !doc_id)
       return nullptr;
 
-    if (documentRepo.empty())
+    if (documentRepo.empty() && !HasProgressiveDocuments())
     {
       FPDF_InitLibraryWithConfig(nullptr);
     }
 
+    gint64 start = g_get_monotonic_time();
+    gint64 yielded = GetYieldedTime();
     PdfDocument *doc = new PdfDocument(data, password, doc_id);
     if (!doc->pdfDocument())
     {
       delete doc;
       return nullptr;
     }
+    RenderStats::Shared().AddDocument(doc_id);
+    if (progress)
+      progress(OpenPhase::kDocumentParsed, 0, 0);
+    doc->BuildPageGeometry(progress);
 
     documentRepo[g_string_new(doc_id)] = doc;
+    RenderStats::Shared().Record(doc_id, RenderPhase::kOpen, GetElapsedTime(start, yielded));
+    RenderFarm::Shared().AddDocument(doc_id, data, nullptr, password);
     return doc;
   }
 
   // Initialize the PDF renderer by loading a document from a file path
-  PdfDocument *LoadPdfFromFile(const gchar *file_path, const gchar *password, const gchar *doc_id)
+  PdfDocument *LoadPdfFromFile(const gchar *file_path, const gchar *password, const gchar *doc_id,
+                               const OpenProgress &progress)
   {
     if (!file_path || !doc_id)
       return nullptr;
 
-    if (documentRepo.empty())
+    if (documentRepo.empty() && !HasProgressiveDocuments())
     {
       FPDF_InitLibraryWithConfig(nullptr);
     }
 
+    gint64 start = g_get_monotonic_time();
+    gint64 yielded = GetYieldedTime();
     PdfDocument *doc = new PdfDocument(file_path, password, doc_id);
     if (!doc->pdfDocument())
     {
       delete doc;
       return nullptr;
     }
+    RenderStats::Shared().AddDocument(doc_id);
+    if (progress)
+      progress(OpenPhase::kDocumentParsed, 0, 0);
+    doc->BuildPageGeometry(progress);
 
     documentRepo[g_string_new(doc_id)] = doc;
+    RenderStats::Shared().Record(doc_id, RenderPhase::kOpen, GetElapsedTime(start, yielded));
+    RenderFarm::Shared().AddDocument(doc_id, nullptr, file_path, password);
+    return doc;
+  }
+
+  // Start opening a document from an upload that is still in progress
+  ProgressiveDocument *BeginProgressivePdfDocument(gint64 upload_id, const gchar *password, const gchar *doc_id)
+  {
+    if (!doc_id || GetPdfDocument(doc_id))
+      return nullptr;
+
+    if (documentRepo.empty() && !HasProgressiveDocuments())
+    {
+      FPDF_InitLibraryWithConfig(nullptr);
+    }
+    return BeginProgressiveDocument(upload_id, doc_id, password);
+  }
+
+  // Open the document of a progressive source and register it
+  PdfDocument *OpenProgressivePdfDocument(ProgressiveDocument *source)
+  {
+    if (!source || GetPdfDocument(source->documentID()))
+      return nullptr;
+
+    gint64 start = g_get_monotonic_time();
+    gint64 yielded = GetYieldedTime();
+    PdfDocument *doc = new PdfDocument(source, source->documentID());
+    if (!doc->pdfDocument())
+    {
+      delete doc;
+      return nullptr;
+    }
+    RenderStats::Shared().AddDocument(source->documentID());
+
+    documentRepo[g_string_new(source->documentID())] = doc;
+    RenderStats::Shared().Record(source->documentID(), RenderPhase::kOpen, GetElapsedTime(start, yielded));
     return doc;
   }
 
   // PdfDocument constructor
   PdfDocument::PdfDocument(GBytes *data, const gchar *password, const gchar *id)
-      : data_(g_bytes_ref(data)), document_id_(g_strdup(id)), pdf_document_(nullptr)
+      : data_(g_bytes_ref(data)), mapped_file_(nullptr), progressive_source_(nullptr), document_id_(g_strdup(id)),
+        pdf_document_(nullptr), page_cache_(id), page_images_(id), thumbnails_(nullptr), text_index_(nullptr),
+        prefetcher_(nullptr), file_size_(0), opened_with_password_(password && *password)
   {
+    MemoryBudget::Shared().Charge(id, MemoryCategory::kDocumentData, static_cast<gssize>(GetHeldDataSize()));
     gsize data_size;
     const guint8 *data_bytes = static_cast<const guint8 *>(g_bytes_get_data(data, &data_size));
     pdf_document_ = FPDF_LoadMemDocument64(data_bytes, data_size, password);
@@ -120,21 +213,323 @@ namespace pdfviewer
     }
   }
 
-  // Construct from a file path
+  // Construct from a file path. The file is memory mapped and read by PDFium
+  // through the mapping, falling back to PDFium's own file reader.
   PdfDocument::PdfDocument(const gchar *file_path, const gchar *password, const gchar *id)
-      : data_(nullptr), document_id_(g_strdup(id)), pdf_document_(nullptr)
+      : data_(nullptr), mapped_file_(MappedFile::Open(file_path)), progressive_source_(nullptr),
+        document_id_(g_strdup(id)), pdf_document_(nullptr), page_cache_(id), page_images_(id), thumbnails_(nullptr),
+        text_index_(nullptr), prefetcher_(nullptr), file_size_(0), opened_with_password_(password && *password)
+  {
+    if (mapped_file_)
+    {
+      pdf_document_ = FPDF_LoadCustomDocument(mapped_file_->fileAccess(), password);
+    }
+    else
+    {
+      pdf_document_ = FPDF_LoadDocument(file_path, password);
+      GStatBuf stat;
+      if (g_stat(file_path, &stat) == 0)
+        file_size_ = static_cast<gsize>(stat.st_size);
+    }
+    if (!pdf_document_)
+    {
+    }
+  }
+
+  // Construct from a progressive source whose document structure arrived.
+  // Pages are readable once the source reports them available.
+  PdfDocument::PdfDocument(ProgressiveDocument *source, const gchar *id)
+      : data_(nullptr), mapped_file_(nullptr), progressive_source_(source), document_id_(g_strdup(id)),
+        pdf_document_(source->LoadDocument()), page_cache_(id), page_images_(id), thumbnails_(nullptr),
+        text_index_(nullptr), prefetcher_(nullptr), file_size_(0), opened_with_password_(*source->password() != '\0')
+  {
+    MemoryBudget::Shared().Charge(id, MemoryCategory::kDocumentData, static_cast<gssize>(GetHeldDataSize()));
+    BuildPageGeometry();
+  }
+
+  FPDF_PAGE PdfDocument::LoadPage(int index)
+  {
+    if (!IsPageAvailable(index))
+      return nullptr;
+    // Handles returned earlier are only valid until this call unless pinned,
+    // so the page handles of every document can be reclaimed here
+    if (MemoryBudget::Shared().NeedsReclaim())
+      ReclaimMemory(MemoryTier::kPageHandles, MemoryBudget::Shared().limit());
+    return page_cache_.Get(pdf_document_, index);
+  }
+
+  PinnedPage::PinnedPage(PdfDocument *document, int index)
+      : document_(document), index_(index), page_(document->LoadPage(index))
+  {
+    if (page_)
+      document_->PinPage(index_);
+  }
+
+  PinnedPage::~PinnedPage()
+  {
+    if (page_)
+      document_->UnpinPage(index_);
+  }
+
+  bool PdfDocument::IsPageAvailable(int index)
   {
+    return !progressive_source_ || progressive_source_->IsPageAvailable(index);
+  }
 
-    pdf_document_ = FPDF_LoadDocument(file_path, password);
+  // Reads the size and label of every page from the page tree. Unlike
+  // FPDF_LoadPage this does not parse the page contents.
+  void PdfDocument::BuildPageGeometry(const OpenProgress &progress)
+  {
     if (!pdf_document_)
+      return;
+
+    int pageCount = FPDF_GetPageCount(pdf_document_);
+    page_geometry_.resize(pageCount);
+    if (progress)
+      progress(OpenPhase::kPagesCounted, 0, pageCount);
+    for (int i = 0; i < pageCount; ++i)
     {
+      ReadPageGeometry(i);
+      RenderWorker::YieldSlice();
+      if (progress && (i + 1) % kGeometryProgressInterval == 0 && i + 1 < pageCount)
+        progress(OpenPhase::kIndexingGeometry, i + 1, pageCount);
     }
+    if (progress)
+      progress(OpenPhase::kGeometryIndexed, pageCount, pageCount);
   }
 
-  // PdfDocument destructor
+  // Pages of a progressive document whose data has not arrived read as empty
+  // until refreshed
+  void PdfDocument::ReadPageGeometry(int index)
+  {
+    if (index < 0 || index >= pageCount())
+      return;
+
+    PageGeometry &geometry = page_geometry_[index];
+    FS_SIZEF size = {0, 0};
+    FPDF_GetPageSizeByIndexF(pdf_document_, index, &size);
+    geometry.width = size.width;
+    geometry.height = size.height;
+    geometry.has_page_boxes = false;
+    geometry.rotation = 0;
+    geometry.crop_box = FS_RECTF{0, size.height, size.width, 0};
+    geometry.label.clear();
+
+    // The label is UTF-16LE including the terminator
+    unsigned long length = FPDF_GetPageLabel(pdf_document_, index, nullptr, 0);
+    if (length > 2)
+    {
+      std::vector<gunichar2> label(length / sizeof(gunichar2));
+      FPDF_GetPageLabel(pdf_document_, index, label.data(), length);
+      gchar *utf8 = g_utf16_to_utf8(label.data(), -1, nullptr, nullptr, nullptr);
+      if (utf8)
+      {
+        geometry.label = utf8;
+        g_free(utf8);
+      }
+    }
+  }
+
+  const PageGeometry &PdfDocument::GetPageGeometry(int index, bool include_page_boxes)
+  {
+    PageGeometry &geometry = page_geometry_[index];
+    if (include_page_boxes && !geometry.has_page_boxes)
+    {
+      FPDF_PAGE page = LoadPage(index);
+      if (page)
+      {
+        geometry.rotation = FPDFPage_GetRotation(page) * 90;
+        float left = 0;
+        float bottom = 0;
+        float right = 0;
+        float top = 0;
+        if (FPDFPage_GetCropBox(page, &left, &bottom, &right, &top) ||
+            FPDFPage_GetMediaBox(page, &left, &bottom, &right, &top))
+        {
+          geometry.crop_box = FS_RECTF{left, top, right, bottom};
+        }
+        geometry.has_page_boxes = true;
+      }
+    }
+    return geometry;
+  }
+
+  ThumbnailAtlas *PdfDocument::StartThumbnails(int thumbnail_height)
+  {
+    if (thumbnails_ && thumbnails_->thumbnailHeight() == thumbnail_height)
+      return thumbnails_;
+
+    // Passes queued for the replaced thumbnails carry on with the new ones
+    ThumbnailAtlas *thumbnails = new ThumbnailAtlas(this, thumbnail_height);
+    if (thumbnails_)
+    {
+      thumbnails->SetScheduled(thumbnails_->isScheduled());
+      delete thumbnails_;
+    }
+    thumbnails_ = thumbnails;
+    return thumbnails_;
+  }
+
+  TextIndex *PdfDocument::StartTextIndex()
+  {
+    if (!text_index_)
+      text_index_ = new TextIndex(this);
+    return text_index_;
+  }
+
+  Prefetcher *PdfDocument::StartPrefetcher()
+  {
+    if (!prefetcher_)
+      prefetcher_ = new Prefetcher(this);
+    return prefetcher_;
+  }
+
+  // Bytes of the document held in memory, the upload buffer of a progressive
+  // document included. Mapped and read files are backed by the file.
+  gsize PdfDocument::GetHeldDataSize() const
+  {
+    if (data_)
+      return g_bytes_get_size(data_);
+    if (progressive_source_)
+      return progressive_source_->fileSize();
+    return 0;
+  }
+
+  gsize PdfDocument::fileSize() const
+  {
+    if (data_)
+      return g_bytes_get_size(data_);
+    if (mapped_file_)
+      return mapped_file_->size();
+    if (progressive_source_)
+      return progressive_source_->fileSize();
+    return file_size_;
+  }
+
+  // Reads bytes of the document file, false when they are not available
+  bool PdfDocument::ReadBytes(gsize offset, guint8 *buffer, gsize size)
+  {
+    if (data_)
+    {
+      gsize length = 0;
+      const guint8 *bytes = static_cast<const guint8 *>(g_bytes_get_data(data_, &length));
+      if (offset > length || size > length - offset)
+        return false;
+      memcpy(buffer, bytes + offset, size);
+      return true;
+    }
+    FPDF_FILEACCESS *access = mapped_file_ ? mapped_file_->fileAccess()
+                              : progressive_source_ ? progressive_source_->fileAccess()
+                                                    : nullptr;
+    return access && access->m_GetBlock(access->m_Param, offset, buffer, size);
+  }
+
+  bool PdfDocument::isEncrypted() const
+  {
+    return opened_with_password_ || (pdf_document_ && FPDF_GetSecurityHandlerRevision(pdf_document_) != -1);
+  }
+
+  const std::string &PdfDocument::identity()
+  {
+    if (!identity_.empty() || !pdf_document_)
+      return identity_;
+
+    gsize size = fileSize();
+    gsize sampleSize = std::min(size, kIdentitySampleSize);
+    std::vector<guint8> head(sampleSize);
+    std::vector<guint8> tail(sampleSize);
+    if (sampleSize == 0 || !ReadBytes(0, head.data(), sampleSize) ||
+        !ReadBytes(size - sampleSize, tail.data(), sampleSize))
+      return identity_;
+
+    GChecksum *checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    // The identifiers are byte strings followed by a terminator
+    for (FPDF_FILEIDTYPE type : {FILEIDTYPE_PERMANENT, FILEIDTYPE_CHANGING})
+    {
+      unsigned long length = FPDF_GetFileIdentifier(pdf_document_, type, nullptr, 0);
+      std::vector<guint8> identifier(std::max(length, 1ul));
+      FPDF_GetFileIdentifier(pdf_document_, type, identifier.data(), length);
+      g_checksum_update(checksum, identifier.data(), length > 0 ? length - 1 : 0);
+    }
+    guint64 sizeValue = GUINT64_TO_LE(size);
+    g_checksum_update(checksum, reinterpret_cast<const guchar *>(&sizeValue), sizeof(sizeValue));
+    g_checksum_update(checksum, head.data(), sampleSize);
+    g_checksum_update(checksum, tail.data(), sampleSize);
+    identity_ = g_checksum_get_string(checksum);
+    g_checksum_free(checksum);
+    return identity_;
+  }
+
+  // PdfDocument destructor, cached pages must be closed before the document
   PdfDocument::~PdfDocument()
   {
-    g_bytes_unref(data_);
+    delete prefetcher_;
+    delete text_index_;
+    delete thumbnails_;
+    page_cache_.Clear();
+    if (pdf_document_)
+    {
+      FPDF_CloseDocument(pdf_document_);
+    }
+    MemoryBudget::Shared().Charge(document_id_, MemoryCategory::kDocumentData,
+                                  -static_cast<gssize>(GetHeldDataSize()));
+    if (data_)
+    {
+      g_bytes_unref(data_);
+    }
+    delete mapped_file_;
     g_free(document_id_);
   }
+
+  // Gives up the tiers in order and returns once the evictable usage is at
+  // most |target|
+  static void ReclaimTiers(MemoryTier tier, gsize target)
+  {
+    MemoryBudget &budget = MemoryBudget::Shared();
+    BitmapBufferPool::Shared().Trim();
+    // Prerendered page images are only a guess at what comes next
+    for (auto &document : documentRepo)
+      document.second->pageImages().Clear();
+    gsize evictable = budget.GetTotalUsage().Evictable();
+    if (evictable > target)
+      TileCache::Shared().Trim(evictable - target);
+    if (tier == MemoryTier::kTiles)
+      return;
+
+    // Dart keeps its own copy of the atlases it fetched, the ones of the
+    // thumbnails out of view are generated again once scrolled back to
+    for (auto &document : documentRepo)
+    {
+      if (budget.GetTotalUsage().Evictable() <= target)
+        return;
+      if (document.second->thumbnails())
+        document.second->thumbnails()->EvictHiddenAtlases();
+    }
+    if (tier == MemoryTier::kThumbnails)
+      return;
+
+    // Pages away from the viewport of every document go before visible ones
+    for (auto &document : documentRepo)
+    {
+      if (budget.GetTotalUsage().Evictable() <= target)
+        return;
+      document.second->ReleaseInvisiblePages();
+    }
+    if (tier == MemoryTier::kPageHandles)
+      return;
+
+    // Closing the pages also frees the images PDFium decoded for them, the
+    // renders that load them again keep as few decoded images as possible
+    for (auto &document : documentRepo)
+      document.second->ReleasePages();
+    budget.LimitImageCache();
+  }
+
+  void ReclaimMemory(MemoryTier tier, gsize target)
+  {
+    ReclaimTiers(tier, target);
+    // A reclaim that could not get under the limit is not retried on every
+    // page load, only once the usage grew again
+    MemoryBudget::Shared().EndReclaim();
+  }
 } // namespace pdfviewer
\ No newline at end of file
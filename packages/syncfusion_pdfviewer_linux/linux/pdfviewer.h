@@ -1,14 +1,57 @@
 #include <glib.h>
 #include <fpdfview.h>
 
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+#include "page_cache.h"
+#include "page_image_cache.h"
+#include "progressive_document.h"
+
 namespace pdfviewer {
 
+  class Prefetcher;
+  class TextIndex;
+  class ThumbnailAtlas;
+
+  // Geometry of a page in points. The size and label come from the page
+  // dictionary, the rotation and crop box need the page to be loaded.
+  struct PageGeometry {
+    float width;
+    float height;
+    bool has_page_boxes;
+    int rotation;
+    FS_RECTF crop_box;
+    std::string label;
+  };
+
+  // Phases of opening a document, reported from the render worker
+  enum class OpenPhase {
+    // The cross-reference table was parsed, or rebuilt for a broken file
+    kDocumentParsed,
+    // The page tree was counted
+    kPagesCounted,
+    // Part of the page geometry index was filled
+    kIndexingGeometry,
+    // The page geometry index is complete
+    kGeometryIndexed,
+  };
+
+  // Receives the phase with the number of pages indexed so far and the page
+  // count, both 0 before the pages are counted
+  typedef std::function<void(OpenPhase phase, int pages_done, int page_count)> OpenProgress;
+
   class PdfDocument {
   public:
     // Constructor initializes the document with data, password and its ID
     PdfDocument(GBytes* data, const gchar *password, const gchar *id);
     // Constructor initializes the document from a file path
     PdfDocument(const gchar *file_path, const gchar *password, const gchar *id);
+    // Constructor opens a document whose bytes are still arriving, the
+    // progressive document must outlive it
+    PdfDocument(ProgressiveDocument *source, const gchar *id);
     ~PdfDocument();
 
     // Accessor for document ID
@@ -17,15 +60,129 @@ namespace pdfviewer {
     // Accessor for document
     FPDF_DOCUMENT pdfDocument() const { return pdf_document_; }
 
+    // Size of the document file in bytes
+    gsize fileSize() const;
+
+    // Identifies the document across sessions, for the disk caches: a hash
+    // of its file identifiers, size and leading and trailing bytes, which
+    // change with any edit. Empty while those bytes cannot be read, such as
+    // before a progressive document arrived.
+    const std::string &identity();
+
+    // Whether the document has a security handler or was opened with a
+    // password. Nothing derived from its content is written to the disk
+    // caches then.
+    bool isEncrypted() const;
+
+    // Returns the page at the zero based index from the page cache. The handle
+    // is owned by the document and must not be closed by the caller, it is
+    // valid until the next call unless pinned. Returns null while the data of
+    // the page has not arrived.
+    FPDF_PAGE LoadPage(int index);
+    // Keeps a page returned by LoadPage open until it is unpinned, see
+    // PinnedPage
+    void PinPage(int index) { page_cache_.Pin(index); }
+    void UnpinPage(int index) { page_cache_.Unpin(index); }
+
+    // Whether the data of the page has arrived, always true unless the
+    // document is opened progressively
+    bool IsPageAvailable(int index);
+
+    // Viewport hint, pages far from the visible range are released
+    void SetVisiblePages(int first_index, int last_index) { page_cache_.SetVisibleRange(first_index, last_index); }
+    // Closes the cached pages outside the visible range, on memory pressure
+    void ReleaseInvisiblePages() { page_cache_.ReleaseInvisible(); }
+    // Closes every cached page, on memory pressure
+    void ReleasePages() { page_cache_.Clear(); }
+
+    // Whole page images prerendered ahead of a fling
+    PageImageCache &pageImages() { return page_images_; }
+
+    // Number of pages in the geometry index
+    int pageCount() const { return static_cast<int>(page_geometry_.size()); }
+
+    // Returns the indexed geometry of the page, loading the page first when
+    // the rotation and crop box are requested and not yet known
+    const PageGeometry &GetPageGeometry(int index, bool include_page_boxes);
+    // Reads the geometry of a page again, once its data has arrived
+    void RefreshPageGeometry(int index) { ReadPageGeometry(index); }
+
+    // Fills the geometry index without loading the pages
+    void BuildPageGeometry(const OpenProgress &progress = nullptr);
+
+    // Thumbnails of the pages, null until they are requested
+    ThumbnailAtlas *thumbnails() const { return thumbnails_; }
+    // Returns the thumbnails at the given height, replacing thumbnails of
+    // another height
+    ThumbnailAtlas *StartThumbnails(int thumbnail_height);
+
+    // Text index of the pages, null until it is started
+    TextIndex *textIndex() const { return text_index_; }
+    // Returns the text index, loading it from the disk cache or starting an
+    // empty one the first time
+    TextIndex *StartTextIndex();
+
+    // Prefetcher of the tiles ahead of the viewport, null until the first
+    // viewport hint
+    Prefetcher *prefetcher() const { return prefetcher_; }
+    // Returns the prefetcher, creating it the first time
+    Prefetcher *StartPrefetcher();
+
   private:
+    void ReadPageGeometry(int index);
+    gsize GetHeldDataSize() const;
+    bool ReadBytes(gsize offset, guint8 *buffer, gsize size);
+
     GBytes* data_;
+    // Mapping of the file the document was loaded from, null for documents
+    // loaded from memory or when the file could not be mapped
+    MappedFile* mapped_file_;
+    // Source of a document opened while its bytes are still arriving
+    ProgressiveDocument* progressive_source_;
     gchar* document_id_;
     FPDF_DOCUMENT pdf_document_;
+    PageCache page_cache_;
+    PageImageCache page_images_;
+    std::vector<PageGeometry> page_geometry_;
+    ThumbnailAtlas* thumbnails_;
+    TextIndex* text_index_;
+    Prefetcher* prefetcher_;
+    // Size of a file opened without a mapping
+    gsize file_size_;
+    std::string identity_;
+    bool opened_with_password_;
+  };
+
+  // Page of a document kept open while in scope. Renders hold one, since the
+  // jobs and main loop iterations run while they yield may load other pages,
+  // move the visible range or reclaim memory, which would otherwise close the
+  // page under them.
+  class PinnedPage {
+  public:
+    // Loads the page, null while its data has not arrived
+    PinnedPage(PdfDocument* document, int index);
+    ~PinnedPage();
+
+    PinnedPage(const PinnedPage &) = delete;
+    PinnedPage &operator=(const PinnedPage &) = delete;
+
+    FPDF_PAGE page() const { return page_; }
+
+  private:
+    PdfDocument* document_;
+    int index_;
+    FPDF_PAGE page_;
   };
 
-  PdfDocument* InitializePdfRenderer(GBytes* data, const gchar *password, const gchar *doc_id);
+  PdfDocument* InitializePdfRenderer(GBytes* data, const gchar *password, const gchar *doc_id,
+                                     const OpenProgress &progress = nullptr);
   // Initialize renderer by loading a PDF file from disk
-  PdfDocument* LoadPdfFromFile(const gchar *file_path, const gchar *password, const gchar *doc_id);
+  PdfDocument* LoadPdfFromFile(const gchar *file_path, const gchar *password, const gchar *doc_id,
+                               const OpenProgress &progress = nullptr);
+  // Starts opening a document from an upload whose bytes are still arriving
+  ProgressiveDocument* BeginProgressivePdfDocument(gint64 upload_id, const gchar *password, const gchar *doc_id);
+  // Opens the document of the progressive source once its structure arrived
+  PdfDocument* OpenProgressivePdfDocument(ProgressiveDocument *source);
   PdfDocument* GetPdfDocument(const gchar *doc_id);
   gboolean ClosePdfDocument(const gchar *doc_id);
 
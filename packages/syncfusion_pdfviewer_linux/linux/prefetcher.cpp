@@ -0,0 +1,206 @@
+#include "prefetcher.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "bitmap_buffer_pool.h"
+#include "memory_budget.h"
+#include "pdfviewer.h"
+#include "render_request.h"
+#include "render_worker.h"
+#include "tile_engine.h"
+
+namespace pdfviewer
+{
+  // Slower scrolling is left to the requests Dart makes once it settles, in
+  // points per second
+  static const double kMinimumPrefetchSpeed = 60.0;
+  // How far ahead the viewport is predicted, in seconds
+  static const double kPrefetchHorizon = 0.6;
+  // Upper bound of the predicted travel, in viewports
+  static const double kMaximumPrefetchViewports = 3.0;
+  // Upper bound of the pages warmed ahead when pages are displayed whole
+  static const int kMaximumPrefetchPages = 4;
+
+  Prefetcher::Prefetcher(PdfDocument *document) : document_(document), next_item_(0), scheduled_(false) {}
+
+  double Prefetcher::GetPageExtent(int index, bool horizontal)
+  {
+    const PageGeometry &geometry = document_->GetPageGeometry(index, false);
+    return horizontal ? geometry.width : geometry.height;
+  }
+
+  void Prefetcher::Update(const ViewportHint &hint)
+  {
+    items_.clear();
+    planned_.clear();
+    next_item_ = 0;
+
+    double speed = std::hypot(hint.velocity_x, hint.velocity_y);
+    int pageCount = document_->pageCount();
+    if (speed < kMinimumPrefetchSpeed || hint.first_page < 0 || hint.first_page >= pageCount)
+      return;
+
+    double travelX = hint.velocity_x * kPrefetchHorizon;
+    double travelY = hint.velocity_y * kPrefetchHorizon;
+    if (!hint.has_region || hint.scale <= 0 || hint.width <= 0 || hint.height <= 0)
+    {
+      PlanPages(hint, std::fabs(hint.horizontal ? travelX : travelY));
+      return;
+    }
+
+    // Shortens the travel to the bound, keeping its direction
+    double viewports = std::max(std::fabs(travelX) / hint.width, std::fabs(travelY) / hint.height);
+    if (viewports > kMaximumPrefetchViewports)
+    {
+      travelX *= kMaximumPrefetchViewports / viewports;
+      travelY *= kMaximumPrefetchViewports / viewports;
+      viewports = kMaximumPrefetchViewports;
+    }
+
+    // The visible tiles are requested by Dart itself, then the viewport is
+    // moved along the travel a viewport at most per step
+    PlanTiles(hint, hint.left, hint.top, hint.width, hint.height, false);
+    int steps = std::max(1, static_cast<int>(std::ceil(viewports)));
+    for (int step = 1; step <= steps; ++step)
+    {
+      double fraction = static_cast<double>(step) / steps;
+      PlanTiles(hint, hint.left + travelX * fraction, hint.top + travelY * fraction, hint.width, hint.height, true);
+    }
+  }
+
+  void Prefetcher::PlanPages(const ViewportHint &hint, double distance)
+  {
+    double velocity = hint.horizontal ? hint.velocity_x : hint.velocity_y;
+    int direction = velocity > 0 ? 1 : -1;
+    double extent = std::max(1.0, GetPageExtent(hint.first_page, hint.horizontal));
+    int count = std::min(kMaximumPrefetchPages, std::max(1, static_cast<int>(std::ceil(distance / extent))));
+    int index = direction > 0 ? hint.last_page + 1 : hint.first_page - 1;
+    for (int i = 0; i < count && index >= 0 && index < document_->pageCount(); ++i, index += direction)
+      items_.push_back(Item{index, 0, -1, -1});
+  }
+
+  // Pages are taken as adjacent, the spacing Dart lays out between them is a
+  // few points and only shifts the prediction slightly
+  void Prefetcher::PlanTiles(const ViewportHint &hint, double left, double top, double width, double height,
+                             bool add)
+  {
+    int pageCount = document_->pageCount();
+    double start = hint.horizontal ? left : top;
+    double end = start + (hint.horizontal ? width : height);
+
+    // Offset of the page along the layout, relative to the first visible page
+    int index = hint.first_page;
+    double offset = 0;
+    while (index > 0 && start < offset)
+    {
+      --index;
+      offset -= GetPageExtent(index, hint.horizontal);
+    }
+
+    int zoomBucket = GetZoomBucket(hint.scale);
+    double bucketScale = GetZoomBucketScale(zoomBucket);
+    for (; index < pageCount && offset < end; offset += GetPageExtent(index, hint.horizontal), ++index)
+    {
+      const PageGeometry &geometry = document_->GetPageGeometry(index, false);
+      double pageLeft = hint.horizontal ? left - offset : left;
+      double pageTop = hint.horizontal ? top : top - offset;
+      double pageRight = std::min<double>(pageLeft + width, geometry.width);
+      double pageBottom = std::min<double>(pageTop + height, geometry.height);
+      pageLeft = std::max(0.0, pageLeft);
+      pageTop = std::max(0.0, pageTop);
+      if (pageRight <= pageLeft || pageBottom <= pageTop)
+        continue;
+
+      int lastColumn = (static_cast<int>(std::ceil(geometry.width * bucketScale)) - 1) / kGridTileSize;
+      int lastRow = (static_cast<int>(std::ceil(geometry.height * bucketScale)) - 1) / kGridTileSize;
+      int firstColumn = static_cast<int>(std::floor(pageLeft * bucketScale / kGridTileSize));
+      int firstRow = static_cast<int>(std::floor(pageTop * bucketScale / kGridTileSize));
+      int endColumn = std::min(lastColumn, static_cast<int>(std::ceil(pageRight * bucketScale / kGridTileSize)) - 1);
+      int endRow = std::min(lastRow, static_cast<int>(std::ceil(pageBottom * bucketScale / kGridTileSize)) - 1);
+      for (int row = firstRow; row <= endRow; ++row)
+      {
+        for (int column = firstColumn; column <= endColumn; ++column)
+        {
+          if (planned_.insert(std::make_tuple(index, column, row)).second && add)
+            items_.push_back(Item{index, zoomBucket, column, row});
+        }
+      }
+    }
+  }
+
+  // Dart sizes the page images in proportion to the pages, so the last
+  // request scaled to the page predicts the size the page will be asked at
+  bool Prefetcher::PrerenderPage(int index)
+  {
+    PinnedPage pinnedPage(document_, index);
+    FPDF_PAGE page = pinnedPage.page();
+    PageImageCache &images = document_->pageImages();
+    int requestIndex = 0;
+    int requestWidth = 0;
+    int requestHeight = 0;
+    int flags = 0;
+    if (!page || !images.GetLastRequest(&requestIndex, &requestWidth, &requestHeight, &flags) ||
+        MemoryBudget::Shared().IsOverLimit())
+      return true;
+
+    const PageGeometry &request = document_->GetPageGeometry(requestIndex, false);
+    const PageGeometry &geometry = document_->GetPageGeometry(index, false);
+    if (request.width <= 0 || request.height <= 0)
+      return true;
+    int width = static_cast<int>(std::lround(requestWidth * geometry.width / request.width));
+    int height = static_cast<int>(std::lround(requestHeight * geometry.height / request.height));
+    if (width <= 0 || height <= 0 || images.Contains(index, width, height, flags))
+      return true;
+
+    PooledBitmap pooledBitmap(width, height);
+    FPDF_BITMAP bitmap = pooledBitmap.bitmap();
+    if (!bitmap)
+      return true;
+    FPDFBitmap_FillRect(bitmap, 0, 0, width, height, 0xFFFFFFFF);
+    if (RenderPageProgressive(bitmap, page, 0, 0, width, height, flags, nullptr, document_->documentID()) !=
+        RenderStatus::kDone)
+      return false;
+
+    gsize capacity = 0;
+    guint8 *pixels = pooledBitmap.TakeBuffer(&capacity);
+    images.Insert(index, width, height, flags, pixels, capacity);
+    return true;
+  }
+
+  void Prefetcher::PrefetchNext()
+  {
+    while (next_item_ < items_.size())
+    {
+      const Item &item = items_[next_item_++];
+      if (!document_->IsPageAvailable(item.page_index))
+        continue;
+
+      if (item.column < 0)
+      {
+        if (!PrerenderPage(item.page_index) && RenderWorker::IsPreempted())
+          --next_item_;
+        return;
+      }
+
+      TileKey key{document_->documentID(), item.page_index, item.zoom_bucket, item.column, item.row};
+      int width = 0;
+      int height = 0;
+      GBytes *tile = TileCache::Shared().Lookup(key, &width, &height);
+      if (tile)
+      {
+        // Cached tiles cost nothing, the pass carries on with the next item
+        g_bytes_unref(tile);
+        continue;
+      }
+
+      tile = GetGridTile(document_, item.page_index, item.zoom_bucket, item.column, item.row, nullptr, &width,
+                         &height);
+      if (tile)
+        g_bytes_unref(tile);
+      else if (RenderWorker::IsPreempted())
+        --next_item_; // Retried by the next pass, after the more urgent job
+      return;
+    }
+  }
+} // namespace pdfviewer
@@ -0,0 +1,98 @@
+#ifndef PDFVIEWER_PREFETCHER_H_
+#define PDFVIEWER_PREFETCHER_H_
+
+#include <glib.h>
+
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace pdfviewer
+{
+  class PdfDocument;
+
+  // Viewport reported by Dart while the user scrolls
+  struct ViewportHint
+  {
+    // Zero based range of the visible pages
+    int first_page;
+    int last_page;
+    // Whether the region below is known
+    bool has_region;
+    // Visible region in points from the top left corner of the first visible
+    // page, it may extend over the following pages
+    double left;
+    double top;
+    double width;
+    double height;
+    // Scroll velocity in points per second
+    double velocity_x;
+    double velocity_y;
+    // Device pixels per point of the grid tiles, 0 while pages are displayed
+    // whole rather than as grid tiles
+    double scale;
+    // Whether the pages are laid out left to right instead of top to bottom
+    bool horizontal;
+  };
+
+  // Speculative renders ahead of the viewport in the direction of travel.
+  //
+  // Each viewport hint replaces the plan with the grid tiles the viewport is
+  // predicted to cover over the next fraction of a second, nearest first, or
+  // with the next pages when they are displayed whole. Those pages are
+  // prerendered at the size of the last page image Dart requested, scaled to
+  // each page. The plan runs one item at a time as prefetch jobs on the
+  // render worker, so visible renders always go first and preempt a running
+  // prefetch render, and fills the tile and page image caches the requests
+  // for the newly visible area then hit.
+  class Prefetcher
+  {
+  public:
+    explicit Prefetcher(PdfDocument *document);
+
+    Prefetcher(const Prefetcher &) = delete;
+    Prefetcher &operator=(const Prefetcher &) = delete;
+
+    // Plans the renders ahead of the reported viewport, dropping the
+    // previous plan
+    void Update(const ViewportHint &hint);
+    // Renders the next planned tile or page that is not cached yet. A
+    // preempted render stays planned.
+    void PrefetchNext();
+    // Whether planned items remain
+    bool HasPending() const { return next_item_ < items_.size(); }
+
+    // Whether prefetch passes are queued on the render worker
+    bool isScheduled() const { return scheduled_; }
+    void SetScheduled(bool scheduled) { scheduled_ = scheduled; }
+
+  private:
+    // Grid tile of a page at a zoom bucket, or the whole page when the
+    // column is negative
+    struct Item
+    {
+      int page_index;
+      int zoom_bucket;
+      int column;
+      int row;
+    };
+
+    void PlanPages(const ViewportHint &hint, double distance);
+    // Adds the tiles of the region, given relative to the first visible page,
+    // that were not added yet
+    void PlanTiles(const ViewportHint &hint, double left, double top, double width, double height, bool add);
+    double GetPageExtent(int index, bool horizontal);
+    // Renders the page into the page image cache, or only loads it before
+    // Dart requested any page image. Returns false when the render stopped.
+    bool PrerenderPage(int index);
+
+    PdfDocument *document_;
+    std::vector<Item> items_;
+    std::size_t next_item_;
+    // Tiles already planned or visible, as page, column and row
+    std::set<std::tuple<int, int, int>> planned_;
+    bool scheduled_;
+  };
+} // namespace pdfviewer
+
+#endif
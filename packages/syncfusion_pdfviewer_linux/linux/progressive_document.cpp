@@ -0,0 +1,181 @@
+#include "progressive_document.h"
+
+#include <cstring>
+#include <unordered_map>
+
+#include "document_upload.h"
+
+namespace pdfviewer
+{
+  ProgressiveDocument::ProgressiveDocument(gint64 upload_id, DocumentUpload *upload, const gchar *doc_id,
+                                           const gchar *password)
+      : upload_id_(upload_id), upload_(upload), document_id_(doc_id), password_(password ? password : ""),
+        linearization_reported_(false), range_requests_enabled_(false)
+  {
+    file_avail_.version = 1;
+    file_avail_.IsDataAvail = IsDataAvail;
+    file_avail_.document = this;
+
+    file_access_.m_FileLen = static_cast<unsigned long>(upload_->length());
+    file_access_.m_GetBlock = GetBlock;
+    file_access_.m_Param = this;
+
+    hints_.version = 1;
+    hints_.AddSegment = AddSegment;
+    hints_.document = this;
+    hints_.record = true;
+
+    avail_ = FPDFAvail_Create(&file_avail_, &file_access_);
+  }
+
+  ProgressiveDocument::~ProgressiveDocument()
+  {
+    if (avail_)
+    {
+      FPDFAvail_Destroy(avail_);
+    }
+  }
+
+  int ProgressiveDocument::IsLinearized()
+  {
+    return avail_ ? FPDFAvail_IsLinearized(avail_) : PDF_LINEARIZATION_UNKNOWN;
+  }
+
+  bool ProgressiveDocument::IsDocumentAvailable()
+  {
+    return avail_ && FPDFAvail_IsDocAvail(avail_, &hints_) == PDF_DATA_AVAIL;
+  }
+
+  FPDF_DOCUMENT ProgressiveDocument::LoadDocument()
+  {
+    return avail_ ? FPDFAvail_GetDocument(avail_, password_.c_str()) : nullptr;
+  }
+
+  bool ProgressiveDocument::IsPageAvailable(int index)
+  {
+    if (index < 0)
+      return false;
+    if (index < static_cast<int>(available_pages_.size()) && available_pages_[index])
+      return true;
+
+    hints_.record = false;
+    bool available = FPDFAvail_IsPageAvail(avail_, index, &hints_) == PDF_DATA_AVAIL;
+    hints_.record = true;
+    if (available && index < static_cast<int>(available_pages_.size()))
+    {
+      available_pages_[index] = true;
+    }
+    return available;
+  }
+
+  std::vector<int> ProgressiveDocument::UpdatePageAvailability(int page_count)
+  {
+    available_pages_.resize(page_count, false);
+
+    std::vector<int> pages;
+    bool needed_page_found = false;
+    for (int i = 0; i < page_count; ++i)
+    {
+      if (available_pages_[i])
+        continue;
+
+      // Only the first missing page asks for more data, so the requested
+      // ranges follow the reading order
+      hints_.record = !needed_page_found;
+      if (FPDFAvail_IsPageAvail(avail_, i, &hints_) == PDF_DATA_AVAIL)
+      {
+        available_pages_[i] = true;
+        pages.push_back(i);
+      }
+      else
+      {
+        needed_page_found = true;
+      }
+    }
+    hints_.record = true;
+    return pages;
+  }
+
+  std::vector<std::pair<gsize, gsize>> ProgressiveDocument::TakeRequestedRanges()
+  {
+    std::vector<std::pair<gsize, gsize>> ranges;
+    ranges.swap(requested_ranges_);
+    return ranges;
+  }
+
+  FPDF_BOOL ProgressiveDocument::IsDataAvail(FX_FILEAVAIL *file_avail, size_t offset, size_t size)
+  {
+    ProgressiveDocument *self = static_cast<FileAvail *>(file_avail)->document;
+    return self->upload_->IsRangeReceived(offset, size);
+  }
+
+  void ProgressiveDocument::AddSegment(FX_DOWNLOADHINTS *hints, size_t offset, size_t size)
+  {
+    DownloadHints *download_hints = static_cast<DownloadHints *>(hints);
+    ProgressiveDocument *self = download_hints->document;
+    if (!self->range_requests_enabled_ || !download_hints->record || self->upload_->IsRangeReceived(offset, size))
+      return;
+
+    for (const auto &range : self->requested_ranges_)
+    {
+      if (range.first == offset && range.second == size)
+        return;
+    }
+    self->requested_ranges_.emplace_back(offset, size);
+  }
+
+  int ProgressiveDocument::GetBlock(void *param, unsigned long position, unsigned char *buffer, unsigned long size)
+  {
+    ProgressiveDocument *self = static_cast<ProgressiveDocument *>(param);
+    if (!self->upload_->IsRangeReceived(position, size))
+      return 0;
+
+    memcpy(buffer, self->upload_->data() + position, size);
+    return 1;
+  }
+
+  // Progressive documents by upload ID. Only accessed from the render worker
+  // thread.
+  static std::unordered_map<gint64, ProgressiveDocument *> progressiveDocuments;
+
+  ProgressiveDocument *BeginProgressiveDocument(gint64 upload_id, const gchar *doc_id, const gchar *password)
+  {
+    DocumentUpload *upload = GetDocumentUpload(upload_id);
+    if (!upload || !doc_id || progressiveDocuments.count(upload_id))
+      return nullptr;
+
+    ProgressiveDocument *document = new ProgressiveDocument(upload_id, upload, doc_id, password);
+    progressiveDocuments[upload_id] = document;
+    return document;
+  }
+
+  ProgressiveDocument *FindProgressiveDocument(gint64 upload_id)
+  {
+    auto it = progressiveDocuments.find(upload_id);
+    return it != progressiveDocuments.end() ? it->second : nullptr;
+  }
+
+  bool CloseProgressiveDocument(const gchar *doc_id)
+  {
+    if (!doc_id)
+      return false;
+
+    for (auto it = progressiveDocuments.begin(); it != progressiveDocuments.end(); ++it)
+    {
+      if (g_strcmp0(it->second->documentID(), doc_id) == 0)
+      {
+        gint64 upload_id = it->first;
+        delete it->second;
+        progressiveDocuments.erase(it);
+        CancelDocumentUpload(upload_id);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool HasProgressiveDocuments()
+  {
+    return !progressiveDocuments.empty();
+  }
+} // namespace pdfviewer
@@ -0,0 +1,109 @@
+#ifndef PDFVIEWER_PROGRESSIVE_DOCUMENT_H_
+#define PDFVIEWER_PROGRESSIVE_DOCUMENT_H_
+
+#include <glib.h>
+#include <fpdfview.h>
+#include <fpdf_dataavail.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pdfviewer
+{
+  class DocumentUpload;
+
+  // Document opened through FPDFAvail while its bytes are still being
+  // uploaded. PDFium reads the received ranges of the upload buffer, and asks
+  // for the ranges it misses through download hints.
+  //
+  // For a linearized document the first page becomes available after only
+  // the first part of the file arrived; other documents become available once
+  // their cross-reference data is complete.
+  class ProgressiveDocument
+  {
+  public:
+    ProgressiveDocument(gint64 upload_id, DocumentUpload *upload, const gchar *doc_id, const gchar *password);
+    ~ProgressiveDocument();
+
+    ProgressiveDocument(const ProgressiveDocument &) = delete;
+    ProgressiveDocument &operator=(const ProgressiveDocument &) = delete;
+
+    gint64 uploadID() const { return upload_id_; }
+    const gchar *documentID() const { return document_id_.c_str(); }
+    const gchar *password() const { return password_.c_str(); }
+    gsize fileSize() const { return file_access_.m_FileLen; }
+    // File access reading the received bytes of the upload
+    FPDF_FILEACCESS *fileAccess() { return &file_access_; }
+
+    // PDF_LINEARIZED, PDF_NOT_LINEARIZED or PDF_LINEARIZATION_UNKNOWN until
+    // the start of the file arrived
+    int IsLinearized();
+    // Whether the document structure is available to open the document
+    bool IsDocumentAvailable();
+    // Opens the document once available, the handle must be closed before the
+    // progressive document is destroyed
+    FPDF_DOCUMENT LoadDocument();
+
+    // Whether the data of the page is available, can be called from any
+    // render handler once the document is open
+    bool IsPageAvailable(int index);
+    // Checks the pages that were not available yet and returns the zero based
+    // indexes of the pages that became available
+    std::vector<int> UpdatePageAvailability(int page_count);
+
+    // Whether the linearization was already reported to Dart
+    bool linearizationReported() const { return linearization_reported_; }
+    void SetLinearizationReported() { linearization_reported_ = true; }
+
+    // Whether the byte ranges PDFium asks for are recorded, only when Dart
+    // can read ranges out of order. Off by default.
+    void SetRangeRequestsEnabled(bool enabled) { range_requests_enabled_ = enabled; }
+    // Byte ranges, as offset and size, PDFium asked for since the last call
+    std::vector<std::pair<gsize, gsize>> TakeRequestedRanges();
+
+  private:
+    struct FileAvail : FX_FILEAVAIL
+    {
+      ProgressiveDocument *document;
+    };
+
+    struct DownloadHints : FX_DOWNLOADHINTS
+    {
+      ProgressiveDocument *document;
+      // Hints of pages checked ahead of the next needed page are dropped
+      bool record;
+    };
+
+    static FPDF_BOOL IsDataAvail(FX_FILEAVAIL *file_avail, size_t offset, size_t size);
+    static void AddSegment(FX_DOWNLOADHINTS *hints, size_t offset, size_t size);
+    static int GetBlock(void *param, unsigned long position, unsigned char *buffer, unsigned long size);
+
+    gint64 upload_id_;
+    DocumentUpload *upload_;
+    std::string document_id_;
+    std::string password_;
+    FileAvail file_avail_;
+    FPDF_FILEACCESS file_access_;
+    DownloadHints hints_;
+    FPDF_AVAIL avail_;
+    std::vector<bool> available_pages_;
+    bool linearization_reported_;
+    bool range_requests_enabled_;
+    std::vector<std::pair<gsize, gsize>> requested_ranges_;
+  };
+
+  // Starts opening a document from an upload whose bytes are still arriving.
+  // The progressive document stays registered until CloseProgressiveDocument.
+  ProgressiveDocument *BeginProgressiveDocument(gint64 upload_id, const gchar *doc_id, const gchar *password);
+  // Returns the progressive document reading from the upload, or null
+  ProgressiveDocument *FindProgressiveDocument(gint64 upload_id);
+  // Destroys the progressive document of the document and its upload. Must be
+  // called after the PDFium document opened from it is closed. Returns false
+  // when the document was not opened progressively.
+  bool CloseProgressiveDocument(const gchar *doc_id);
+  // Whether any progressive document is open, they need the PDFium library
+  bool HasProgressiveDocuments();
+} // namespace pdfviewer
+
+#endif
@@ -0,0 +1,755 @@
+#include "render_farm.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <fpdfview.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <set>
+
+#include "render_worker.h"
+
+namespace pdfviewer
+{
+  // Upper bound of the helper processes
+  static const int kMaximumHelperCount = 64;
+  // Longest password sent to the helpers, longer ones render on the worker
+  static const gsize kMaximumPasswordLength = 4096;
+  // Interval in milliseconds at which a waiting job checks its token
+  static const int kCancelPollInterval = 10;
+
+  // The cancellation flag is shared with the helpers through memory
+  static_assert(ATOMIC_BOOL_LOCK_FREE == 2, "RenderToken must be lock-free to be shared between processes");
+
+  enum class HelperCommand : guint32
+  {
+    kOpenDocument,
+    kCloseDocument,
+    kRender,
+  };
+
+  // Fixed part of a message to a helper. The password of kOpenDocument
+  // follows it, the document or output memfd travels as SCM_RIGHTS.
+  struct HelperRequest
+  {
+    HelperCommand command;
+    guint32 document;
+    // Size of the document, kOpenDocument only
+    guint64 size;
+    // Size of the output buffer sent with a kRender, 0 to keep the last one
+    guint64 output_capacity;
+    gint32 kind;
+    gint32 page_index;
+    gint32 width;
+    gint32 height;
+    gint32 flags;
+    double x;
+    double y;
+    double scale;
+  };
+
+  // Reply to kOpenDocument and kRender, a FarmRenderStatus
+  struct HelperReply
+  {
+    gint32 status;
+  };
+
+  // Sends one message with an optional file descriptor
+  static bool SendMessage(int socket, const void *header, gsize header_size, const std::string &payload, int fd)
+  {
+    struct iovec parts[2];
+    parts[0].iov_base = const_cast<void *>(header);
+    parts[0].iov_len = header_size;
+    parts[1].iov_base = const_cast<char *>(payload.data());
+    parts[1].iov_len = payload.size();
+
+    struct msghdr message = {};
+    message.msg_iov = parts;
+    message.msg_iovlen = payload.empty() ? 1 : 2;
+
+    char control[CMSG_SPACE(sizeof(int))] = {};
+    if (fd >= 0)
+    {
+      message.msg_control = control;
+      message.msg_controllen = sizeof(control);
+      struct cmsghdr *rights = CMSG_FIRSTHDR(&message);
+      rights->cmsg_level = SOL_SOCKET;
+      rights->cmsg_type = SCM_RIGHTS;
+      rights->cmsg_len = CMSG_LEN(sizeof(int));
+      memcpy(CMSG_DATA(rights), &fd, sizeof(int));
+    }
+
+    ssize_t sent;
+    do
+    {
+      sent = sendmsg(socket, &message, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    return sent == static_cast<ssize_t>(header_size + payload.size());
+  }
+
+  // Receives one message and the file descriptor sent with it, if any.
+  // Returns the message size, 0 once the peer closed the socket.
+  static ssize_t ReceiveMessage(int socket, void *buffer, gsize size, int *fd)
+  {
+    struct iovec part;
+    part.iov_base = buffer;
+    part.iov_len = size;
+
+    char control[CMSG_SPACE(sizeof(int))] = {};
+    struct msghdr message = {};
+    message.msg_iov = &part;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t received;
+    do
+    {
+      received = recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+    } while (received < 0 && errno == EINTR);
+
+    *fd = -1;
+    for (struct cmsghdr *header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header))
+    {
+      if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS)
+        memcpy(fd, CMSG_DATA(header), sizeof(int));
+    }
+    return received;
+  }
+
+  // Closes the descriptors inherited from the parent except the socket, so
+  // that a helper never keeps the socket of another helper open
+  static void CloseInheritedFiles(int socket)
+  {
+#ifdef SYS_close_range
+    if (syscall(SYS_close_range, 3, socket - 1, 0) == 0 &&
+        syscall(SYS_close_range, socket + 1, ~0U, 0) == 0)
+      return;
+#endif
+    long maximum = sysconf(_SC_OPEN_MAX);
+    for (int fd = 3; fd < maximum; ++fd)
+    {
+      if (fd != socket)
+        close(fd);
+    }
+  }
+
+  // Document opened in a helper
+  struct HelperDocument
+  {
+    void *data;
+    gsize size;
+    FPDF_DOCUMENT document;
+  };
+
+  // Main loop of a helper process. It was forked without exec from a
+  // multithreaded process, so only the forking thread exists and it runs on
+  // a copy of the parent's heap, PDFium's state included. glibc resets its
+  // allocator locks across fork, so the standard containers below are safe,
+  // but nothing here may take another lock one of the parent's threads could
+  // have held, such as those of GLib's main context.
+  [[noreturn]] static void RunHelperProcess(int socket, RenderToken *control)
+  {
+    // In cooperative mode the fork happens in a job on the main loop, whose
+    // slice would otherwise make the renders below iterate the copied loop
+    RenderWorker::ResetThreadStateAfterFork();
+    CloseInheritedFiles(socket);
+    // A no-op: the fork copied the parent's initialized PDFium, every
+    // document the parent had open included
+    FPDF_InitLibraryWithConfig(nullptr);
+
+    std::unordered_map<guint32, HelperDocument> documents;
+    guint8 *output = nullptr;
+    gsize outputCapacity = 0;
+    std::vector<char> buffer(sizeof(HelperRequest) + kMaximumPasswordLength);
+
+    while (true)
+    {
+      int fd = -1;
+      ssize_t received = ReceiveMessage(socket, buffer.data(), buffer.size(), &fd);
+      if (received < static_cast<ssize_t>(sizeof(HelperRequest)))
+        _exit(0);
+
+      HelperRequest request;
+      memcpy(&request, buffer.data(), sizeof(request));
+      HelperReply reply = {static_cast<gint32>(FarmRenderStatus::kFailed)};
+
+      if (request.command == HelperCommand::kOpenDocument)
+      {
+        std::string password(buffer.data() + sizeof(request), received - sizeof(request));
+        void *data = fd >= 0 ? mmap(nullptr, request.size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        if (fd >= 0)
+          close(fd);
+        if (data != MAP_FAILED)
+        {
+          FPDF_DOCUMENT document = FPDF_LoadMemDocument64(data, request.size, password.c_str());
+          if (document)
+          {
+            documents[request.document] = HelperDocument{data, static_cast<gsize>(request.size), document};
+            reply.status = static_cast<gint32>(FarmRenderStatus::kDone);
+          }
+          else
+          {
+            munmap(data, request.size);
+          }
+        }
+      }
+      else if (request.command == HelperCommand::kCloseDocument)
+      {
+        auto it = documents.find(request.document);
+        if (it != documents.end())
+        {
+          FPDF_CloseDocument(it->second.document);
+          munmap(it->second.data, it->second.size);
+          documents.erase(it);
+        }
+        if (fd >= 0)
+          close(fd);
+        continue;
+      }
+      else if (request.command == HelperCommand::kRender)
+      {
+        if (fd >= 0)
+        {
+          if (output)
+            munmap(output, outputCapacity);
+          void *mapping = mmap(nullptr, request.output_capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+          output = mapping != MAP_FAILED ? static_cast<guint8 *>(mapping) : nullptr;
+          outputCapacity = output ? request.output_capacity : 0;
+          close(fd);
+        }
+
+        auto it = documents.find(request.document);
+        gsize size = static_cast<gsize>(request.width) * request.height * 4;
+        FPDF_PAGE page = it != documents.end() ? FPDF_LoadPage(it->second.document, request.page_index) : nullptr;
+        if (!page)
+        {
+          reply.status = static_cast<gint32>(FarmRenderStatus::kPageNotFound);
+        }
+        else if (output && size > 0 && size <= outputCapacity)
+        {
+          // Same placement as the in-process page and tile renders
+          int startX = 0;
+          int startY = 0;
+          int sizeX = request.width;
+          int sizeY = request.height;
+          if (request.kind == static_cast<gint32>(FarmRenderKind::kTile))
+          {
+            GetTilePlacement(page, request.x, request.y, request.scale, &startX, &startY, &sizeX, &sizeY);
+          }
+
+          FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(request.width, request.height, FPDFBitmap_BGRx, output,
+                                                   request.width * 4);
+          if (bitmap)
+          {
+            FPDFBitmap_FillRect(bitmap, 0, 0, request.width, request.height, 0xFFFFFFFF);
+            RenderStatus status = RenderPageProgressive(bitmap, page, startX, startY, sizeX, sizeY,
+                                                        request.flags, control);
+            FPDFBitmap_Destroy(bitmap);
+            if (status == RenderStatus::kDone)
+              reply.status = static_cast<gint32>(FarmRenderStatus::kDone);
+            else if (status == RenderStatus::kCancelled)
+              reply.status = static_cast<gint32>(FarmRenderStatus::kCancelled);
+          }
+        }
+        if (page)
+          FPDF_ClosePage(page);
+      }
+      else if (fd >= 0)
+      {
+        close(fd);
+      }
+
+      if (!SendMessage(socket, &reply, sizeof(reply), std::string(), -1))
+        _exit(0);
+    }
+  }
+
+  // Parent side of a helper process
+  class RenderFarm::Helper
+  {
+  public:
+    // Forks a helper, returns null when the process could not be started
+    static Helper *Spawn()
+    {
+      // The token lives in memory shared with the helper, which polls it
+      // while rendering exactly like the render worker polls its own tokens
+      void *control = mmap(nullptr, sizeof(RenderToken), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+      if (control == MAP_FAILED)
+        return nullptr;
+
+      int sockets[2];
+      if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != 0)
+      {
+        munmap(control, sizeof(RenderToken));
+        return nullptr;
+      }
+
+      pid_t parent = getpid();
+      pid_t pid = fork();
+      if (pid == 0)
+      {
+        // Helpers must not outlive the application. The signal follows the
+        // forking thread, the render worker, which lives as long as the plugin.
+        prctl(PR_SET_PDEATHSIG, SIGKILL);
+        if (getppid() != parent)
+          _exit(0);
+        close(sockets[0]);
+        RunHelperProcess(sockets[1], static_cast<RenderToken *>(control));
+      }
+
+      close(sockets[1]);
+      if (pid < 0)
+      {
+        close(sockets[0]);
+        munmap(control, sizeof(RenderToken));
+        return nullptr;
+      }
+      return new Helper(pid, sockets[0], static_cast<RenderToken *>(control));
+    }
+
+    ~Helper()
+    {
+      close(socket_);
+      kill(pid_, SIGKILL);
+      waitpid(pid_, nullptr, 0);
+      if (output_)
+        munmap(output_, output_capacity_);
+      munmap(control_, sizeof(RenderToken));
+    }
+
+    Helper(const Helper &) = delete;
+    Helper &operator=(const Helper &) = delete;
+
+    // False once the helper stopped answering, it takes no more jobs.
+    // Only used by the helper's driver thread.
+    bool alive() const { return alive_; }
+
+    bool HasDocument(guint32 handle) const { return open_documents_.count(handle) != 0; }
+
+    // Ends the connection from any thread. A driver thread waiting for a
+    // reply wakes up at once and finds the helper gone, the process itself
+    // keeps running until the helper is destroyed.
+    void Shutdown() { shutdown(socket_, SHUT_RDWR); }
+
+    // Opens the document in the helper from a read-only descriptor
+    bool OpenDocument(guint32 handle, int fd, gsize size, const std::string &password)
+    {
+      HelperRequest request = {};
+      request.command = HelperCommand::kOpenDocument;
+      request.document = handle;
+      request.size = size;
+      HelperReply reply;
+      if (!Send(request, password, fd) || !Receive(&reply, nullptr))
+        return false;
+      if (reply.status != static_cast<gint32>(FarmRenderStatus::kDone))
+        return false;
+      open_documents_.insert(handle);
+      return true;
+    }
+
+    void CloseDocument(guint32 handle)
+    {
+      if (open_documents_.erase(handle) == 0)
+        return;
+      HelperRequest request = {};
+      request.command = HelperCommand::kCloseDocument;
+      request.document = handle;
+      Send(request, std::string(), -1);
+    }
+
+    // Renders the job into the output buffer and points |pixels| at it
+    FarmRenderStatus Render(const FarmRenderJob &job, guint32 handle, const RenderToken *token,
+                            const guint8 **pixels)
+    {
+      HelperRequest request = {};
+      request.command = HelperCommand::kRender;
+      request.document = handle;
+      request.kind = static_cast<gint32>(job.kind);
+      request.page_index = job.page_index;
+      request.width = job.width;
+      request.height = job.height;
+      request.flags = job.flags;
+      request.x = job.x;
+      request.y = job.y;
+      request.scale = job.scale;
+
+      gsize size = static_cast<gsize>(job.width) * job.height * 4;
+      int fd = -1;
+      if (size > output_capacity_)
+      {
+        fd = GrowOutput(size);
+        if (fd < 0)
+          return FarmRenderStatus::kUnavailable;
+        request.output_capacity = output_capacity_;
+      }
+
+      // A fresh token for every job, the helper is idle until it receives it
+      new (control_) RenderToken();
+      HelperReply reply;
+      bool sent = Send(request, std::string(), fd);
+      if (fd >= 0)
+        close(fd);
+      if (!sent || !Receive(&reply, token))
+        return FarmRenderStatus::kUnavailable;
+
+      *pixels = output_;
+      return static_cast<FarmRenderStatus>(reply.status);
+    }
+
+  private:
+    Helper(pid_t pid, int socket, RenderToken *control)
+        : pid_(pid), socket_(socket), control_(control), output_(nullptr), output_capacity_(0), alive_(true) {}
+
+    bool Send(const HelperRequest &request, const std::string &payload, int fd)
+    {
+      if (alive_ && !SendMessage(socket_, &request, sizeof(request), payload, fd))
+        alive_ = false;
+      return alive_;
+    }
+
+    // Waits for the reply, forwarding a cancellation of the token to the helper
+    bool Receive(HelperReply *reply, const RenderToken *token)
+    {
+      while (alive_)
+      {
+        struct pollfd ready = {socket_, POLLIN, 0};
+        int count = poll(&ready, 1, kCancelPollInterval);
+        if (count < 0 && errno != EINTR)
+        {
+          alive_ = false;
+        }
+        else if (count > 0)
+        {
+          int fd = -1;
+          ssize_t received = ReceiveMessage(socket_, reply, sizeof(*reply), &fd);
+          if (fd >= 0)
+            close(fd);
+          if (received == sizeof(*reply))
+            return true;
+          alive_ = false;
+        }
+        else if (token && token->IsCancelled())
+        {
+          control_->Cancel();
+        }
+      }
+      return false;
+    }
+
+    // Replaces the output buffer with a memfd of at least |size| bytes and
+    // returns its descriptor for the helper to map
+    int GrowOutput(gsize size)
+    {
+      if (output_)
+        munmap(output_, output_capacity_);
+      output_ = nullptr;
+      output_capacity_ = 0;
+
+      gsize pageSize = static_cast<gsize>(sysconf(_SC_PAGESIZE));
+      gsize capacity = (size + pageSize - 1) / pageSize * pageSize;
+      int fd = memfd_create("pdfviewer-render-output", MFD_CLOEXEC);
+      if (fd < 0)
+        return -1;
+      void *mapping = ftruncate(fd, capacity) == 0 ? mmap(nullptr, capacity, PROT_READ, MAP_SHARED, fd, 0)
+                                                   : MAP_FAILED;
+      if (mapping == MAP_FAILED)
+      {
+        close(fd);
+        return -1;
+      }
+      output_ = static_cast<guint8 *>(mapping);
+      output_capacity_ = capacity;
+      return fd;
+    }
+
+    pid_t pid_;
+    int socket_;
+    RenderToken *control_;
+    guint8 *output_;
+    gsize output_capacity_;
+    bool alive_;
+    std::set<guint32> open_documents_;
+  };
+
+  RenderFarm &RenderFarm::Shared()
+  {
+    static RenderFarm farm;
+    return farm;
+  }
+
+  RenderFarm::RenderFarm() : stopping_(false), live_helpers_(0), next_document_handle_(1) {}
+
+  RenderFarm::~RenderFarm()
+  {
+    Stop();
+    for (auto &entry : documents_)
+    {
+      if (entry.second.data)
+        g_bytes_unref(entry.second.data);
+      if (entry.second.fd >= 0)
+        close(entry.second.fd);
+    }
+  }
+
+  int RenderFarm::Start(int process_count)
+  {
+    Stop();
+
+    process_count = std::min(process_count, kMaximumHelperCount);
+    std::vector<std::unique_ptr<Helper>> helpers;
+    for (int i = 0; i < process_count; ++i)
+    {
+      Helper *helper = Helper::Spawn();
+      if (!helper)
+        break;
+      helpers.emplace_back(helper);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    helpers_ = std::move(helpers);
+    live_helpers_ = static_cast<int>(helpers_.size());
+    for (auto &helper : helpers_)
+    {
+      threads_.emplace_back(&RenderFarm::RunHelper, this, helper.get());
+    }
+    return static_cast<int>(helpers_.size());
+  }
+
+  void RenderFarm::Stop()
+  {
+    std::vector<std::thread> threads;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+      threads.swap(threads_);
+      // Drivers busy with a render would otherwise hold the join, and the
+      // plugin's dispose with it, until the helper finishes
+      for (std::unique_ptr<Helper> &helper : helpers_)
+        helper->Shutdown();
+    }
+    condition_.notify_all();
+    for (std::thread &thread : threads)
+      thread.join();
+
+    std::deque<Job> jobs;
+    std::vector<std::unique_ptr<Helper>> helpers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs.swap(jobs_);
+      helpers.swap(helpers_);
+      live_helpers_ = 0;
+      closed_documents_.clear();
+      stopping_ = false;
+    }
+    helpers.clear();
+    for (Job &job : jobs)
+      job.callback(FarmRenderStatus::kUnavailable, nullptr, 0);
+  }
+
+  bool RenderFarm::IsRunning()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return live_helpers_ > 0 && !stopping_;
+  }
+
+  void RenderFarm::AddDocument(const gchar *document_id, GBytes *data, const gchar *file_path,
+                               const gchar *password)
+  {
+    if (!document_id || (!data && !file_path))
+      return;
+
+    RemoveDocument(document_id);
+    std::lock_guard<std::mutex> lock(mutex_);
+    Document document;
+    document.handle = next_document_handle_++;
+    document.data = data ? g_bytes_ref(data) : nullptr;
+    document.file_path = file_path ? file_path : "";
+    document.password = password ? password : "";
+    document.fd = -1;
+    document.size = 0;
+    documents_[document_id] = document;
+  }
+
+  void RenderFarm::RemoveDocument(const gchar *document_id)
+  {
+    if (!document_id)
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = documents_.find(document_id);
+      if (it == documents_.end())
+        return;
+
+      for (auto &helper : helpers_)
+        closed_documents_[helper.get()].push_back(it->second.handle);
+      if (it->second.data)
+        g_bytes_unref(it->second.data);
+      if (it->second.fd >= 0)
+        close(it->second.fd);
+      documents_.erase(it);
+    }
+    condition_.notify_all();
+  }
+
+  bool RenderFarm::Submit(const FarmRenderJob &job, std::shared_ptr<RenderToken> token, FarmRenderCallback callback)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = documents_.find(job.document_id);
+      if (live_helpers_ == 0 || stopping_ || it == documents_.end() ||
+          it->second.password.size() > kMaximumPasswordLength)
+        return false;
+
+      jobs_.push_back(Job{job, it->second.handle, std::move(token), std::move(callback)});
+    }
+    condition_.notify_one();
+    return true;
+  }
+
+  // Prepares the descriptor the helpers map the document from. Documents in
+  // memory are copied once into a sealed memfd, files are opened read-only.
+  bool RenderFarm::OpenDocumentSource(Document *document)
+  {
+    if (document->fd >= 0)
+      return true;
+
+    if (document->data)
+    {
+      gsize size = 0;
+      const guint8 *bytes = static_cast<const guint8 *>(g_bytes_get_data(document->data, &size));
+      int fd = memfd_create("pdfviewer-document", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+      if (fd < 0)
+        return false;
+      gsize written = 0;
+      while (written < size)
+      {
+        ssize_t count = write(fd, bytes + written, size - written);
+        if (count < 0 && errno == EINTR)
+          continue;
+        if (count <= 0)
+          break;
+        written += count;
+      }
+      if (written != size)
+      {
+        close(fd);
+        return false;
+      }
+      fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+      document->fd = fd;
+      document->size = size;
+      return true;
+    }
+
+    int fd = open(document->file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+      if (fd >= 0)
+        close(fd);
+      return false;
+    }
+    document->fd = fd;
+    document->size = static_cast<gsize>(info.st_size);
+    return true;
+  }
+
+  RenderFarm::Document *RenderFarm::FindDocument(guint32 handle)
+  {
+    for (auto &entry : documents_)
+    {
+      if (entry.second.handle == handle)
+        return &entry.second;
+    }
+    return nullptr;
+  }
+
+  // Driver thread of a helper, feeds it one job at a time and waits for the
+  // result, so that every helper renders in parallel with the others
+  void RenderFarm::RunHelper(Helper *helper)
+  {
+    while (true)
+    {
+      Job job;
+      std::vector<guint32> closed;
+      int fd = -1;
+      gsize size = 0;
+      std::string password;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this, helper]
+                        { return stopping_ || !jobs_.empty() || !closed_documents_[helper].empty(); });
+        if (stopping_)
+          return;
+        closed.swap(closed_documents_[helper]);
+        if (!jobs_.empty())
+        {
+          job = std::move(jobs_.front());
+          jobs_.pop_front();
+
+          // The descriptor is duplicated, the document may be removed while
+          // the helper opens it
+          Document *document = helper->HasDocument(job.document_handle) ? nullptr : FindDocument(job.document_handle);
+          if (document && OpenDocumentSource(document))
+          {
+            fd = dup(document->fd);
+            size = document->size;
+            password = document->password;
+          }
+        }
+      }
+
+      for (guint32 handle : closed)
+        helper->CloseDocument(handle);
+      if (!job.callback)
+        continue;
+
+      FarmRenderStatus status = FarmRenderStatus::kUnavailable;
+      const guint8 *pixels = nullptr;
+      if (job.token && job.token->IsCancelled())
+      {
+        status = FarmRenderStatus::kCancelled;
+      }
+      else if (helper->HasDocument(job.document_handle) ||
+               (fd >= 0 && helper->OpenDocument(job.document_handle, fd, size, password)))
+      {
+        status = helper->Render(job.render, job.document_handle, job.token.get(), &pixels);
+      }
+      if (fd >= 0)
+        close(fd);
+
+      gsize pixelsSize = static_cast<gsize>(job.render.width) * job.render.height * 4;
+      job.callback(status, status == FarmRenderStatus::kDone ? pixels : nullptr,
+                   status == FarmRenderStatus::kDone ? pixelsSize : 0);
+
+      if (!helper->alive())
+      {
+        // The helper crashed, the remaining helpers carry on. Without any
+        // left, the queued jobs go back to the render worker.
+        std::deque<Job> orphans;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (--live_helpers_ == 0)
+            orphans.swap(jobs_);
+        }
+        for (Job &orphan : orphans)
+          orphan.callback(FarmRenderStatus::kUnavailable, nullptr, 0);
+        return;
+      }
+    }
+  }
+} // namespace pdfviewer
@@ -0,0 +1,149 @@
+#ifndef PDFVIEWER_RENDER_FARM_H_
+#define PDFVIEWER_RENDER_FARM_H_
+
+#include <glib.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "render_request.h"
+
+namespace pdfviewer
+{
+  // Kind of image a farm job renders
+  enum class FarmRenderKind
+  {
+    // The whole page scaled to the width and height
+    kPage,
+    // The region at x, y of the page scaled by scale, of the width and height
+    kTile,
+  };
+
+  // Page or tile render to run in a helper process
+  struct FarmRenderJob
+  {
+    std::string document_id;
+    FarmRenderKind kind;
+    int page_index;
+    int width;
+    int height;
+    double x;
+    double y;
+    double scale;
+    int flags;
+  };
+
+  // Result of a farm job
+  enum class FarmRenderStatus
+  {
+    kDone,
+    kCancelled,
+    kFailed,
+    kPageNotFound,
+    // The helper could not take the job, it has to run on the render worker
+    kUnavailable,
+  };
+
+  // Receives the result of a farm job on the thread that drove it. The pixels
+  // are tightly packed RGBA rows, only valid during the call and only given
+  // when the status is kDone.
+  typedef std::function<void(FarmRenderStatus status, const guint8 *pixels, gsize size)> FarmRenderCallback;
+
+  // Pool of helper processes forked from this one, rendering pages and tiles
+  // in parallel.
+  //
+  // PDFium is not thread-safe, so the render worker can only use one core.
+  // The helpers are forked without exec: each starts from a copy of this
+  // process, PDFium state and every document open at the time included, and
+  // opens the documents it renders again from read-only descriptors. Each
+  // job renders into a memfd shared with its helper, so the pixels reach
+  // this process without going through the socket.
+  //
+  // Jobs are submitted from render worker jobs, after the page image cache,
+  // so they follow the priority classes of the worker. Tiles rendered here
+  // are neither kept in the tile cache nor build the coarser pyramid levels,
+  // and the memory the helpers hold is not charged to the memory budget.
+  class RenderFarm
+  {
+  public:
+    // Returns the farm shared by all documents
+    static RenderFarm &Shared();
+
+    ~RenderFarm();
+
+    RenderFarm(const RenderFarm &) = delete;
+    RenderFarm &operator=(const RenderFarm &) = delete;
+
+    // Replaces the helpers with |process_count| new ones, 0 stops the farm.
+    // Must be called from a render worker job: the helpers are forked while
+    // no other PDFium call is in progress, which holds in cooperative mode too
+    // where the job runs on the main loop, as jobs never overlap there either.
+    // Returns the number of helpers that started.
+    int Start(int process_count);
+    // Stops the helpers, queued jobs complete as kUnavailable
+    void Stop();
+    bool IsRunning();
+
+    // Makes a document available to the helpers. Documents loaded from memory
+    // are copied into a memfd when a helper first opens them, files are
+    // reopened read-only by path.
+    void AddDocument(const gchar *document_id, GBytes *data, const gchar *file_path, const gchar *password);
+    // Closes the document in the helpers
+    void RemoveDocument(const gchar *document_id);
+
+    // Queues a render on the next free helper. Returns false, without calling
+    // the callback, when the farm is stopped or the document was not added.
+    bool Submit(const FarmRenderJob &job, std::shared_ptr<RenderToken> token, FarmRenderCallback callback);
+
+  private:
+    class Helper;
+
+    // Document the helpers can open
+    struct Document
+    {
+      guint32 handle;
+      GBytes *data;
+      std::string file_path;
+      std::string password;
+      // Read-only source passed to the helpers, opened on first use
+      int fd;
+      gsize size;
+    };
+
+    struct Job
+    {
+      FarmRenderJob render;
+      guint32 document_handle;
+      std::shared_ptr<RenderToken> token;
+      FarmRenderCallback callback;
+    };
+
+    RenderFarm();
+
+    void RunHelper(Helper *helper);
+    bool OpenDocumentSource(Document *document);
+    Document *FindDocument(guint32 handle);
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_;
+    std::deque<Job> jobs_;
+    std::vector<std::unique_ptr<Helper>> helpers_;
+    std::vector<std::thread> threads_;
+    // Helpers whose process still answers
+    int live_helpers_;
+    std::unordered_map<std::string, Document> documents_;
+    // Handles of the removed documents each helper still has to close
+    std::unordered_map<Helper *, std::vector<guint32>> closed_documents_;
+    guint32 next_document_handle_;
+  };
+} // namespace pdfviewer
+
+#endif
@@ -0,0 +1,131 @@
+#include "render_request.h"
+
+#include <fpdf_progressive.h>
+
+#include <cmath>
+
+#include "memory_budget.h"
+#include "render_stats.h"
+#include "render_worker.h"
+
+namespace pdfviewer
+{
+  std::shared_ptr<RenderToken> RenderRequestRegistry::Begin(gint64 request_id, const std::string &target)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto latest = latest_requests_.find(target);
+    if (latest != latest_requests_.end())
+    {
+      auto previous = requests_.find(latest->second);
+      if (previous != requests_.end())
+      {
+        previous->second.token->Cancel();
+      }
+    }
+
+    std::shared_ptr<RenderToken> token = std::make_shared<RenderToken>();
+    requests_[request_id] = Entry{target, token};
+    latest_requests_[target] = request_id;
+    return token;
+  }
+
+  void RenderRequestRegistry::End(gint64 request_id)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = requests_.find(request_id);
+    if (it == requests_.end())
+      return;
+
+    auto latest = latest_requests_.find(it->second.target);
+    if (latest != latest_requests_.end() && latest->second == request_id)
+    {
+      latest_requests_.erase(latest);
+    }
+    requests_.erase(it);
+  }
+
+  gboolean RenderRequestRegistry::Cancel(gint64 request_id)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = requests_.find(request_id);
+    if (it == requests_.end())
+      return FALSE;
+
+    it->second.token->Cancel();
+    return TRUE;
+  }
+
+  bool IsRenderQuality(gint64 value)
+  {
+    return value >= static_cast<gint64>(RenderQuality::kFull) && value <= static_cast<gint64>(RenderQuality::kDraft);
+  }
+
+  int GetQualityRenderFlags(int flags, RenderQuality quality)
+  {
+    if (quality == RenderQuality::kFull)
+      return flags;
+    return (flags & ~FPDF_LCD_TEXT) | FPDF_RENDER_NO_SMOOTHTEXT | FPDF_RENDER_NO_SMOOTHIMAGE | FPDF_RENDER_NO_SMOOTHPATH;
+  }
+
+  // Whether the render should stop at the next pause point
+  static bool ShouldStop(const RenderToken *token)
+  {
+    return (token && token->IsCancelled()) || RenderWorker::IsPreempted();
+  }
+
+  // IFSDK_PAUSE callback, asks PDFium to pause once the request is cancelled
+  // or preempted, or the slice of a render on the main loop is used up
+  static FPDF_BOOL NeedToPauseNow(IFSDK_PAUSE *pause)
+  {
+    return ShouldStop(static_cast<const RenderToken *>(pause->user)) || RenderWorker::IsSliceUsedUp();
+  }
+
+  RenderStatus RenderPageProgressive(FPDF_BITMAP bitmap, FPDF_PAGE page, int start_x, int start_y,
+                                     int size_x, int size_y, int flags, const RenderToken *token,
+                                     const gchar *document_id)
+  {
+    ScopedPhaseTimer timer(document_id, RenderPhase::kRasterize);
+    IFSDK_PAUSE pause = {};
+    pause.version = 1;
+    pause.NeedToPauseNow = NeedToPauseNow;
+    pause.user = const_cast<RenderToken *>(token);
+    flags = MemoryBudget::Shared().AdjustRenderFlags(flags);
+
+    int status = FPDF_RenderPageBitmap_Start(bitmap, page, start_x, start_y, size_x, size_y, 0, flags, &pause);
+    while (status == FPDF_RENDER_TOBECONTINUED && !ShouldStop(token))
+    {
+      RenderWorker::YieldSlice();
+      status = FPDF_RenderPage_Continue(page, &pause);
+    }
+    FPDF_RenderPage_Close(page);
+
+    RenderStats &stats = RenderStats::Shared();
+    if (token && token->IsCancelled())
+    {
+      timer.SetPhase(RenderPhase::kAbandonedRasterize);
+      stats.Count(document_id, RenderCounter::kRendersCancelled);
+      return RenderStatus::kCancelled;
+    }
+    if (status == FPDF_RENDER_TOBECONTINUED)
+    {
+      timer.SetPhase(RenderPhase::kAbandonedRasterize);
+      stats.Count(document_id, RenderCounter::kRendersPreempted);
+      return RenderStatus::kPreempted;
+    }
+    if (status != FPDF_RENDER_DONE)
+    {
+      stats.Count(document_id, RenderCounter::kRendersFailed);
+      return RenderStatus::kFailed;
+    }
+    return RenderStatus::kDone;
+  }
+
+  void GetTilePlacement(FPDF_PAGE page, double x, double y, double scale, int *start_x, int *start_y, int *size_x,
+                        int *size_y)
+  {
+    *start_x = -static_cast<int>(std::floor(x * scale));
+    *start_y = -static_cast<int>(std::floor(y * scale));
+    *size_x = static_cast<int>(std::ceil(FPDF_GetPageWidthF(page) * scale));
+    *size_y = static_cast<int>(std::ceil(FPDF_GetPageHeightF(page) * scale));
+  }
+} // namespace pdfviewer
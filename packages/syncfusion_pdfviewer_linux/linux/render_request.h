@@ -0,0 +1,103 @@
+#ifndef PDFVIEWER_RENDER_REQUEST_H_
+#define PDFVIEWER_RENDER_REQUEST_H_
+
+#include <glib.h>
+#include <fpdfview.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace pdfviewer
+{
+  // Cancellation state of a single render request, shared between the main
+  // thread that cancels it and the render worker that polls it.
+  class RenderToken
+  {
+  public:
+    RenderToken() : cancelled_(false) {}
+
+    bool IsCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+    void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+  private:
+    std::atomic<bool> cancelled_;
+  };
+
+  // Tracks the render requests that have not completed yet.
+  //
+  // Each request belongs to a target (document, page and kind of render). When
+  // a newer request arrives for the same target, the older one is cancelled as
+  // its result can no longer be displayed.
+  class RenderRequestRegistry
+  {
+  public:
+    // Registers a request and cancels the previous request of the same target
+    std::shared_ptr<RenderToken> Begin(gint64 request_id, const std::string &target);
+    // Removes a completed or dropped request
+    void End(gint64 request_id);
+    // Cancels the request, returns FALSE if it is not pending anymore
+    gboolean Cancel(gint64 request_id);
+
+  private:
+    struct Entry
+    {
+      std::string target;
+      std::shared_ptr<RenderToken> token;
+    };
+
+    std::mutex mutex_;
+    std::unordered_map<gint64, Entry> requests_;
+    std::unordered_map<std::string, gint64> latest_requests_;
+  };
+
+  // Result of a progressive render
+  enum class RenderStatus
+  {
+    kDone,
+    kCancelled,
+    kFailed,
+    // Given up for a more urgent job of the render worker, see
+    // RenderWorker::IsPreempted
+    kPreempted,
+  };
+
+  // Quality of a page or tile render, chosen per request. The values match
+  // the index of PdfRenderQuality on the Dart side.
+  enum class RenderQuality
+  {
+    kFull = 0,
+    // Without anti-aliasing of text, images and paths, for pages passing by
+    // during a fling and replaced once the viewport settles
+    kDraft = 1,
+  };
+
+  // Returns whether the value names a RenderQuality
+  bool IsRenderQuality(gint64 value);
+  // Returns the FPDF_RenderPage flags of a render at the quality
+  int GetQualityRenderFlags(int flags, RenderQuality quality);
+
+  // Renders the page into the bitmap with FPDF_RenderPageBitmap_Start and
+  // FPDF_RenderPage_Continue, stopping as soon as the token is cancelled or,
+  // in a speculative job of the render worker, a more urgent job is queued.
+  // The token may be null, in which case only preemption stops the render.
+  // The decoded image cache is limited while the memory budget asks for it.
+  // In cooperative mode the main loop runs between the slices of the render.
+  // The render time and outcome are recorded for the document, unless null.
+  RenderStatus RenderPageProgressive(FPDF_BITMAP bitmap, FPDF_PAGE page, int start_x, int start_y,
+                                     int size_x, int size_y, int flags, const RenderToken *token,
+                                     const gchar *document_id = nullptr);
+
+  // Places the whole page for a render of the region starting at |x|, |y|
+  // points at the scale: returns the page origin relative to the bitmap and
+  // the page size in pixels to pass to RenderPageProgressive. Both come from
+  // the pixel grid of the page at the scale, the region origin snapped down
+  // to it and the page size rounded up like the grid tiles, so tiles of
+  // adjacent regions place the page alike and meet without seams.
+  void GetTilePlacement(FPDF_PAGE page, double x, double y, double scale, int *start_x, int *start_y, int *size_x,
+                        int *size_y);
+} // namespace pdfviewer
+
+#endif
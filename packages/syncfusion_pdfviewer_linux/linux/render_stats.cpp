@@ -0,0 +1,193 @@
+#include "render_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pdfviewer
+{
+  const gchar *GetRenderPhaseName(RenderPhase phase)
+  {
+    switch (phase)
+    {
+    case RenderPhase::kOpen:
+      return "open";
+    case RenderPhase::kPageLoad:
+      return "pageLoad";
+    case RenderPhase::kRasterize:
+      return "rasterize";
+    case RenderPhase::kAbandonedRasterize:
+      return "abandonedRasterize";
+    case RenderPhase::kFarmRender:
+      return "farmRender";
+    case RenderPhase::kConvert:
+      return "convert";
+    case RenderPhase::kTransfer:
+      return "transfer";
+    default:
+      return "";
+    }
+  }
+
+  const gchar *GetRenderCounterName(RenderCounter counter)
+  {
+    switch (counter)
+    {
+    case RenderCounter::kPageCacheHits:
+      return "pageCacheHits";
+    case RenderCounter::kRendersCancelled:
+      return "rendersCancelled";
+    case RenderCounter::kRendersPreempted:
+      return "rendersPreempted";
+    case RenderCounter::kRendersFailed:
+      return "rendersFailed";
+    default:
+      return "";
+    }
+  }
+
+  // Time yielded to the main loop by the jobs running on this thread
+  static thread_local gint64 yielded_time = 0;
+
+  gint64 GetYieldedTime()
+  {
+    return yielded_time;
+  }
+
+  void AddYieldedTime(gint64 microseconds)
+  {
+    yielded_time += microseconds;
+  }
+
+  // Number of significant bits of the duration, its bucket
+  static int GetBucket(guint64 microseconds)
+  {
+    int bucket = 0;
+    while (microseconds > 0 && bucket < LatencyHistogram::kBucketCount - 1)
+    {
+      microseconds >>= 1;
+      ++bucket;
+    }
+    return bucket;
+  }
+
+  void LatencyHistogram::Record(guint64 microseconds)
+  {
+    ++count;
+    total += microseconds;
+    maximum = std::max(maximum, microseconds);
+    ++buckets[GetBucket(microseconds)];
+  }
+
+  void LatencyHistogram::Merge(const LatencyHistogram &other)
+  {
+    count += other.count;
+    total += other.total;
+    maximum = std::max(maximum, other.maximum);
+    for (int i = 0; i < kBucketCount; ++i)
+      buckets[i] += other.buckets[i];
+  }
+
+  guint64 LatencyHistogram::GetQuantile(double quantile) const
+  {
+    if (count == 0)
+      return 0;
+
+    guint64 rank = static_cast<guint64>(std::ceil(quantile * count));
+    guint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i)
+    {
+      seen += buckets[i];
+      if (seen >= rank && i < kBucketCount - 1)
+        return std::min((G_GUINT64_CONSTANT(1) << i) - 1, maximum);
+    }
+    return maximum;
+  }
+
+  void RenderStatsSnapshot::Merge(const RenderStatsSnapshot &other)
+  {
+    for (int i = 0; i < static_cast<int>(RenderPhase::kCount); ++i)
+      phases[i].Merge(other.phases[i]);
+    for (int i = 0; i < static_cast<int>(RenderCounter::kCount); ++i)
+      counters[i] += other.counters[i];
+  }
+
+  RenderStats &RenderStats::Shared()
+  {
+    static RenderStats stats;
+    return stats;
+  }
+
+  void RenderStats::AddDocument(const gchar *document_id)
+  {
+    if (!document_id)
+      return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    documents_.emplace(document_id, RenderStatsSnapshot{});
+  }
+
+  RenderStatsSnapshot &RenderStats::Find(const gchar *document_id)
+  {
+    auto it = documents_.find(document_id);
+    return it != documents_.end() ? it->second : closed_;
+  }
+
+  void RenderStats::Record(const gchar *document_id, RenderPhase phase, gint64 microseconds)
+  {
+    if (!document_id)
+      return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    RenderStatsSnapshot &stats = Find(document_id);
+    stats.phases[static_cast<int>(phase)].Record(static_cast<guint64>(std::max<gint64>(microseconds, 0)));
+  }
+
+  void RenderStats::Count(const gchar *document_id, RenderCounter counter)
+  {
+    if (!document_id)
+      return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    RenderStatsSnapshot &stats = Find(document_id);
+    ++stats.counters[static_cast<int>(counter)];
+  }
+
+  void RenderStats::RemoveDocument(const gchar *document_id)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = documents_.find(document_id);
+    if (it == documents_.end())
+      return;
+
+    closed_.Merge(it->second);
+    documents_.erase(it);
+  }
+
+  RenderStatsSnapshot RenderStats::Get(const gchar *document_id, bool reset)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RenderStatsSnapshot result{};
+    if (document_id)
+    {
+      auto it = documents_.find(document_id);
+      if (it != documents_.end())
+      {
+        result = it->second;
+        if (reset)
+          it->second = RenderStatsSnapshot{};
+      }
+      return result;
+    }
+
+    result = closed_;
+    for (auto &document : documents_)
+    {
+      result.Merge(document.second);
+      if (reset)
+        document.second = RenderStatsSnapshot{};
+    }
+    if (reset)
+      closed_ = RenderStatsSnapshot{};
+    return result;
+  }
+} // namespace pdfviewer
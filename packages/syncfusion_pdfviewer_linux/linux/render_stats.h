@@ -0,0 +1,155 @@
+#ifndef PDFVIEWER_RENDER_STATS_H_
+#define PDFVIEWER_RENDER_STATS_H_
+
+#include <glib.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace pdfviewer
+{
+  // Timed phases of opening documents and serving renders
+  enum class RenderPhase
+  {
+    // Parsing a document and indexing the geometry of its pages
+    kOpen,
+    // Loading a page missing from the page cache
+    kPageLoad,
+    // Rasterizing a page, tile or thumbnail with PDFium in this process
+    kRasterize,
+    // Rasterizing renders that were cancelled or gave way to more urgent
+    // ones, time spent on pixels that were thrown away
+    kAbandonedRasterize,
+    // Rendering a page or tile in a helper process, round trip included
+    kFarmRender,
+    // Packing the rows of a rendered bitmap into the response
+    kConvert,
+    // Waiting for the main loop and sending a render response to Dart
+    kTransfer,
+    kCount,
+  };
+
+  // Events counted alongside the phases
+  enum class RenderCounter
+  {
+    // Pages found open in the page cache, misses are page loads
+    kPageCacheHits,
+    kRendersCancelled,
+    // Speculative renders given up for more urgent ones
+    kRendersPreempted,
+    kRendersFailed,
+    kCount,
+  };
+
+  // Name of the phase or counter in the stats sent to Dart
+  const gchar *GetRenderPhaseName(RenderPhase phase);
+  const gchar *GetRenderCounterName(RenderCounter counter);
+
+  // Total time the calling thread spent handing the main loop an iteration
+  // from within a job in cooperative mode, in microseconds. The phases timed
+  // on the thread leave it out.
+  gint64 GetYieldedTime();
+  void AddYieldedTime(gint64 microseconds);
+
+  // Latency histogram with logarithmic buckets: bucket 0 counts durations
+  // under a microsecond and bucket i those from 2^(i-1) up to 2^i
+  // microseconds, the last bucket everything longer.
+  struct LatencyHistogram
+  {
+    static const int kBucketCount = 32;
+
+    guint64 count;
+    guint64 total;
+    guint64 maximum;
+    guint64 buckets[kBucketCount];
+
+    void Record(guint64 microseconds);
+    void Merge(const LatencyHistogram &other);
+    // Upper bound in microseconds of the bucket the quantile falls in, capped
+    // at the maximum, 0 when nothing was recorded
+    guint64 GetQuantile(double quantile) const;
+  };
+
+  // Histograms of every phase and counters of every event
+  struct RenderStatsSnapshot
+  {
+    LatencyHistogram phases[static_cast<int>(RenderPhase::kCount)];
+    guint64 counters[static_cast<int>(RenderCounter::kCount)];
+
+    const LatencyHistogram &Get(RenderPhase phase) const { return phases[static_cast<int>(phase)]; }
+    guint64 Get(RenderCounter counter) const { return counters[static_cast<int>(counter)]; }
+    void Merge(const RenderStatsSnapshot &other);
+  };
+
+  // Always-on render instrumentation, per document.
+  //
+  // Recording takes a short lock and a few additions, cheap next to the
+  // renders it measures. Stats of closed documents are folded into the totals
+  // so that a session can be read out at its end, as are the late records of
+  // renders that finish after their document closed.
+  class RenderStats
+  {
+  public:
+    // Returns the stats shared by all documents
+    static RenderStats &Shared();
+
+    RenderStats(const RenderStats &) = delete;
+    RenderStats &operator=(const RenderStats &) = delete;
+
+    // Starts the stats of a document being opened
+    void AddDocument(const gchar *document_id);
+    // Records the duration of a phase, ignored without a document. Documents
+    // not open go to the totals of the closed ones.
+    void Record(const gchar *document_id, RenderPhase phase, gint64 microseconds);
+    // Counts an event, like Record
+    void Count(const gchar *document_id, RenderCounter counter);
+    // Folds the stats of a closed document into the totals
+    void RemoveDocument(const gchar *document_id);
+    // Returns the stats of the document, or of all documents including the
+    // closed ones when null. Reset clears the returned stats.
+    RenderStatsSnapshot Get(const gchar *document_id, bool reset);
+
+  private:
+    RenderStats() : closed_{} {}
+
+    // Stats of the open document, or of the closed ones when not open
+    RenderStatsSnapshot &Find(const gchar *document_id);
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, RenderStatsSnapshot> documents_;
+    // Stats of the documents closed since the last reset
+    RenderStatsSnapshot closed_;
+  };
+
+  // Records the time from its construction to its destruction as a phase of
+  // the document, which must outlive it. Time yielded to the main loop
+  // meanwhile is left out.
+  class ScopedPhaseTimer
+  {
+  public:
+    ScopedPhaseTimer(const gchar *document_id, RenderPhase phase)
+        : document_id_(document_id), phase_(phase), start_(g_get_monotonic_time()), yielded_(GetYieldedTime())
+    {
+    }
+    ~ScopedPhaseTimer()
+    {
+      RenderStats::Shared().Record(document_id_, phase_,
+                                   g_get_monotonic_time() - start_ - (GetYieldedTime() - yielded_));
+    }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer &) = delete;
+    ScopedPhaseTimer &operator=(const ScopedPhaseTimer &) = delete;
+
+    // Records the time as another phase, once the outcome of the work is known
+    void SetPhase(RenderPhase phase) { phase_ = phase; }
+
+  private:
+    const gchar *document_id_;
+    RenderPhase phase_;
+    gint64 start_;
+    gint64 yielded_;
+  };
+} // namespace pdfviewer
+
+#endif
@@ -0,0 +1,223 @@
+#include "render_worker.h"
+
+#include <utility>
+#include <vector>
+
+#include "render_stats.h"
+
+namespace pdfviewer
+{
+  // Time a slice of cooperative mode may take before the main loop gets an
+  // iteration, in microseconds
+  static const gint64 kSliceDuration = 4000;
+
+  // Worker whose job runs on the calling thread, null on other threads
+  static thread_local RenderWorker *current_worker = nullptr;
+  // End of the slice of the job running on the main loop, 0 outside of
+  // cooperative mode
+  static thread_local gint64 slice_deadline = 0;
+
+  RenderWorker::RenderWorker()
+      : waiting_priority_(kPriorityCount), running_priority_(kPriorityCount), busy_(false), cooperative_(false),
+        owner_(nullptr), idle_source_(0), stopping_(false), thread_(&RenderWorker::Run, this)
+  {
+  }
+
+  RenderWorker::~RenderWorker()
+  {
+    std::vector<Job> discarded;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+      for (std::deque<QueuedJob> &queue : jobs_)
+      {
+        for (QueuedJob &job : queue)
+        {
+          if (job.discard)
+            discarded.push_back(std::move(job.discard));
+        }
+        queue.clear();
+      }
+      waiting_priority_ = kPriorityCount;
+      if (idle_source_)
+        g_source_remove(idle_source_);
+      idle_source_ = 0;
+    }
+    condition_.notify_one();
+    thread_.join();
+
+    for (Job &discard : discarded)
+      discard();
+  }
+
+  void RenderWorker::Post(Job job, RenderPriority priority, Job discard)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!stopping_)
+      {
+        jobs_[static_cast<int>(priority)].push_back(QueuedJob{std::move(job), std::move(discard)});
+        waiting_priority_ = GetWaitingPriority();
+        EnsureIdleSource();
+        discard = nullptr;
+      }
+    }
+    if (discard)
+    {
+      discard();
+      return;
+    }
+    condition_.notify_one();
+  }
+
+  void RenderWorker::PostFollowUp(Job job, RenderPriority priority)
+  {
+    if (current_worker)
+      current_worker->Post(std::move(job), priority);
+    else
+      job();
+  }
+
+  void RenderWorker::SetCooperative(bool cooperative, GObject *owner)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cooperative_ = cooperative;
+      owner_ = owner;
+      if (!cooperative_ && idle_source_)
+      {
+        g_source_remove(idle_source_);
+        idle_source_ = 0;
+      }
+      EnsureIdleSource();
+    }
+    condition_.notify_one();
+  }
+
+  bool RenderWorker::IsPreempted()
+  {
+    const RenderWorker *worker = current_worker;
+    return worker && worker->running_priority_ >= static_cast<int>(RenderPriority::kPrefetch) &&
+           worker->waiting_priority_.load(std::memory_order_relaxed) < worker->running_priority_;
+  }
+
+  bool RenderWorker::IsSliceUsedUp()
+  {
+    return slice_deadline != 0 && g_get_monotonic_time() >= slice_deadline;
+  }
+
+  void RenderWorker::YieldSlice()
+  {
+    if (!IsSliceUsedUp())
+      return;
+
+    // The idle source of the worker is blocked while it dispatches, so the
+    // iteration never starts another job
+    gint64 start = g_get_monotonic_time();
+    g_main_context_iteration(nullptr, FALSE);
+    gint64 end = g_get_monotonic_time();
+    AddYieldedTime(end - start);
+    slice_deadline = end + kSliceDuration;
+  }
+
+  void RenderWorker::ResetThreadStateAfterFork()
+  {
+    current_worker = nullptr;
+    slice_deadline = 0;
+  }
+
+  RenderWorker::Job RenderWorker::TakeJob()
+  {
+    running_priority_ = GetWaitingPriority();
+    std::deque<QueuedJob> &queue = jobs_[running_priority_];
+    Job job = std::move(queue.front().run);
+    queue.pop_front();
+    waiting_priority_ = GetWaitingPriority();
+    busy_ = true;
+    return job;
+  }
+
+  void RenderWorker::EnsureIdleSource()
+  {
+    if (cooperative_ && !idle_source_ && !stopping_ && GetWaitingPriority() < kPriorityCount)
+      idle_source_ = g_idle_add(RunSliceCallback, this);
+  }
+
+  int RenderWorker::GetWaitingPriority() const
+  {
+    for (int priority = 0; priority < kPriorityCount; ++priority)
+    {
+      if (!jobs_[priority].empty())
+        return priority;
+    }
+    return kPriorityCount;
+  }
+
+  // Worker thread loop, runs queued jobs until the worker is stopped
+  void RenderWorker::Run()
+  {
+    current_worker = this;
+    while (true)
+    {
+      Job job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]
+                        { return stopping_ || (!cooperative_ && !busy_ && GetWaitingPriority() < kPriorityCount); });
+        if (stopping_)
+          return;
+        job = TakeJob();
+      }
+      job();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        busy_ = false;
+        // Jobs moved to the main loop while this one ran
+        EnsureIdleSource();
+      }
+    }
+  }
+
+  gboolean RenderWorker::RunSliceCallback(gpointer user_data)
+  {
+    return static_cast<RenderWorker *>(user_data)->RunSlice() ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+  }
+
+  bool RenderWorker::RunSlice()
+  {
+    guint source = g_source_get_id(g_main_current_source());
+    GObject *owner = owner_ ? G_OBJECT(g_object_ref(owner_)) : nullptr;
+    current_worker = this;
+    slice_deadline = g_get_monotonic_time() + kSliceDuration;
+    bool pending = true;
+    while (!IsSliceUsedUp())
+    {
+      Job job;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // A job still running on the thread adds the source again once done
+        if (stopping_ || !cooperative_ || busy_ || GetWaitingPriority() == kPriorityCount)
+        {
+          if (idle_source_ == source)
+            idle_source_ = 0;
+          pending = false;
+          break;
+        }
+        job = TakeJob();
+      }
+      job();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        busy_ = false;
+      }
+      condition_.notify_one();
+    }
+    current_worker = nullptr;
+    slice_deadline = 0;
+
+    // Releasing the owner may destroy the worker, which removes the source
+    if (owner)
+      g_object_unref(owner);
+    return pending;
+  }
+} // namespace pdfviewer
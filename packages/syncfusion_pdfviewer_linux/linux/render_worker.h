@@ -0,0 +1,131 @@
+#ifndef PDFVIEWER_RENDER_WORKER_H_
+#define PDFVIEWER_RENDER_WORKER_H_
+
+#include <glib-object.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace pdfviewer
+{
+  // Classes of the jobs of the render worker, most urgent first. Requests
+  // from Dart other than renders, such as opening a document, are short and
+  // share the class of visible tiles.
+  enum class RenderPriority
+  {
+    kVisibleTile,
+    kVisiblePage,
+    // Jobs of the classes below are speculative, their renders give way to
+    // more urgent jobs at the pause points of PDFium
+    kPrefetch,
+    kThumbnail,
+    kBackground,
+  };
+
+  // Runs PDFium jobs one at a time, on a background thread or, in
+  // cooperative mode, on the GLib main loop.
+  //
+  // PDFium is not thread-safe, so every call into it must be made from a job.
+  // The most urgent queued job runs first, jobs of the same priority run in
+  // the order they were posted. A running speculative job is not interrupted,
+  // but its renders stop early once a more urgent job is queued, see
+  // IsPreempted; the job then queues its remaining work again.
+  //
+  // In cooperative mode jobs run from an idle source of the main loop in
+  // slices of a few milliseconds, and renders hand the main loop an
+  // iteration at their pause points whenever the slice is used up, see
+  // YieldSlice. Input and frames are then handled while a heavy page renders.
+  // The other long loops of the jobs yield alike between their steps: the
+  // page geometry index built on open, text index passes, text searches and
+  // the cost estimate of a loaded page. A single PDFium call, such as loading
+  // a page, still runs to its end.
+  class RenderWorker
+  {
+  public:
+    using Job = std::function<void()>;
+
+    RenderWorker();
+    // Stops the worker thread once the running job is done. Jobs that have
+    // not started yet are discarded, their discard jobs run instead.
+    ~RenderWorker();
+
+    RenderWorker(const RenderWorker &) = delete;
+    RenderWorker &operator=(const RenderWorker &) = delete;
+
+    // Queues a job to run on the worker thread, or the main loop in
+    // cooperative mode. The discard job, when given, runs in its place if the
+    // worker is destroyed before the job started, so that a caller waiting
+    // for the job still gets an answer. It runs on the thread destroying the
+    // worker, or posting to it meanwhile.
+    void Post(Job job, RenderPriority priority = RenderPriority::kVisibleTile, Job discard = nullptr);
+    // Queues a job on the worker running the calling job, for follow-up work
+    // that should not delay the response of the job. Runs the job at once
+    // when called outside of the jobs.
+    static void PostFollowUp(Job job, RenderPriority priority);
+
+    // Moves the jobs to the main loop or back to the worker thread, from the
+    // next job on. The owner, which owns the worker, is kept alive while a
+    // job runs on the main loop, as the events the job lets through may drop
+    // its last reference. Called on the main thread.
+    void SetCooperative(bool cooperative, GObject *owner);
+
+    // Whether the speculative job running on the calling thread should give
+    // way to a more urgent job queued meanwhile. Always false outside of the
+    // jobs and for jobs of the visible classes.
+    static bool IsPreempted();
+    // Whether the job running on the main loop used up its slice, always
+    // false outside of cooperative mode
+    static bool IsSliceUsedUp();
+    // Lets the main loop handle its ready events once the slice of the job
+    // running on it is used up, then starts a new slice. Does nothing outside
+    // of cooperative mode.
+    static void YieldSlice();
+    // Forgets the job state of the calling thread in a process forked from
+    // within a job, so that its renders never enter the copied main loop
+    static void ResetThreadStateAfterFork();
+
+  private:
+    static const int kPriorityCount = static_cast<int>(RenderPriority::kBackground) + 1;
+
+    struct QueuedJob
+    {
+      Job run;
+      Job discard;
+    };
+
+    void Run();
+    static gboolean RunSliceCallback(gpointer user_data);
+    // Runs jobs on the main loop until the slice is used up, returns whether
+    // jobs remain
+    bool RunSlice();
+    // Pops the most urgent job. Called with the mutex held.
+    Job TakeJob();
+    // Adds the idle source running the jobs in cooperative mode, unless it
+    // exists or nothing is queued. Called with the mutex held.
+    void EnsureIdleSource();
+    // Most urgent class with queued jobs, kPriorityCount when none. Called
+    // with the mutex held.
+    int GetWaitingPriority() const;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<QueuedJob> jobs_[kPriorityCount];
+    // Mirror of GetWaitingPriority, read by the running job without the mutex
+    std::atomic<int> waiting_priority_;
+    // Class of the running job, only used by the running job
+    int running_priority_;
+    // Whether a job runs, on the thread or the main loop
+    bool busy_;
+    bool cooperative_;
+    GObject *owner_;
+    guint idle_source_;
+    bool stopping_;
+    std::thread thread_;
+  };
+} // namespace pdfviewer
+
+#endif
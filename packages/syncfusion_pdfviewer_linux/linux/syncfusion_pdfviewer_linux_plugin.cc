@@ -1,11 +1,32 @@
 #include "include/syncfusion_pdfviewer_linux/syncfusion_pdfviewer_linux_plugin.h"
 
 #include <flutter_linux/flutter_linux.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <gio/gio.h>
 #include <glib.h>
 
+#include "bitmap_buffer_pool.h"
+#include "disk_cache.h"
+#include "document_upload.h"
+#include "memory_budget.h"
+#include "pdf_page_texture.h"
 #include "pdfviewer.h"
+#include "prefetcher.h"
+#include "progressive_document.h"
+#include "render_farm.h"
+#include "render_request.h"
+#include "render_stats.h"
+#include "render_worker.h"
+#include "text_index.h"
+#include "text_search.h"
+#include "thumbnail_atlas.h"
+#include "tile_engine.h"
 #include "fpdfview.h"
 
 #define SYNCFUSION_PDFVIEWER_LINUX_PLUGIN(obj) \
@@ -14,18 +35,69 @@
 struct _SyncfusionPdfviewerLinuxPlugin
 {
   GObject parent_instance;
+
+  // Background thread that owns every PDFium call made by the plugin
+  pdfviewer::RenderWorker *worker;
+
+  // Page and tile renders that have not completed yet
+  pdfviewer::RenderRequestRegistry *render_requests;
+
+  // Text searches that have not completed yet, by search ID
+  pdfviewer::RenderRequestRegistry *text_searches;
+
+  // Registrar of the page textures and the textures created from Dart, by ID
+  FlTextureRegistrar *texture_registrar;
+  std::unordered_map<gint64, PdfPageTexture *> *textures;
+
+  // Channel of the document events sent to Dart, such as page availability
+  FlEventChannel *event_channel;
+
+  // Source of the low memory warnings of the system, null when unavailable
+  GMemoryMonitor *memory_monitor;
+  gulong low_memory_handler;
 };
 
 G_DEFINE_TYPE(SyncfusionPdfviewerLinuxPlugin, syncfusion_pdfviewer_linux_plugin, g_object_get_type())
 
 // Forward declarations for method handlers
-FlMethodResponse *InitializePDFRenderer(FlMethodCall *method_call);
-FlMethodResponse *LoadPdfFromFile(FlMethodCall *method_call);
+FlMethodResponse *InitializePDFRenderer(FlMethodCall *method_call, const pdfviewer::OpenProgress &progress);
+FlMethodResponse *LoadPdfFromFile(FlMethodCall *method_call, const pdfviewer::OpenProgress &progress);
+FlMethodResponse *BeginDocumentUpload(FlMethodCall *method_call);
+FlMethodResponse *AbortDocumentUpload(FlMethodCall *method_call);
+FlMethodResponse *FinalizeDocumentUpload(FlMethodCall *method_call, const pdfviewer::OpenProgress &progress);
+FlMethodResponse *BeginProgressiveDocument(FlMethodCall *method_call);
+FlMethodResponse *IsPageAvailable(FlMethodCall *method_call);
 FlMethodResponse *GetPagesHeight(FlMethodCall *method_call);
 FlMethodResponse *GetPagesWidth(FlMethodCall *method_call);
-FlMethodResponse *GetPdfPageImage(FlMethodCall *method_call);
-FlMethodResponse *GetPdfPageTileImage(FlMethodCall *method_call);
+FlMethodResponse *GetPageGeometry(FlMethodCall *method_call);
+FlMethodResponse *GetPdfPageImage(FlMethodCall *method_call, const pdfviewer::RenderToken *token);
+FlMethodResponse *GetPdfPageTileImage(FlMethodCall *method_call, const pdfviewer::RenderToken *token);
+FlMethodResponse *GetGridTiles(FlMethodCall *method_call, const pdfviewer::RenderToken *token);
+FlMethodResponse *RenderPages(FlMethodCall *method_call, const pdfviewer::RenderToken *token);
 FlMethodResponse *CloseDocument(FlMethodCall *method_call);
+FlMethodResponse *ViewportHint(FlMethodCall *method_call);
+FlMethodResponse *SetRenderProcessCount(FlMethodCall *method_call);
+FlMethodResponse *SetMemoryBudget(FlMethodCall *method_call);
+FlMethodResponse *GetMemoryUsage(FlMethodCall *method_call);
+FlMethodResponse *SetDiskCacheEnabled(FlMethodCall *method_call);
+FlMethodResponse *ClearDiskCache(FlMethodCall *method_call);
+FlMethodResponse *GetRenderStats(FlMethodCall *method_call);
+FlMethodResponse *StartThumbnails(FlMethodCall *method_call);
+FlMethodResponse *SetVisibleThumbnails(FlMethodCall *method_call);
+FlMethodResponse *GetThumbnailAtlas(FlMethodCall *method_call);
+FlMethodResponse *GetPageText(FlMethodCall *method_call);
+FlMethodResponse *CreateFarmRenderResponse(pdfviewer::FarmRenderStatus status, const guint8 *pixels, gsize size);
+FlMethodResponse *CancelRender(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call);
+FlMethodResponse *SetCooperativeRendering(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call);
+FlMethodResponse *CancelTextSearch(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call);
+FlMethodResponse *CreatePageTexture(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call);
+FlMethodResponse *DisposePageTexture(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call);
+FlMethodResponse *RenderPageTexture(FlMethodCall *method_call, PdfPageTexture *texture,
+                                    const pdfviewer::RenderToken *token);
+
+typedef FlMethodResponse *(*MethodHandler)(FlMethodCall *method_call);
+typedef FlMethodResponse *(*RenderHandler)(FlMethodCall *method_call, const pdfviewer::RenderToken *token);
+typedef FlMethodResponse *(*OpenHandler)(FlMethodCall *method_call, const pdfviewer::OpenProgress &progress);
 
 // Helper function for creating error responses
 static FlMethodResponse *create_error_response(const gchar *code, const gchar *message)
@@ -33,312 +105,2355 @@ static FlMethodResponse *create_error_response(const gchar *code, const gchar *m
   return FL_METHOD_RESPONSE(fl_method_error_response_new(code, message, nullptr));
 }
 
-// Method call handler to map method names to appropriate functions
-static void syncfusion_pdfviewer_linux_plugin_handle_method_call(
-    SyncfusionPdfviewerLinuxPlugin *self,
-    FlMethodCall *method_call)
+// Reads the optional quality argument of a render, full quality when absent.
+// Returns false when it does not name a RenderQuality.
+static bool read_render_quality(FlValue *args, pdfviewer::RenderQuality *quality)
 {
-  g_autoptr(FlMethodResponse) response = nullptr;
-  const gchar *method = fl_method_call_get_name(method_call);
+  *quality = pdfviewer::RenderQuality::kFull;
+  FlValue *qualityKey = fl_value_lookup_string(args, "quality");
+  if (!qualityKey || fl_value_get_type(qualityKey) == FL_VALUE_TYPE_NULL)
+    return true;
+  if (fl_value_get_type(qualityKey) != FL_VALUE_TYPE_INT || !pdfviewer::IsRenderQuality(fl_value_get_int(qualityKey)))
+    return false;
+  *quality = static_cast<pdfviewer::RenderQuality>(fl_value_get_int(qualityKey));
+  return true;
+}
 
-  if (g_strcmp0(method, "initializePdfRenderer") == 0)
+// Reads an optional float argument, the fallback when absent
+static double read_float(FlValue *args, const gchar *name, double fallback)
+{
+  FlValue *value = fl_value_lookup_string(args, name);
+  return value && fl_value_get_type(value) == FL_VALUE_TYPE_FLOAT ? fl_value_get_float(value) : fallback;
+}
+
+// Response computed on the render worker, waiting to be sent from the main loop
+typedef struct
+{
+  FlMethodCall *method_call;
+  FlMethodResponse *response;
+  // Texture that received a new frame, null for other responses
+  FlTextureRegistrar *texture_registrar;
+  FlTexture *texture;
+  // Monotonic time the response was queued at
+  gint64 queued_time;
+} PendingResponse;
+
+static RenderHandler find_render_handler(const gchar *method);
+
+static gboolean pending_response_send_cb(gpointer user_data)
+{
+  PendingResponse *pending = static_cast<PendingResponse *>(user_data);
+  if (pending->texture)
   {
-    response = InitializePDFRenderer(method_call);
+    fl_texture_registrar_mark_texture_frame_available(pending->texture_registrar, pending->texture);
   }
-  else if (g_strcmp0(method, "loadPdfFromFile") == 0)
+  fl_method_call_respond(pending->method_call, pending->response, nullptr);
+
+  // Render responses record the wait for the main loop and the send
+  const gchar *method = fl_method_call_get_name(pending->method_call);
+  FlValue *args = fl_method_call_get_args(pending->method_call);
+  if ((pending->texture || find_render_handler(method)) && args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP)
+  {
+    FlValue *documentIDKey = fl_value_lookup_string(args, "documentID");
+    if (documentIDKey && fl_value_get_type(documentIDKey) == FL_VALUE_TYPE_STRING)
+      pdfviewer::RenderStats::Shared().Record(fl_value_get_string(documentIDKey), pdfviewer::RenderPhase::kTransfer,
+                                              g_get_monotonic_time() - pending->queued_time);
+  }
+  return G_SOURCE_REMOVE;
+}
+
+static void pending_response_free(gpointer user_data)
+{
+  PendingResponse *pending = static_cast<PendingResponse *>(user_data);
+  g_object_unref(pending->method_call);
+  g_object_unref(pending->response);
+  if (pending->texture)
+  {
+    g_object_unref(pending->texture_registrar);
+    g_object_unref(pending->texture);
+  }
+  g_free(pending);
+}
+
+// Sends the response from the GTK main loop, as the engine expects responses on
+// the platform thread. Takes ownership of the response. When a texture is given,
+// its new frame is announced to the engine before responding.
+static void respond_on_main_thread(FlMethodCall *method_call, FlMethodResponse *response,
+                                   FlTextureRegistrar *texture_registrar = nullptr,
+                                   FlTexture *texture = nullptr)
+{
+  PendingResponse *pending = g_new0(PendingResponse, 1);
+  pending->method_call = FL_METHOD_CALL(g_object_ref(method_call));
+  pending->response = response;
+  pending->queued_time = g_get_monotonic_time();
+  if (texture)
+  {
+    pending->texture_registrar = FL_TEXTURE_REGISTRAR(g_object_ref(texture_registrar));
+    pending->texture = FL_TEXTURE(g_object_ref(texture));
+  }
+  g_main_context_invoke_full(nullptr, G_PRIORITY_DEFAULT, pending_response_send_cb,
+                             pending, pending_response_free);
+}
+
+// Discard job of a queued method call, answers it with an error when the
+// plugin is disposed before the call ran so that its Dart future completes
+static pdfviewer::RenderWorker::Job respond_disposed(std::shared_ptr<FlMethodCall> call)
+{
+  return [call]()
+  { respond_on_main_thread(call.get(), create_error_response("Disposed", "The PDF viewer was disposed")); };
+}
+
+// Document event waiting to be sent from the main loop
+typedef struct
+{
+  FlEventChannel *channel;
+  FlValue *event;
+} PendingEvent;
+
+static gboolean pending_event_send_cb(gpointer user_data)
+{
+  PendingEvent *pending = static_cast<PendingEvent *>(user_data);
+  fl_event_channel_send(pending->channel, pending->event, nullptr, nullptr);
+  return G_SOURCE_REMOVE;
+}
+
+static void pending_event_free(gpointer user_data)
+{
+  PendingEvent *pending = static_cast<PendingEvent *>(user_data);
+  g_object_unref(pending->channel);
+  fl_value_unref(pending->event);
+  g_free(pending);
+}
+
+// Sends a document event to Dart from the GTK main loop. Takes ownership of
+// the event.
+static void send_event_on_main_thread(SyncfusionPdfviewerLinuxPlugin *self, FlValue *event)
+{
+  PendingEvent *pending = g_new0(PendingEvent, 1);
+  pending->channel = static_cast<FlEventChannel *>(g_object_ref(self->event_channel));
+  pending->event = event;
+  g_main_context_invoke_full(nullptr, G_PRIORITY_DEFAULT, pending_event_send_cb,
+                             pending, pending_event_free);
+}
+
+// Creates a document event map with its name and document ID
+static FlValue *new_document_event(const gchar *name, const gchar *document_id)
+{
+  FlValue *event = fl_value_new_map();
+  fl_value_set_string_take(event, "event", fl_value_new_string(name));
+  fl_value_set_string_take(event, "documentID", fl_value_new_string(document_id));
+  return event;
+}
+
+// Thumbnails generated by one pass on the render worker. Passes run behind
+// the visible and prefetch renders; a render of a thumbnail gives way to a
+// more urgent job as soon as it is queued.
+static const int kThumbnailsPerPass = 8;
+
+static void schedule_thumbnails(SyncfusionPdfviewerLinuxPlugin *self, const std::string &documentID);
+
+// Generates the next few thumbnails of a document, reports them with a
+// thumbnailsReady event per atlas and queues the next pass behind the jobs
+// posted meanwhile. Runs on the render worker.
+static void run_thumbnail_pass(SyncfusionPdfviewerLinuxPlugin *self, const std::string &documentID)
+{
+  pdfviewer::PdfDocument *document = pdfviewer::GetPdfDocument(documentID.c_str());
+  pdfviewer::ThumbnailAtlas *thumbnails = document ? document->thumbnails() : nullptr;
+  if (!thumbnails)
+    return;
+
+  std::vector<int> pages = thumbnails->GenerateNext(kThumbnailsPerPass);
+  std::unordered_map<int, std::vector<int32_t>> pagesByAtlas;
+  for (int index : pages)
+    pagesByAtlas[thumbnails->cells()[index].atlas].push_back(index + 1);
+  for (const auto &entry : pagesByAtlas)
+  {
+    FlValue *event = new_document_event("thumbnailsReady", documentID.c_str());
+    fl_value_set_string_take(event, "atlasIndex", fl_value_new_int(entry.first));
+    fl_value_set_string_take(event, "pageNumbers", fl_value_new_int32_list(entry.second.data(), entry.second.size()));
+    fl_value_set_string_take(event, "complete", fl_value_new_bool(thumbnails->atlases()[entry.first].pending == 0));
+    send_event_on_main_thread(self, event);
+  }
+
+  if (thumbnails->HasPending())
+  {
+    self->worker->Post([self, documentID]()
+                       { run_thumbnail_pass(self, documentID); }, pdfviewer::RenderPriority::kThumbnail);
+  }
+  else
+  {
+    thumbnails->SetScheduled(false);
+  }
+}
+
+// Starts the thumbnail passes of a document unless they are already queued.
+// Runs on the render worker.
+static void schedule_thumbnails(SyncfusionPdfviewerLinuxPlugin *self, const std::string &documentID)
+{
+  pdfviewer::PdfDocument *document = pdfviewer::GetPdfDocument(documentID.c_str());
+  pdfviewer::ThumbnailAtlas *thumbnails = document ? document->thumbnails() : nullptr;
+  if (!thumbnails || thumbnails->isScheduled() || !thumbnails->HasPending())
+    return;
+
+  thumbnails->SetScheduled(true);
+  self->worker->Post([self, documentID]()
+                     { run_thumbnail_pass(self, documentID); }, pdfviewer::RenderPriority::kThumbnail);
+}
+
+// Time a text indexing pass may take on the render worker, in microseconds
+static const gint64 kTextIndexPassDuration = 8000;
+
+// Indexes the text of the next pages of a document and queues the next pass
+// behind every other job. Runs on the render worker.
+static void run_text_index_pass(SyncfusionPdfviewerLinuxPlugin *self, const std::string &documentID)
+{
+  pdfviewer::PdfDocument *document = pdfviewer::GetPdfDocument(documentID.c_str());
+  pdfviewer::TextIndex *textIndex = document ? document->textIndex() : nullptr;
+  if (!textIndex)
+    return;
+
+  textIndex->IndexPages(kTextIndexPassDuration);
+  if (textIndex->HasPending())
+  {
+    self->worker->Post([self, documentID]()
+                       { run_text_index_pass(self, documentID); }, pdfviewer::RenderPriority::kBackground);
+  }
+  else
+  {
+    textIndex->SetScheduled(false);
+  }
+}
+
+// Starts indexing the text of a document in the background unless the index
+// was loaded from the disk cache or its passes are already queued. Runs on
+// the render worker.
+static void schedule_text_index(SyncfusionPdfviewerLinuxPlugin *self, const std::string &documentID)
+{
+  pdfviewer::PdfDocument *document = pdfviewer::GetPdfDocument(documentID.c_str());
+  pdfviewer::TextIndex *textIndex = document ? document->StartTextIndex() : nullptr;
+  if (!textIndex || textIndex->isScheduled() || !textIndex->HasPending())
+    return;
+
+  textIndex->SetScheduled(true);
+  self->worker->Post([self, documentID]()
+                     { run_text_index_pass(self, documentID); }, pdfviewer::RenderPriority::kBackground);
+}
+
+// Renders the next tile predicted ahead of the viewport of a document and
+// queues the next pass behind every visible render. Runs on the render
+// worker.
+static void run_prefetch_pass(SyncfusionPdfviewerLinuxPlugin *self, const std::string &documentID)
+{
+  pdfviewer::PdfDocument *document = pdfviewer::GetPdfDocument(documentID.c_str());
+  pdfviewer::Prefetcher *prefetcher = document ? document->prefetcher() : nullptr;
+  if (!prefetcher)
+    return;
+
+  prefetcher->PrefetchNext();
+  if (prefetcher->HasPending())
+  {
+    self->worker->Post([self, documentID]()
+                       { run_prefetch_pass(self, documentID); }, pdfviewer::RenderPriority::kPrefetch);
+  }
+  else
+  {
+    prefetcher->SetScheduled(false);
+  }
+}
+
+// Starts the prefetch passes of a document unless they are already queued.
+// Runs on the render worker.
+static void schedule_prefetch(SyncfusionPdfviewerLinuxPlugin *self, const std::string &documentID)
+{
+  pdfviewer::PdfDocument *document = pdfviewer::GetPdfDocument(documentID.c_str());
+  pdfviewer::Prefetcher *prefetcher = document ? document->prefetcher() : nullptr;
+  if (!prefetcher || prefetcher->isScheduled() || !prefetcher->HasPending())
+    return;
+
+  prefetcher->SetScheduled(true);
+  self->worker->Post([self, documentID]()
+                     { run_prefetch_pass(self, documentID); }, pdfviewer::RenderPriority::kPrefetch);
+}
+
+// Re-checks a progressively opened document after new data arrived for its
+// upload. Opens the document once its structure is complete, then reports the
+// pages that became available and the byte ranges PDFium needs next.
+static void update_progressive_document(SyncfusionPdfviewerLinuxPlugin *self, gint64 upload_id)
+{
+  pdfviewer::ProgressiveDocument *source = pdfviewer::FindProgressiveDocument(upload_id);
+  if (!source)
+    return;
+
+  const gchar *documentID = source->documentID();
+  int linearized = source->IsLinearized();
+  if (linearized != PDF_LINEARIZATION_UNKNOWN && !source->linearizationReported())
+  {
+    source->SetLinearizationReported();
+    FlValue *event = new_document_event("linearizationDetected", documentID);
+    fl_value_set_string_take(event, "linearized", fl_value_new_bool(linearized == PDF_LINEARIZED));
+    send_event_on_main_thread(self, event);
+  }
+
+  pdfviewer::PdfDocument *document = pdfviewer::GetPdfDocument(documentID);
+  if (!document && source->IsDocumentAvailable())
+  {
+    document = pdfviewer::OpenProgressivePdfDocument(source);
+    if (!document)
+    {
+      send_event_on_main_thread(self, new_document_event("documentFailed", documentID));
+      return;
+    }
+    FlValue *event = new_document_event("documentAvailable", documentID);
+    fl_value_set_string_take(event, "pageCount", fl_value_new_int(document->pageCount()));
+    fl_value_set_string_take(event, "linearized", fl_value_new_bool(linearized == PDF_LINEARIZED));
+    send_event_on_main_thread(self, event);
+    schedule_text_index(self, documentID);
+  }
+
+  if (document)
+  {
+    std::vector<int> pages = source->UpdatePageAvailability(document->pageCount());
+    if (!pages.empty())
+    {
+      std::vector<int32_t> pageNumbers;
+      for (int index : pages)
+      {
+        document->RefreshPageGeometry(index);
+        pageNumbers.push_back(index + 1);
+      }
+      FlValue *event = new_document_event("pagesAvailable", documentID);
+      fl_value_set_string_take(event, "pageNumbers", fl_value_new_int32_list(pageNumbers.data(), pageNumbers.size()));
+      send_event_on_main_thread(self, event);
+
+      // Thumbnails and text of the pages that just arrived can be generated
+      // now
+      if (document->thumbnails())
+      {
+        document->thumbnails()->Resume();
+        schedule_thumbnails(self, documentID);
+      }
+      if (document->textIndex())
+      {
+        document->textIndex()->Resume();
+        schedule_text_index(self, documentID);
+      }
+    }
+  }
+
+  std::vector<std::pair<gsize, gsize>> ranges = source->TakeRequestedRanges();
+  if (!ranges.empty())
+  {
+    std::vector<int64_t> offsets;
+    for (const auto &range : ranges)
+    {
+      offsets.push_back(static_cast<int64_t>(range.first));
+      offsets.push_back(static_cast<int64_t>(range.second));
+    }
+    FlValue *event = new_document_event("dataRequested", documentID);
+    fl_value_set_string_take(event, "ranges", fl_value_new_int64_list(offsets.data(), offsets.size()));
+    send_event_on_main_thread(self, event);
+  }
+}
+
+// Name of an open phase in the openProgress events
+static const gchar *get_open_phase_name(pdfviewer::OpenPhase phase)
+{
+  switch (phase)
+  {
+  case pdfviewer::OpenPhase::kDocumentParsed:
+    return "documentParsed";
+  case pdfviewer::OpenPhase::kPagesCounted:
+    return "pagesCounted";
+  case pdfviewer::OpenPhase::kIndexingGeometry:
+    return "indexingGeometry";
+  case pdfviewer::OpenPhase::kGeometryIndexed:
+    return "geometryIndexed";
+  }
+  return "";
+}
+
+// Queues a document open on the render worker. The method call completes once
+// the document is open, while each open phase is pushed to Dart as an
+// openProgress event, so the viewer can lay out the pages before the geometry
+// of all of them is known.
+static void post_open_request(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call,
+                              OpenHandler handler)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  FlValue *documentIDKey = args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                               ? fl_value_lookup_string(args, "documentID")
+                               : nullptr;
+  std::string documentID = documentIDKey && fl_value_get_type(documentIDKey) == FL_VALUE_TYPE_STRING
+                               ? fl_value_get_string(documentIDKey)
+                               : "";
+
+  pdfviewer::OpenProgress progress = [self, documentID](pdfviewer::OpenPhase phase, int pages_done, int page_count)
+  {
+    FlValue *event = new_document_event("openProgress", documentID.c_str());
+    fl_value_set_string_take(event, "phase", fl_value_new_string(get_open_phase_name(phase)));
+    fl_value_set_string_take(event, "pagesDone", fl_value_new_int(pages_done));
+    fl_value_set_string_take(event, "pageCount", fl_value_new_int(page_count));
+    send_event_on_main_thread(self, event);
+  };
+
+  std::shared_ptr<FlMethodCall> call(FL_METHOD_CALL(g_object_ref(method_call)), g_object_unref);
+  self->worker->Post([self, handler, call, progress, documentID]()
+                     {
+    respond_on_main_thread(call.get(), handler(call.get(), progress));
+    // The text is indexed once the document is open, for later searches
+    schedule_text_index(self, documentID); },
+                     pdfviewer::RenderPriority::kVisibleTile, respond_disposed(call));
+}
+
+// Maps method names to the functions that handle them
+static MethodHandler find_method_handler(const gchar *method)
+{
+  if (g_strcmp0(method, "beginDocumentUpload") == 0)
+  {
+    return BeginDocumentUpload;
+  }
+  else if (g_strcmp0(method, "abortDocumentUpload") == 0)
+  {
+    return AbortDocumentUpload;
+  }
+  else if (g_strcmp0(method, "beginProgressiveDocument") == 0)
+  {
+    return BeginProgressiveDocument;
+  }
+  else if (g_strcmp0(method, "isPageAvailable") == 0)
   {
-    response = LoadPdfFromFile(method_call);
+    return IsPageAvailable;
   }
   else if (g_strcmp0(method, "getPagesHeight") == 0)
   {
-    response = GetPagesHeight(method_call);
+    return GetPagesHeight;
   }
   else if (g_strcmp0(method, "getPagesWidth") == 0)
   {
-    response = GetPagesWidth(method_call);
+    return GetPagesWidth;
+  }
+  else if (g_strcmp0(method, "getPageGeometry") == 0)
+  {
+    return GetPageGeometry;
+  }
+  else if (g_strcmp0(method, "closeDocument") == 0)
+  {
+    return CloseDocument;
+  }
+  else if (g_strcmp0(method, "setRenderProcessCount") == 0)
+  {
+    return SetRenderProcessCount;
+  }
+  else if (g_strcmp0(method, "setMemoryBudget") == 0)
+  {
+    return SetMemoryBudget;
+  }
+  else if (g_strcmp0(method, "getMemoryUsage") == 0)
+  {
+    return GetMemoryUsage;
+  }
+  else if (g_strcmp0(method, "setDiskCacheEnabled") == 0)
+  {
+    return SetDiskCacheEnabled;
+  }
+  else if (g_strcmp0(method, "clearDiskCache") == 0)
+  {
+    return ClearDiskCache;
+  }
+  else if (g_strcmp0(method, "getThumbnailAtlas") == 0)
+  {
+    return GetThumbnailAtlas;
+  }
+  else if (g_strcmp0(method, "getPageText") == 0)
+  {
+    return GetPageText;
+  }
+  return nullptr;
+}
+
+// Maps document open method names to the functions that handle them
+static OpenHandler find_open_handler(const gchar *method)
+{
+  if (g_strcmp0(method, "initializePdfRenderer") == 0)
+  {
+    return InitializePDFRenderer;
+  }
+  else if (g_strcmp0(method, "loadPdfFromFile") == 0)
+  {
+    return LoadPdfFromFile;
+  }
+  else if (g_strcmp0(method, "finalizeDocumentUpload") == 0)
+  {
+    return FinalizeDocumentUpload;
+  }
+  return nullptr;
+}
+
+// Maps render method names to the functions that handle them
+static RenderHandler find_render_handler(const gchar *method)
+{
+  if (g_strcmp0(method, "getPage") == 0)
+  {
+    return GetPdfPageImage;
+  }
+  else if (g_strcmp0(method, "getTileImage") == 0)
+  {
+    return GetPdfPageTileImage;
+  }
+  else if (g_strcmp0(method, "getGridTiles") == 0)
+  {
+    return GetGridTiles;
+  }
+  else if (g_strcmp0(method, "renderPages") == 0)
+  {
+    return RenderPages;
+  }
+  return nullptr;
+}
+
+// Class of a render on the render worker, renders of whole pages wait for the
+// tiles of the visible region
+static pdfviewer::RenderPriority get_render_priority(RenderHandler handler)
+{
+  return handler == GetPdfPageTileImage || handler == GetGridTiles ? pdfviewer::RenderPriority::kVisibleTile
+                                                                    : pdfviewer::RenderPriority::kVisiblePage;
+}
+
+// Runs a page or tile render on the render worker and responds
+static void run_render_request(RenderHandler handler, FlMethodCall *method_call, const pdfviewer::RenderToken *token,
+                               gint64 requestID, pdfviewer::RenderRequestRegistry *render_requests)
+{
+  FlMethodResponse *response = token && token->IsCancelled()
+                                   ? create_error_response("RenderCancelled", "Render request was cancelled")
+                                   : handler(method_call, token);
+  if (token)
+    render_requests->End(requestID);
+  respond_on_main_thread(method_call, response);
+}
+
+// Render the helper processes could not take, waiting to be queued on the
+// render worker from the main loop, where the worker is known to be alive
+struct PendingFallback
+{
+  SyncfusionPdfviewerLinuxPlugin *self;
+  RenderHandler handler;
+  std::shared_ptr<FlMethodCall> call;
+  std::shared_ptr<pdfviewer::RenderToken> token;
+  gint64 request_id;
+};
+
+static gboolean pending_fallback_post_cb(gpointer user_data)
+{
+  PendingFallback *pending = static_cast<PendingFallback *>(user_data);
+  SyncfusionPdfviewerLinuxPlugin *self = pending->self;
+  if (!self->worker)
+  {
+    // The plugin was disposed meanwhile
+    g_autoptr(FlMethodResponse) response = create_error_response("RenderFailed", "Unable to render the page");
+    fl_method_call_respond(pending->call.get(), response, nullptr);
+    return G_SOURCE_REMOVE;
+  }
+
+  RenderHandler handler = pending->handler;
+  std::shared_ptr<FlMethodCall> call = pending->call;
+  std::shared_ptr<pdfviewer::RenderToken> token = pending->token;
+  gint64 requestID = pending->request_id;
+  pdfviewer::RenderRequestRegistry *render_requests = self->render_requests;
+  self->worker->Post([handler, call, token, requestID, render_requests]()
+                     { run_render_request(handler, call.get(), token.get(), requestID, render_requests); },
+                     get_render_priority(handler), respond_disposed(call));
+  return G_SOURCE_REMOVE;
+}
+
+static void pending_fallback_free(gpointer user_data)
+{
+  PendingFallback *pending = static_cast<PendingFallback *>(user_data);
+  g_object_unref(pending->self);
+  delete pending;
+}
+
+// Sends a page or tile render to the helper processes when they run. Returns
+// false when the render has to run on the render worker, for documents the
+// helpers cannot open, such as progressively opened ones, for pages the
+// prefetcher already rendered, or for other kinds of renders. Runs on the
+// render worker, so farm renders are taken in the order of the priority
+// classes like every other render.
+static bool submit_farm_render(SyncfusionPdfviewerLinuxPlugin *self, std::shared_ptr<FlMethodCall> call,
+                               RenderHandler handler, std::shared_ptr<pdfviewer::RenderToken> token,
+                               gint64 requestID)
+{
+  if ((handler != GetPdfPageImage && handler != GetPdfPageTileImage) || !pdfviewer::RenderFarm::Shared().IsRunning())
+    return false;
+
+  FlValue *args = fl_method_call_get_args(call.get());
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return false;
+  FlValue *documentIDKey = fl_value_lookup_string(args, "documentID");
+  if (!documentIDKey || fl_value_get_type(documentIDKey) != FL_VALUE_TYPE_STRING)
+    return false;
+
+  pdfviewer::RenderQuality quality;
+  if (!read_render_quality(args, &quality))
+    return false;
+
+  pdfviewer::FarmRenderJob job = {};
+  job.document_id = fl_value_get_string(documentIDKey);
+  int flags = pdfviewer::GetQualityRenderFlags(FPDF_LCD_TEXT | FPDF_REVERSE_BYTE_ORDER, quality);
+  job.flags = pdfviewer::MemoryBudget::Shared().AdjustRenderFlags(flags);
+  if (handler == GetPdfPageImage)
+  {
+    FlValue *indexKey = fl_value_lookup_string(args, "index");
+    FlValue *widthKey = fl_value_lookup_string(args, "width");
+    FlValue *heightKey = fl_value_lookup_string(args, "height");
+    if (!indexKey || fl_value_get_type(indexKey) != FL_VALUE_TYPE_INT ||
+        !widthKey || fl_value_get_type(widthKey) != FL_VALUE_TYPE_INT ||
+        !heightKey || fl_value_get_type(heightKey) != FL_VALUE_TYPE_INT)
+      return false;
+    job.kind = pdfviewer::FarmRenderKind::kPage;
+    job.page_index = fl_value_get_int(indexKey) - 1;
+    job.width = fl_value_get_int(widthKey);
+    job.height = fl_value_get_int(heightKey);
+
+    // The request guides the prefetcher like one rendered here, and a page
+    // it prerendered is taken from the page image cache by GetPdfPageImage
+    pdfviewer::PdfDocument *document = pdfviewer::GetPdfDocument(job.document_id.c_str());
+    if (!document)
+      return false;
+    pdfviewer::PageImageCache &pageImages = document->pageImages();
+    pageImages.SetLastRequest(job.page_index, job.width, job.height, flags);
+    if (pageImages.Contains(job.page_index, job.width, job.height, flags))
+      return false;
+  }
+  else
+  {
+    FlValue *pageNumberKey = fl_value_lookup_string(args, "pageNumber");
+    if (!pageNumberKey || fl_value_get_type(pageNumberKey) != FL_VALUE_TYPE_INT)
+      return false;
+    const gchar *names[] = {"scale", "x", "y", "width", "height"};
+    double values[5];
+    for (int i = 0; i < 5; ++i)
+    {
+      FlValue *value = fl_value_lookup_string(args, names[i]);
+      if (!value || fl_value_get_type(value) != FL_VALUE_TYPE_FLOAT)
+        return false;
+      values[i] = fl_value_get_float(value);
+    }
+    job.kind = pdfviewer::FarmRenderKind::kTile;
+    job.page_index = fl_value_get_int(pageNumberKey) - 1;
+    job.scale = values[0];
+    job.x = values[1];
+    job.y = values[2];
+    job.width = static_cast<int>(values[3]);
+    job.height = static_cast<int>(values[4]);
+  }
+  if (job.width <= 0 || job.height <= 0)
+    return false;
+
+  // The farm finishes its callbacks before the plugin is disposed, so the
+  // plugin is only referenced again once a render falls back to the worker
+  pdfviewer::RenderRequestRegistry *render_requests = self->render_requests;
+  std::string documentID = job.document_id;
+  gint64 start = g_get_monotonic_time();
+  pdfviewer::FarmRenderCallback callback = [self, handler, call, token, requestID, render_requests, documentID,
+                                            start](pdfviewer::FarmRenderStatus status, const guint8 *pixels, gsize size)
+  {
+    if (status == pdfviewer::FarmRenderStatus::kUnavailable)
+    {
+      PendingFallback *pending = new PendingFallback{SYNCFUSION_PDFVIEWER_LINUX_PLUGIN(g_object_ref(self)), handler,
+                                                     call, token, requestID};
+      g_main_context_invoke_full(nullptr, G_PRIORITY_DEFAULT, pending_fallback_post_cb,
+                                 pending, pending_fallback_free);
+      return;
+    }
+    if (status == pdfviewer::FarmRenderStatus::kDone)
+      pdfviewer::RenderStats::Shared().Record(documentID.c_str(), pdfviewer::RenderPhase::kFarmRender,
+                                              g_get_monotonic_time() - start);
+    if (token)
+      render_requests->End(requestID);
+    respond_on_main_thread(call.get(), CreateFarmRenderResponse(status, pixels, size));
+  };
+  return pdfviewer::RenderFarm::Shared().Submit(job, token, callback);
+}
+
+// Queues a page or tile render. Requests that carry a request ID can be
+// cancelled with cancelRender and are superseded by newer requests for the
+// same page. Page and tile images go to the helper processes when they run,
+// once the render worker reaches them in their priority class.
+static void post_render_request(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call,
+                                RenderHandler handler)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  FlValue *requestIDKey = nullptr;
+  FlValue *documentIDKey = nullptr;
+  FlValue *pageKey = nullptr;
+  if (args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP)
+  {
+    requestIDKey = fl_value_lookup_string(args, "requestID");
+    documentIDKey = fl_value_lookup_string(args, "documentID");
+    // A batch covers many pages, its target is the batch itself so that
+    // batches never supersede each other
+    pageKey = fl_value_lookup_string(args, handler == GetPdfPageImage ? "index"
+                                           : handler == RenderPages   ? "requestID"
+                                                                      : "pageNumber");
+  }
+
+  std::shared_ptr<pdfviewer::RenderToken> token;
+  gint64 requestID = 0;
+  if (requestIDKey && fl_value_get_type(requestIDKey) == FL_VALUE_TYPE_INT &&
+      documentIDKey && fl_value_get_type(documentIDKey) == FL_VALUE_TYPE_STRING &&
+      pageKey && fl_value_get_type(pageKey) == FL_VALUE_TYPE_INT)
+  {
+    requestID = fl_value_get_int(requestIDKey);
+    std::string target = std::string(fl_method_call_get_name(method_call)) + ":" +
+                         fl_value_get_string(documentIDKey) + ":" +
+                         std::to_string(fl_value_get_int(pageKey));
+    token = self->render_requests->Begin(requestID, target);
+  }
+
+  std::shared_ptr<FlMethodCall> call(FL_METHOD_CALL(g_object_ref(method_call)), g_object_unref);
+  pdfviewer::RenderRequestRegistry *render_requests = self->render_requests;
+  self->worker->Post([self, handler, call, token, requestID, render_requests]()
+                     {
+    if ((!token || !token->IsCancelled()) && submit_farm_render(self, call, handler, token, requestID))
+      return;
+    run_render_request(handler, call.get(), token.get(), requestID, render_requests); },
+                     get_render_priority(handler), respond_disposed(call));
+}
+
+// Queues a render into a page texture. A newer render of the same texture
+// supersedes the pending one.
+static void post_texture_render_request(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  FlValue *textureIDKey = args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                              ? fl_value_lookup_string(args, "textureID")
+                              : nullptr;
+  if (!textureIDKey || fl_value_get_type(textureIDKey) != FL_VALUE_TYPE_INT)
+  {
+    g_autoptr(FlMethodResponse) response = create_error_response("InvalidArguments", "Texture ID not provided");
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
   }
-  else if (g_strcmp0(method, "getPage") == 0)
+
+  gint64 textureID = fl_value_get_int(textureIDKey);
+  auto it = self->textures->find(textureID);
+  if (it == self->textures->end())
+  {
+    g_autoptr(FlMethodResponse) response = create_error_response("TextureNotFound", "Texture not found");
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+
+  std::shared_ptr<pdfviewer::RenderToken> token;
+  gint64 requestID = 0;
+  FlValue *requestIDKey = fl_value_lookup_string(args, "requestID");
+  if (requestIDKey && fl_value_get_type(requestIDKey) == FL_VALUE_TYPE_INT)
+  {
+    requestID = fl_value_get_int(requestIDKey);
+    token = self->render_requests->Begin(requestID, "renderPageTexture:" + std::to_string(textureID));
+  }
+
+  std::shared_ptr<FlMethodCall> call(FL_METHOD_CALL(g_object_ref(method_call)), g_object_unref);
+  std::shared_ptr<PdfPageTexture> texture(PDF_PAGE_TEXTURE(g_object_ref(it->second)), g_object_unref);
+  std::shared_ptr<FlTextureRegistrar> registrar(FL_TEXTURE_REGISTRAR(g_object_ref(self->texture_registrar)),
+                                                g_object_unref);
+  pdfviewer::RenderRequestRegistry *render_requests = self->render_requests;
+  self->worker->Post([call, texture, registrar, token, requestID, render_requests]()
+                     {
+    FlMethodResponse *response = token && token->IsCancelled()
+                                     ? create_error_response("RenderCancelled", "Render request was cancelled")
+                                     : RenderPageTexture(call.get(), texture.get(), token.get());
+    if (token)
+      render_requests->End(requestID);
+    respond_on_main_thread(call.get(), response, registrar.get(), FL_TEXTURE(texture.get())); },
+                     pdfviewer::RenderPriority::kVisiblePage, respond_disposed(call));
+}
+
+// Queues the layout of the thumbnails of a document, then the passes that
+// generate them once the layout was computed
+static void post_thumbnail_request(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  FlValue *documentIDKey = args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                               ? fl_value_lookup_string(args, "documentID")
+                               : nullptr;
+  std::string documentID = documentIDKey && fl_value_get_type(documentIDKey) == FL_VALUE_TYPE_STRING
+                               ? fl_value_get_string(documentIDKey)
+                               : "";
+
+  std::shared_ptr<FlMethodCall> call(FL_METHOD_CALL(g_object_ref(method_call)), g_object_unref);
+  self->worker->Post([self, call, documentID]()
+                     {
+    respond_on_main_thread(call.get(), StartThumbnails(call.get()));
+    schedule_thumbnails(self, documentID);  },
+                     pdfviewer::RenderPriority::kVisibleTile, respond_disposed(call));
+}
+
+// Queues the range of the displayed thumbnails of a document, then the passes
+// that generate the thumbnails given up on memory pressure again
+static void post_visible_thumbnails(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  FlValue *documentIDKey = args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                               ? fl_value_lookup_string(args, "documentID")
+                               : nullptr;
+  std::string documentID = documentIDKey && fl_value_get_type(documentIDKey) == FL_VALUE_TYPE_STRING
+                               ? fl_value_get_string(documentIDKey)
+                               : "";
+
+  std::shared_ptr<FlMethodCall> call(FL_METHOD_CALL(g_object_ref(method_call)), g_object_unref);
+  self->worker->Post([self, call, documentID]()
+                     {
+    respond_on_main_thread(call.get(), SetVisibleThumbnails(call.get()));
+    schedule_thumbnails(self, documentID);  },
+                     pdfviewer::RenderPriority::kVisibleTile, respond_disposed(call));
+}
+
+// Queues the viewport hint of a document, then the prefetch passes it planned
+static void post_viewport_hint(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  FlValue *documentIDKey = args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                               ? fl_value_lookup_string(args, "documentID")
+                               : nullptr;
+  std::string documentID = documentIDKey && fl_value_get_type(documentIDKey) == FL_VALUE_TYPE_STRING
+                               ? fl_value_get_string(documentIDKey)
+                               : "";
+
+  std::shared_ptr<FlMethodCall> call(FL_METHOD_CALL(g_object_ref(method_call)), g_object_unref);
+  self->worker->Post([self, call, documentID]()
+                     {
+    respond_on_main_thread(call.get(), ViewportHint(call.get()));
+    schedule_prefetch(self, documentID);  },
+                     pdfviewer::RenderPriority::kVisibleTile, respond_disposed(call));
+}
+
+// Time a text search pass may take on the render worker before the next pass
+// is queued behind the renders posted meanwhile, in microseconds
+static const gint64 kTextSearchPassDuration = 8000;
+
+// Searches the next pages of a text search until the pass duration is used
+// up, reports the matches of each page with a textFound event and responds
+// with the match count once all pages were searched. Runs on the render worker.
+static void run_text_search_pass(SyncfusionPdfviewerLinuxPlugin *self, std::shared_ptr<FlMethodCall> call,
+                                 std::shared_ptr<pdfviewer::TextSearch> search, gint64 searchID)
+{
+  pdfviewer::PdfDocument *document = pdfviewer::GetPdfDocument(search->documentID().c_str());
+  gint64 deadline = g_get_monotonic_time() + kTextSearchPassDuration;
+  std::vector<pdfviewer::TextMatch> matches;
+  while (document && !search->IsComplete(document) && g_get_monotonic_time() < deadline)
+  {
+    int index = search->SearchNextPage(document, &matches);
+    if (matches.empty() || search->token()->IsCancelled())
+      continue;
+
+    // Each match has its rectangle count, followed by the rectangles of all
+    // matches as left, top, right and bottom
+    std::vector<int32_t> rectCounts;
+    std::vector<double> rects;
+    for (const pdfviewer::TextMatch &match : matches)
+    {
+      rectCounts.push_back(static_cast<int32_t>(match.rects.size()));
+      for (const FS_RECTF &rect : match.rects)
+      {
+        rects.push_back(rect.left);
+        rects.push_back(rect.top);
+        rects.push_back(rect.right);
+        rects.push_back(rect.bottom);
+      }
+    }
+    FlValue *event = new_document_event("textFound", search->documentID().c_str());
+    fl_value_set_string_take(event, "searchID", fl_value_new_int(searchID));
+    fl_value_set_string_take(event, "pageNumber", fl_value_new_int(index + 1));
+    fl_value_set_string_take(event, "rectCounts", fl_value_new_int32_list(rectCounts.data(), rectCounts.size()));
+    fl_value_set_string_take(event, "rects", fl_value_new_float_list(rects.data(), rects.size()));
+    send_event_on_main_thread(self, event);
+  }
+
+  if (document && !search->IsComplete(document))
+  {
+    self->worker->Post([self, call, search, searchID]()
+                       { run_text_search_pass(self, call, search, searchID); },
+                       pdfviewer::RenderPriority::kBackground, respond_disposed(call));
+    return;
+  }
+
+  self->text_searches->End(searchID);
+  if (!document)
+  {
+    respond_on_main_thread(call.get(), create_error_response("DocumentNotFound", "Document not found"));
+  }
+  else if (search->token()->IsCancelled())
+  {
+    respond_on_main_thread(call.get(), create_error_response("SearchCancelled", "Text search was cancelled"));
+  }
+  else
+  {
+    respond_on_main_thread(call.get(),
+                           FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_int(search->matchCount()))));
+  }
+}
+
+// Queues a text search of a document. A newer search of the same document
+// cancels the pending one, and cancelTextSearch stops it between two matches.
+static void post_text_search(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (!args || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+  {
+    g_autoptr(FlMethodResponse) response = create_error_response("InvalidArguments", "Invalid arguments");
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+
+  FlValue *documentIDKey = fl_value_lookup_string(args, "documentID");
+  FlValue *queryKey = fl_value_lookup_string(args, "query");
+  FlValue *searchIDKey = fl_value_lookup_string(args, "searchID");
+  if (!documentIDKey || fl_value_get_type(documentIDKey) != FL_VALUE_TYPE_STRING ||
+      !queryKey || fl_value_get_type(queryKey) != FL_VALUE_TYPE_STRING ||
+      !searchIDKey || fl_value_get_type(searchIDKey) != FL_VALUE_TYPE_INT)
+  {
+    g_autoptr(FlMethodResponse) response =
+        create_error_response("InvalidArguments", "Document ID, query or search ID not provided");
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+
+  int flags = 0;
+  FlValue *matchCaseKey = fl_value_lookup_string(args, "matchCase");
+  if (matchCaseKey && fl_value_get_type(matchCaseKey) == FL_VALUE_TYPE_BOOL && fl_value_get_bool(matchCaseKey))
+    flags |= pdfviewer::kTextSearchMatchCase;
+  FlValue *wholeWordKey = fl_value_lookup_string(args, "wholeWord");
+  if (wholeWordKey && fl_value_get_type(wholeWordKey) == FL_VALUE_TYPE_BOOL && fl_value_get_bool(wholeWordKey))
+    flags |= pdfviewer::kTextSearchWholeWord;
+
+  std::string documentID = fl_value_get_string(documentIDKey);
+  gint64 searchID = fl_value_get_int(searchIDKey);
+  std::shared_ptr<pdfviewer::RenderToken> token = self->text_searches->Begin(searchID, "searchText:" + documentID);
+  auto search = std::make_shared<pdfviewer::TextSearch>(documentID, fl_value_get_string(queryKey), flags, token);
+
+  std::string query = fl_value_get_string(queryKey);
+  std::shared_ptr<FlMethodCall> call(FL_METHOD_CALL(g_object_ref(method_call)), g_object_unref);
+  self->worker->Post([self, call, search, searchID, query]()
+                     {
+    // Once the text index is complete only the pages holding the words of
+    // the query are searched
+    pdfviewer::PdfDocument *document = pdfviewer::GetPdfDocument(search->documentID().c_str());
+    if (document && document->textIndex() && document->textIndex()->IsComplete())
+      search->SetPages(document->textIndex()->FindPages(query));
+    run_text_search_pass(self, call, search, searchID); },
+                     pdfviewer::RenderPriority::kBackground, respond_disposed(call));
+}
+
+// Method call handler, runs the matching handler on the render worker and
+// responds asynchronously so rendering never blocks the GTK main loop
+static void syncfusion_pdfviewer_linux_plugin_handle_method_call(
+    SyncfusionPdfviewerLinuxPlugin *self,
+    FlMethodCall *method_call)
+{
+  const gchar *method = fl_method_call_get_name(method_call);
+  if (g_strcmp0(method, "cancelRender") == 0)
+  {
+    // Cancellation is handled right away, it must not wait behind the renders
+    // it is meant to stop
+    g_autoptr(FlMethodResponse) response = CancelRender(self, method_call);
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+  else if (g_strcmp0(method, "getRenderStats") == 0)
+  {
+    // The stats are read without waiting behind the renders they measure
+    g_autoptr(FlMethodResponse) response = GetRenderStats(method_call);
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+  else if (g_strcmp0(method, "setCooperativeRendering") == 0)
+  {
+    g_autoptr(FlMethodResponse) response = SetCooperativeRendering(self, method_call);
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+  else if (g_strcmp0(method, "cancelTextSearch") == 0)
+  {
+    g_autoptr(FlMethodResponse) response = CancelTextSearch(self, method_call);
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+  else if (g_strcmp0(method, "createPageTexture") == 0)
+  {
+    g_autoptr(FlMethodResponse) response = CreatePageTexture(self, method_call);
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+  else if (g_strcmp0(method, "disposePageTexture") == 0)
+  {
+    g_autoptr(FlMethodResponse) response = DisposePageTexture(self, method_call);
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+  else if (g_strcmp0(method, "renderPageTexture") == 0)
+  {
+    post_texture_render_request(self, method_call);
+    return;
+  }
+  else if (g_strcmp0(method, "startThumbnails") == 0)
+  {
+    post_thumbnail_request(self, method_call);
+    return;
+  }
+  else if (g_strcmp0(method, "setVisibleThumbnails") == 0)
+  {
+    post_visible_thumbnails(self, method_call);
+    return;
+  }
+  else if (g_strcmp0(method, "searchText") == 0)
+  {
+    post_text_search(self, method_call);
+    return;
+  }
+  else if (g_strcmp0(method, "viewportHint") == 0)
+  {
+    post_viewport_hint(self, method_call);
+    return;
+  }
+
+  OpenHandler open_handler = find_open_handler(method);
+  if (open_handler)
+  {
+    post_open_request(self, method_call, open_handler);
+    return;
+  }
+
+  RenderHandler render_handler = find_render_handler(method);
+  if (render_handler)
+  {
+    post_render_request(self, method_call, render_handler);
+    return;
+  }
+
+  MethodHandler handler = find_method_handler(method);
+  if (!handler)
+  {
+    g_autoptr(FlMethodResponse) response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+
+  std::shared_ptr<FlMethodCall> call(FL_METHOD_CALL(g_object_ref(method_call)), g_object_unref);
+  self->worker->Post([handler, call]()
+                     { respond_on_main_thread(call.get(), handler(call.get())); },
+                     pdfviewer::RenderPriority::kVisibleTile, respond_disposed(call));
+}
+
+// Reply to a document chunk, sent from the main loop once the chunk is copied
+typedef struct
+{
+  FlBinaryMessenger *messenger;
+  FlBinaryMessengerResponseHandle *response_handle;
+} PendingChunkReply;
+
+static gboolean pending_chunk_reply_send_cb(gpointer user_data)
+{
+  PendingChunkReply *pending = static_cast<PendingChunkReply *>(user_data);
+  fl_binary_messenger_send_response(pending->messenger, pending->response_handle, nullptr, nullptr);
+  return G_SOURCE_REMOVE;
+}
+
+static void pending_chunk_reply_free(gpointer user_data)
+{
+  PendingChunkReply *pending = static_cast<PendingChunkReply *>(user_data);
+  g_object_unref(pending->messenger);
+  g_object_unref(pending->response_handle);
+  g_free(pending);
+}
+
+// Document chunk handler. The chunk is copied into the upload buffer on the
+// render worker, which keeps it ordered with the finalizeDocumentUpload call
+// of the same upload. The reply is delayed until the copy is done, so Dart
+// never has more than the chunk in flight waiting in native memory.
+static void document_chunk_cb(FlBinaryMessenger *messenger, const gchar *channel, GBytes *message,
+                              FlBinaryMessengerResponseHandle *response_handle, gpointer user_data)
+{
+  SyncfusionPdfviewerLinuxPlugin *self = SYNCFUSION_PDFVIEWER_LINUX_PLUGIN(user_data);
+  PendingChunkReply *pending = g_new0(PendingChunkReply, 1);
+  pending->messenger = FL_BINARY_MESSENGER(g_object_ref(messenger));
+  pending->response_handle = FL_BINARY_MESSENGER_RESPONSE_HANDLE(g_object_ref(response_handle));
+
+  GBytes *chunk = message ? g_bytes_ref(message) : nullptr;
+  self->worker->Post([self, chunk, pending]()
+                     {
+    if (chunk)
+    {
+      gsize size = 0;
+      const guint8 *data = static_cast<const guint8 *>(g_bytes_get_data(chunk, &size));
+      if (size >= pdfviewer::kDocumentChunkHeaderSize)
+      {
+        gint64 uploadID = 0;
+        gint64 offset = 0;
+        memcpy(&uploadID, data, sizeof(uploadID));
+        memcpy(&offset, data + sizeof(uploadID), sizeof(offset));
+        if (pdfviewer::AppendDocumentChunk(GINT64_FROM_LE(uploadID), static_cast<gsize>(GINT64_FROM_LE(offset)),
+                                           data + pdfviewer::kDocumentChunkHeaderSize,
+                                           size - pdfviewer::kDocumentChunkHeaderSize))
+        {
+          update_progressive_document(self, GINT64_FROM_LE(uploadID));
+        }
+      }
+      g_bytes_unref(chunk);
+    }
+    g_main_context_invoke_full(nullptr, G_PRIORITY_DEFAULT, pending_chunk_reply_send_cb,
+                               pending, pending_chunk_reply_free); },
+                     pdfviewer::RenderPriority::kVisibleTile, [chunk, pending]()
+                     {
+    // The plugin was disposed before the chunk was copied, the reply still
+    // completes the send of Dart
+    if (chunk)
+      g_bytes_unref(chunk);
+    g_main_context_invoke_full(nullptr, G_PRIORITY_DEFAULT, pending_chunk_reply_send_cb,
+                               pending, pending_chunk_reply_free); });
+}
+
+// Low memory warning of the system. The more severe the warning, the more
+// tiers of cached memory the render worker gives up, ahead of queued renders.
+static void low_memory_warning_cb(GMemoryMonitor *monitor, GMemoryMonitorWarningLevel level, gpointer user_data)
+{
+  SyncfusionPdfviewerLinuxPlugin *self = SYNCFUSION_PDFVIEWER_LINUX_PLUGIN(user_data);
+  if (!self->worker)
+    return;
+
+  pdfviewer::MemoryTier tier = pdfviewer::MemoryTier::kTiles;
+  if (level >= G_MEMORY_MONITOR_WARNING_LEVEL_CRITICAL)
+    tier = pdfviewer::MemoryTier::kImageCaches;
+  else if (level >= G_MEMORY_MONITOR_WARNING_LEVEL_MEDIUM)
+    tier = pdfviewer::MemoryTier::kPageHandles;
+  self->worker->Post([tier]()
+                     { pdfviewer::ReclaimMemory(tier, 0); }, pdfviewer::RenderPriority::kVisibleTile);
+}
+
+// Initialization and disposal methods
+static void syncfusion_pdfviewer_linux_plugin_dispose(GObject *object)
+{
+  SyncfusionPdfviewerLinuxPlugin *self = SYNCFUSION_PDFVIEWER_LINUX_PLUGIN(object);
+  if (self->memory_monitor)
+  {
+    g_signal_handler_disconnect(self->memory_monitor, self->low_memory_handler);
+    g_clear_object(&self->memory_monitor);
+  }
+  delete self->worker;
+  self->worker = nullptr;
+  // Waits for the renders in the helper processes, which still respond
+  pdfviewer::RenderFarm::Shared().Stop();
+  delete self->render_requests;
+  self->render_requests = nullptr;
+  delete self->text_searches;
+  self->text_searches = nullptr;
+  if (self->textures)
+  {
+    for (auto &texture : *self->textures)
+    {
+      fl_texture_registrar_unregister_texture(self->texture_registrar, FL_TEXTURE(texture.second));
+      g_object_unref(texture.second);
+    }
+    delete self->textures;
+    self->textures = nullptr;
+  }
+  g_clear_object(&self->event_channel);
+  g_clear_object(&self->texture_registrar);
+
+  G_OBJECT_CLASS(syncfusion_pdfviewer_linux_plugin_parent_class)->dispose(object);
+}
+
+static void syncfusion_pdfviewer_linux_plugin_class_init(SyncfusionPdfviewerLinuxPluginClass *klass)
+{
+  G_OBJECT_CLASS(klass)->dispose = syncfusion_pdfviewer_linux_plugin_dispose;
+}
+
+static void syncfusion_pdfviewer_linux_plugin_init(SyncfusionPdfviewerLinuxPlugin *self)
+{
+  self->worker = new pdfviewer::RenderWorker();
+  self->render_requests = new pdfviewer::RenderRequestRegistry();
+  self->text_searches = new pdfviewer::RenderRequestRegistry();
+  self->textures = new std::unordered_map<gint64, PdfPageTexture *>();
+  self->memory_monitor = g_memory_monitor_dup_default();
+  if (self->memory_monitor)
+  {
+    self->low_memory_handler = g_signal_connect(self->memory_monitor, "low-memory-warning",
+                                                G_CALLBACK(low_memory_warning_cb), self);
+  }
+}
+
+static void method_call_cb(FlMethodChannel *channel, FlMethodCall *method_call, gpointer user_data)
+{
+  SyncfusionPdfviewerLinuxPlugin *plugin = SYNCFUSION_PDFVIEWER_LINUX_PLUGIN(user_data);
+  syncfusion_pdfviewer_linux_plugin_handle_method_call(plugin, method_call);
+}
+
+// Plugin registration
+void syncfusion_pdfviewer_linux_plugin_register_with_registrar(FlPluginRegistrar *registrar)
+{
+  SyncfusionPdfviewerLinuxPlugin *plugin = SYNCFUSION_PDFVIEWER_LINUX_PLUGIN(
+      g_object_new(syncfusion_pdfviewer_linux_plugin_get_type(), nullptr));
+  plugin->texture_registrar = FL_TEXTURE_REGISTRAR(g_object_ref(fl_plugin_registrar_get_texture_registrar(registrar)));
+
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  g_autoptr(FlMethodChannel) channel =
+      fl_method_channel_new(fl_plugin_registrar_get_messenger(registrar),
+                            "syncfusion_flutter_pdfviewer",
+                            FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(channel, method_call_cb,
+                                            g_object_ref(plugin),
+                                            g_object_unref);
+  plugin->event_channel = fl_event_channel_new(fl_plugin_registrar_get_messenger(registrar),
+                                               "syncfusion_flutter_pdfviewer/events",
+                                               FL_METHOD_CODEC(codec));
+  fl_binary_messenger_set_message_handler_on_channel(fl_plugin_registrar_get_messenger(registrar),
+                                                     pdfviewer::kDocumentUploadChannel, document_chunk_cb,
+                                                     g_object_ref(plugin), g_object_unref);
+
+  g_object_unref(plugin);
+}
+
+// Function to initialize PDF renderer
+FlMethodResponse *InitializePDFRenderer(FlMethodCall *method_call, const pdfviewer::OpenProgress &progress)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP)
+  {
+    FlValue *idKey = fl_value_lookup_string(args, "documentID");
+    const gchar *documentID = idKey ? fl_value_get_string(idKey) : "";
+
+    FlValue *documentBytesKey = fl_value_lookup_string(args, "documentBytes");
+    const uint8_t *bytesValue = documentBytesKey ? fl_value_get_uint8_list(documentBytesKey) : nullptr;
+    gsize size = fl_value_get_length(documentBytesKey);
+
+    FlValue *passwordKey = fl_value_lookup_string(args, "password");
+    const gchar *password = "";
+    if (passwordKey && fl_value_get_type(passwordKey) == FL_VALUE_TYPE_STRING) {
+      password = fl_value_get_string(passwordKey);
+    }
+
+    if (documentID && bytesValue != nullptr && size > 0)
+    {
+      g_autoptr(GBytes) data = g_bytes_new(bytesValue, size);
+      auto document = pdfviewer::InitializePdfRenderer(data, password, documentID, progress);
+      if (document)
+      {
+        int pageCount = FPDF_GetPageCount(document->pdfDocument());
+        FlValue *result = fl_value_new_string(g_strdup_printf("%d", pageCount));
+        return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+      }
+    }
+  }
+  return create_error_response("InvalidArguments", "Initialization failed");
+}
+
+// Function to start a chunked document upload. The chunks are streamed over
+// the binary upload channel into one buffer of the given length.
+FlMethodResponse *BeginDocumentUpload(FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
+
+  FlValue *lengthKey = fl_value_lookup_string(args, "length");
+  gint64 length = lengthKey ? fl_value_get_int(lengthKey) : 0;
+  if (length <= 0)
+    return create_error_response("InvalidArguments", "Document length not provided");
+
+  gint64 uploadID = pdfviewer::BeginDocumentUpload(static_cast<gsize>(length));
+  if (uploadID == 0)
+    return create_error_response("OutOfMemory", "Unable to allocate the document buffer");
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_int(uploadID)));
+}
+
+// Function to give up a chunked upload that will not be finalized, releasing
+// its buffer. Chunks of the upload still in flight are dropped. The upload of
+// a progressive document is released by closing the document instead.
+FlMethodResponse *AbortDocumentUpload(FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
+
+  FlValue *uploadIDKey = fl_value_lookup_string(args, "uploadID");
+  if (!uploadIDKey || fl_value_get_type(uploadIDKey) != FL_VALUE_TYPE_INT)
+    return create_error_response("InvalidArguments", "Upload ID not provided");
+
+  gint64 uploadID = fl_value_get_int(uploadIDKey);
+  bool aborted = pdfviewer::GetDocumentUpload(uploadID) && !pdfviewer::FindProgressiveDocument(uploadID);
+  if (aborted)
+    pdfviewer::CancelDocumentUpload(uploadID);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_bool(aborted)));
+}
+
+// Function to initialize PDF renderer from the buffer of a completed upload
+FlMethodResponse *FinalizeDocumentUpload(FlMethodCall *method_call, const pdfviewer::OpenProgress &progress)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
+
+  FlValue *uploadIDKey = fl_value_lookup_string(args, "uploadID");
+  FlValue *idKey = fl_value_lookup_string(args, "documentID");
+  const gchar *documentID = idKey ? fl_value_get_string(idKey) : nullptr;
+  FlValue *passwordKey = fl_value_lookup_string(args, "password");
+  const gchar *password = "";
+  if (passwordKey && fl_value_get_type(passwordKey) == FL_VALUE_TYPE_STRING)
+  {
+    password = fl_value_get_string(passwordKey);
+  }
+
+  g_autoptr(GBytes) data = uploadIDKey ? pdfviewer::FinishDocumentUpload(fl_value_get_int(uploadIDKey)) : nullptr;
+  if (!data)
+    return create_error_response("InvalidArguments", "Document upload incomplete");
+  if (!documentID)
+    return create_error_response("InvalidArguments", "Document ID not provided");
+
+  auto document = pdfviewer::InitializePdfRenderer(data, password, documentID, progress);
+  if (!document)
+    return create_error_response("InvalidArguments", "Initialization failed");
+
+  int pageCount = FPDF_GetPageCount(document->pdfDocument());
+  g_autofree gchar *pageCountString = g_strdup_printf("%d", pageCount);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_string(pageCountString)));
+}
+
+// Function to start opening a document while its bytes are still arriving.
+// The bytes are sent like a chunked upload, in any order, and the document
+// events report when the document and each page become available.
+FlMethodResponse *BeginProgressiveDocument(FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
+
+  FlValue *idKey = fl_value_lookup_string(args, "documentID");
+  const gchar *documentID = idKey ? fl_value_get_string(idKey) : nullptr;
+  FlValue *lengthKey = fl_value_lookup_string(args, "length");
+  gint64 length = lengthKey ? fl_value_get_int(lengthKey) : 0;
+  FlValue *passwordKey = fl_value_lookup_string(args, "password");
+  const gchar *password = "";
+  if (passwordKey && fl_value_get_type(passwordKey) == FL_VALUE_TYPE_STRING)
+  {
+    password = fl_value_get_string(passwordKey);
+  }
+  FlValue *rangeRequestsKey = fl_value_lookup_string(args, "rangeRequests");
+  bool rangeRequests = rangeRequestsKey && fl_value_get_type(rangeRequestsKey) == FL_VALUE_TYPE_BOOL &&
+                       fl_value_get_bool(rangeRequestsKey);
+
+  if (!documentID)
+    return create_error_response("InvalidArguments", "Document ID not provided");
+  if (length <= 0)
+    return create_error_response("InvalidArguments", "Document length not provided");
+
+  gint64 uploadID = pdfviewer::BeginDocumentUpload(static_cast<gsize>(length));
+  if (uploadID == 0)
+    return create_error_response("OutOfMemory", "Unable to allocate the document buffer");
+
+  pdfviewer::ProgressiveDocument *source = pdfviewer::BeginProgressivePdfDocument(uploadID, password, documentID);
+  if (!source)
+  {
+    pdfviewer::CancelDocumentUpload(uploadID);
+    return create_error_response("InvalidArguments", "Initialization failed");
+  }
+  source->SetRangeRequestsEnabled(rangeRequests);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_int(uploadID)));
+}
+
+// Function to check whether the data of a page has arrived
+FlMethodResponse *IsPageAvailable(FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
+
+  FlValue *idKey = fl_value_lookup_string(args, "documentID");
+  const gchar *documentID = idKey ? fl_value_get_string(idKey) : nullptr;
+  FlValue *pageNumberKey = fl_value_lookup_string(args, "pageNumber");
+  int pageNumber = pageNumberKey ? fl_value_get_int(pageNumberKey) : 0;
+
+  if (!documentID)
+    return create_error_response("InvalidArguments", "Document ID not provided");
+
+  // Documents still waiting for their structure have no available pages
+  auto documentPtr = pdfviewer::GetPdfDocument(documentID);
+  bool available = documentPtr && pageNumber >= 1 && pageNumber <= documentPtr->pageCount() &&
+                   documentPtr->IsPageAvailable(pageNumber - 1);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_bool(available)));
+}
+
+// Function to initialize PDF renderer from a URI
+FlMethodResponse *LoadPdfFromFile(FlMethodCall *method_call, const pdfviewer::OpenProgress &progress) {
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP) {
+    FlValue *path_key = fl_value_lookup_string(args, "path");
+    const gchar *path = fl_value_get_string(path_key);
+    FlValue *idKey = fl_value_lookup_string(args, "documentID");
+    const gchar *documentID = idKey ? fl_value_get_string(idKey) : "";
+    FlValue *passwordKey = fl_value_lookup_string(args, "password");
+    const gchar *password = "";
+    if (passwordKey && fl_value_get_type(passwordKey) == FL_VALUE_TYPE_STRING) {
+      password = fl_value_get_string(passwordKey);
+    }
+
+    auto document = pdfviewer::LoadPdfFromFile(path, password, documentID, progress);
+    if (document) {
+      int pageCount = FPDF_GetPageCount(document->pdfDocument());
+      FlValue *result = fl_value_new_string(g_strdup_printf("%d", pageCount));
+      return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    }
+    return create_error_response("InitializationFailed", "Unable to initialize PDF document from provided path");
+  }
+  return create_error_response("InvalidArguments", "Expected a map of arguments");
+}
+
+// Function to get pages' heights
+FlMethodResponse *GetPagesHeight(FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  const gchar *documentID = fl_value_get_string(args) ?: "";
+
+  if (!documentID)
+    return create_error_response("InvalidArguments", "Document ID not provided");
+
+  auto documentPtr = pdfviewer::GetPdfDocument(documentID);
+  if (!documentPtr)
+    return create_error_response("DocumentNotFound", "Document not found");
+
+  int pageCount = documentPtr->pageCount();
+  FlValue *flPageHeights = fl_value_new_list();
+
+  for (int i = 0; i < pageCount; ++i)
+  {
+    double height = documentPtr->GetPageGeometry(i, false).height;
+    fl_value_append_take(flPageHeights, fl_value_new_float(height));
+  }
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(flPageHeights));
+}
+
+// Function to get pages' widths
+FlMethodResponse *GetPagesWidth(FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  const gchar *documentID = fl_value_get_string(args) ?: "";
+
+  if (!documentID)
+    return create_error_response("InvalidArguments", "Document ID not provided");
+
+  auto documentPtr = pdfviewer::GetPdfDocument(documentID);
+  if (!documentPtr)
+    return create_error_response("DocumentNotFound", "Document not found");
+
+  int pageCount = documentPtr->pageCount();
+  FlValue *flPageWidths = fl_value_new_list();
+
+  for (int i = 0; i < pageCount; ++i)
+  {
+    double width = documentPtr->GetPageGeometry(i, false).width;
+    fl_value_append_take(flPageWidths, fl_value_new_float(width));
+  }
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(flPageWidths));
+}
+
+// Number of values per page in the getPageGeometry result: page number,
+// width, height, rotation and the left, top, right and bottom of the crop box
+static const int kPageGeometryStride = 8;
+
+// Function to get the geometry of the pages from the document's geometry index.
+//
+// The optional ranges hold first and last page number pairs. The rotation and
+// crop box are NaN unless includePageBoxes is set, as reading them loads the
+// page. Labels are returned in a separate list, in the same page order.
+FlMethodResponse *GetPageGeometry(FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
+
+  FlValue *documentIDKey = fl_value_lookup_string(args, "documentID");
+  const gchar *documentID = documentIDKey ? fl_value_get_string(documentIDKey) : nullptr;
+  if (!documentID)
+    return create_error_response("InvalidArguments", "Document ID not provided");
+
+  auto documentPtr = pdfviewer::GetPdfDocument(documentID);
+  if (!documentPtr)
+    return create_error_response("DocumentNotFound", "Document not found");
+
+  FlValue *includePageBoxesKey = fl_value_lookup_string(args, "includePageBoxes");
+  bool includePageBoxes = includePageBoxesKey && fl_value_get_type(includePageBoxesKey) == FL_VALUE_TYPE_BOOL &&
+                          fl_value_get_bool(includePageBoxesKey);
+
+  int pageCount = documentPtr->pageCount();
+  std::vector<std::pair<int, int>> ranges;
+  FlValue *rangesKey = fl_value_lookup_string(args, "ranges");
+  if (rangesKey && fl_value_get_type(rangesKey) == FL_VALUE_TYPE_INT32_LIST)
+  {
+    const int32_t *pairs = fl_value_get_int32_list(rangesKey);
+    size_t length = fl_value_get_length(rangesKey);
+    for (size_t i = 0; i + 1 < length; i += 2)
+    {
+      int first = std::max(1, static_cast<int>(pairs[i]));
+      int last = std::min(pageCount, static_cast<int>(pairs[i + 1]));
+      if (first <= last)
+        ranges.emplace_back(first, last);
+    }
+  }
+  else if (pageCount > 0)
+  {
+    ranges.emplace_back(1, pageCount);
+  }
+
+  std::vector<double> geometry;
+  FlValue *labels = fl_value_new_list();
+  for (const auto &range : ranges)
+  {
+    for (int pageNumber = range.first; pageNumber <= range.second; ++pageNumber)
+    {
+      const pdfviewer::PageGeometry &page = documentPtr->GetPageGeometry(pageNumber - 1, includePageBoxes);
+      bool hasPageBoxes = page.has_page_boxes;
+      geometry.push_back(pageNumber);
+      geometry.push_back(page.width);
+      geometry.push_back(page.height);
+      geometry.push_back(hasPageBoxes ? page.rotation : NAN);
+      geometry.push_back(hasPageBoxes ? page.crop_box.left : NAN);
+      geometry.push_back(hasPageBoxes ? page.crop_box.top : NAN);
+      geometry.push_back(hasPageBoxes ? page.crop_box.right : NAN);
+      geometry.push_back(hasPageBoxes ? page.crop_box.bottom : NAN);
+      fl_value_append_take(labels, fl_value_new_string(page.label.c_str()));
+    }
+  }
+
+  FlValue *result = fl_value_new_map();
+  fl_value_set_string_take(result, "pageCount", fl_value_new_int(pageCount));
+  fl_value_set_string_take(result, "stride", fl_value_new_int(kPageGeometryStride));
+  fl_value_set_string_take(result, "geometry", fl_value_new_float_list(geometry.data(), geometry.size()));
+  fl_value_set_string_take(result, "labels", labels);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Function to convert FPDF_BITMAP to FlValue holding tightly packed RGBA rows
+FlValue *ConvertBitmapToFlValue(FPDF_BITMAP bitmap, int width, int height, const gchar *document_id)
+{
+  pdfviewer::ScopedPhaseTimer timer(document_id, pdfviewer::RenderPhase::kConvert);
+  uint8_t *pixels = static_cast<uint8_t *>(FPDFBitmap_GetBuffer(bitmap));
+  size_t rowSize = static_cast<size_t>(width) * 4;
+  size_t stride = static_cast<size_t>(FPDFBitmap_GetStride(bitmap));
+
+  // Drop the row padding in place, the FlValue keeps its own copy, so the
+  // bitmap memory is copied only once
+  if (stride != rowSize)
+  {
+    for (int row = 1; row < height; ++row)
+      std::memmove(pixels + row * rowSize, pixels + row * stride, rowSize);
+  }
+  return fl_value_new_uint8_list(pixels, rowSize * height);
+}
+
+// Function to create the response of a page or tile render
+FlMethodResponse *CreateRenderResponse(pdfviewer::RenderStatus status, FPDF_BITMAP bitmap, int width, int height,
+                                       const gchar *document_id)
+{
+  if (status == pdfviewer::RenderStatus::kCancelled)
+    return create_error_response("RenderCancelled", "Render request was cancelled");
+  if (status != pdfviewer::RenderStatus::kDone)
+    return create_error_response("RenderFailed", "Unable to render the page");
+
+  // Convert and get FlValue
+  FlValue *result = ConvertBitmapToFlValue(bitmap, width, height, document_id);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Function to create the response of a page or tile rendered by a helper
+// process, the pixels are already tightly packed RGBA rows
+FlMethodResponse *CreateFarmRenderResponse(pdfviewer::FarmRenderStatus status, const guint8 *pixels, gsize size)
+{
+  switch (status)
+  {
+  case pdfviewer::FarmRenderStatus::kDone:
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_uint8_list(pixels, size)));
+  case pdfviewer::FarmRenderStatus::kCancelled:
+    return create_error_response("RenderCancelled", "Render request was cancelled");
+  case pdfviewer::FarmRenderStatus::kPageNotFound:
+    return create_error_response("PageNotFound", "Page not found");
+  default:
+    return create_error_response("RenderFailed", "Unable to render the page");
+  }
+}
+
+// Function to get a page's image
+FlMethodResponse *GetPdfPageImage(FlMethodCall *method_call, const pdfviewer::RenderToken *token)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
+
+  int index = fl_value_get_int(fl_value_lookup_string(args, "index"));
+  int width = fl_value_get_int(fl_value_lookup_string(args, "width"));
+  int height = fl_value_get_int(fl_value_lookup_string(args, "height"));
+  const gchar *documentID = fl_value_get_string(fl_value_lookup_string(args, "documentID"));
+  pdfviewer::RenderQuality quality;
+
+  if (!documentID)
+    return create_error_response("InvalidArguments", "Document ID not provided");
+  if (!read_render_quality(args, &quality))
+    return create_error_response("InvalidArguments", "Unknown render quality");
+
+  auto documentPtr = pdfviewer::GetPdfDocument(documentID);
+  if (!documentPtr)
+    return create_error_response("DocumentNotFound", "Document not found");
+
+  // The page may have been prerendered ahead of a fling
+  int flags = pdfviewer::GetQualityRenderFlags(FPDF_LCD_TEXT | FPDF_REVERSE_BYTE_ORDER, quality);
+  pdfviewer::PageImageCache &pageImages = documentPtr->pageImages();
+  pageImages.SetLastRequest(index - 1, width, height, flags);
+  gsize capacity = 0;
+  guint8 *pixels = pageImages.Take(index - 1, width, height, flags, &capacity);
+  if (pixels)
+  {
+    FlValue *result = fl_value_new_uint8_list(pixels, static_cast<size_t>(width) * height * 4);
+    pdfviewer::BitmapBufferPool::Shared().Release(pixels, capacity);
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  }
+
+  // Pinned, the jobs run while the render yields cannot close the page
+  pdfviewer::PinnedPage pinnedPage(documentPtr, index - 1);
+  FPDF_PAGE page = pinnedPage.page();
+  if (!page)
+    return create_error_response("PageNotFound", "Page not found");
+
+  // Render into pooled memory, released back to the pool when out of scope
+  pdfviewer::PooledBitmap pooledBitmap(width, height);
+  FPDF_BITMAP bitmap = pooledBitmap.bitmap();
+  if (!bitmap)
+    return create_error_response("OutOfMemory", "Unable to allocate the page bitmap");
+  FPDFBitmap_FillRect(bitmap, 0, 0, width, height, 0xFFFFFFFF);
+  pdfviewer::RenderStatus status =
+      pdfviewer::RenderPageProgressive(bitmap, page, 0, 0, width, height, flags, token, documentID);
+
+  return CreateRenderResponse(status, bitmap, width, height, documentID);
+}
+
+// Function to get tile image from a PDF page
+FlMethodResponse *GetPdfPageTileImage(FlMethodCall *method_call, const pdfviewer::RenderToken *token)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
+
+  int pageNumber = fl_value_get_int(fl_value_lookup_string(args, "pageNumber"));
+  double scale = fl_value_get_float(fl_value_lookup_string(args, "scale"));
+  const gchar *documentID = fl_value_get_string(fl_value_lookup_string(args, "documentID"));
+  double x = fl_value_get_float(fl_value_lookup_string(args, "x"));
+  double y = fl_value_get_float(fl_value_lookup_string(args, "y"));
+  int width = static_cast<int>(fl_value_get_float(fl_value_lookup_string(args, "width")));
+  int height = static_cast<int>(fl_value_get_float(fl_value_lookup_string(args, "height")));
+  pdfviewer::RenderQuality quality;
+
+  if (!documentID)
+    return create_error_response("InvalidArguments", "Document ID not provided");
+  if (!read_render_quality(args, &quality))
+    return create_error_response("InvalidArguments", "Unknown render quality");
+
+  auto documentPtr = pdfviewer::GetPdfDocument(documentID);
+  if (!documentPtr)
+    return create_error_response("DocumentNotFound", "Document not found");
+
+  pdfviewer::PinnedPage pinnedPage(documentPtr, pageNumber - 1);
+  FPDF_PAGE page = pinnedPage.page();
+  if (!page)
+    return create_error_response("PageNotFound", "Page not found");
+
+  // Place the whole page at the requested scale so that the tile region lands
+  // at the bitmap origin, the same transform FPDF_RenderPageBitmapWithMatrix
+  // would apply, but renderable progressively.
+  int startX, startY, pageWidth, pageHeight;
+  pdfviewer::GetTilePlacement(page, x, y, scale, &startX, &startY, &pageWidth, &pageHeight);
+
+  // Render into pooled memory, released back to the pool when out of scope
+  pdfviewer::PooledBitmap pooledBitmap(width, height);
+  FPDF_BITMAP bitmap = pooledBitmap.bitmap();
+  if (!bitmap)
+    return create_error_response("OutOfMemory", "Unable to allocate the tile bitmap");
+  FPDFBitmap_FillRect(bitmap, 0, 0, width, height, 0xFFFFFFFF);
+  pdfviewer::RenderStatus status = pdfviewer::RenderPageProgressive(
+      bitmap, page, startX, startY, pageWidth, pageHeight,
+      pdfviewer::GetQualityRenderFlags(FPDF_LCD_TEXT | FPDF_REVERSE_BYTE_ORDER, quality), token, documentID);
+
+  return CreateRenderResponse(status, bitmap, width, height, documentID);
+}
+
+// Function to get the fixed grid tiles covering a region of a page.
+//
+// The scale is quantized to a zoom bucket and the region, given in page points,
+// is covered by kGridTileSize square tiles of the page rendered at that bucket.
+// Tiles come from the shared tile cache when possible. Tiles listed in
+// knownTiles for the same bucket are returned without pixels, as Dart already
+// holds them.
+FlMethodResponse *GetGridTiles(FlMethodCall *method_call, const pdfviewer::RenderToken *token)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
+
+  int pageNumber = fl_value_get_int(fl_value_lookup_string(args, "pageNumber"));
+  double scale = fl_value_get_float(fl_value_lookup_string(args, "scale"));
+  const gchar *documentID = fl_value_get_string(fl_value_lookup_string(args, "documentID"));
+  double x = fl_value_get_float(fl_value_lookup_string(args, "x"));
+  double y = fl_value_get_float(fl_value_lookup_string(args, "y"));
+  double width = fl_value_get_float(fl_value_lookup_string(args, "width"));
+  double height = fl_value_get_float(fl_value_lookup_string(args, "height"));
+
+  if (!documentID)
+    return create_error_response("InvalidArguments", "Document ID not provided");
+  if (scale <= 0)
+    return create_error_response("InvalidArguments", "Scale must be positive");
+
+  auto documentPtr = pdfviewer::GetPdfDocument(documentID);
+  if (!documentPtr)
+    return create_error_response("DocumentNotFound", "Document not found");
+
+  FPDF_PAGE page = documentPtr->LoadPage(pageNumber - 1);
+  if (!page)
+    return create_error_response("PageNotFound", "Page not found");
+
+  int zoomBucket = pdfviewer::GetZoomBucket(scale);
+  double bucketScale = pdfviewer::GetZoomBucketScale(zoomBucket);
+  int pageWidth = 0;
+  int pageHeight = 0;
+  pdfviewer::GetPagePixelSize(page, zoomBucket, &pageWidth, &pageHeight);
+
+  int lastColumn = (pageWidth - 1) / pdfviewer::kGridTileSize;
+  int lastRow = (pageHeight - 1) / pdfviewer::kGridTileSize;
+  int firstVisibleColumn = std::max(0, static_cast<int>(std::floor(x * bucketScale / pdfviewer::kGridTileSize)));
+  int firstVisibleRow = std::max(0, static_cast<int>(std::floor(y * bucketScale / pdfviewer::kGridTileSize)));
+  int lastVisibleColumn = std::min(lastColumn, static_cast<int>(std::ceil((x + width) * bucketScale / pdfviewer::kGridTileSize)) - 1);
+  int lastVisibleRow = std::min(lastRow, static_cast<int>(std::ceil((y + height) * bucketScale / pdfviewer::kGridTileSize)) - 1);
+
+  // Tiles Dart already displays, as column and row pairs
+  std::vector<std::pair<int, int>> knownTiles;
+  FlValue *knownScaleKey = fl_value_lookup_string(args, "knownScale");
+  FlValue *knownTilesKey = fl_value_lookup_string(args, "knownTiles");
+  if (knownScaleKey && fl_value_get_type(knownScaleKey) == FL_VALUE_TYPE_FLOAT &&
+      pdfviewer::GetZoomBucket(fl_value_get_float(knownScaleKey)) == zoomBucket &&
+      knownTilesKey && fl_value_get_type(knownTilesKey) == FL_VALUE_TYPE_INT32_LIST)
+  {
+    const int32_t *pairs = fl_value_get_int32_list(knownTilesKey);
+    size_t length = fl_value_get_length(knownTilesKey);
+    for (size_t i = 0; i + 1 < length; i += 2)
+    {
+      knownTiles.emplace_back(pairs[i], pairs[i + 1]);
+    }
+  }
+
+  g_autoptr(FlValue) tiles = fl_value_new_list();
+  for (int row = firstVisibleRow; row <= lastVisibleRow; ++row)
+  {
+    for (int column = firstVisibleColumn; column <= lastVisibleColumn; ++column)
+    {
+      if (token && token->IsCancelled())
+        return create_error_response("RenderCancelled", "Render request was cancelled");
+
+      FlValue *tile = fl_value_new_map();
+      fl_value_set_string_take(tile, "column", fl_value_new_int(column));
+      fl_value_set_string_take(tile, "row", fl_value_new_int(row));
+      if (std::find(knownTiles.begin(), knownTiles.end(), std::make_pair(column, row)) != knownTiles.end())
+      {
+        fl_value_append_take(tiles, tile);
+        continue;
+      }
+
+      int tileWidth = 0;
+      int tileHeight = 0;
+      GBytes *pixels = pdfviewer::GetGridTile(documentPtr, pageNumber - 1, zoomBucket, column, row, token,
+                                              &tileWidth, &tileHeight);
+      if (!pixels)
+      {
+        fl_value_unref(tile);
+        if (token && token->IsCancelled())
+          return create_error_response("RenderCancelled", "Render request was cancelled");
+        continue;
+      }
+
+      gsize size = 0;
+      const uint8_t *data = static_cast<const uint8_t *>(g_bytes_get_data(pixels, &size));
+      fl_value_set_string_take(tile, "width", fl_value_new_int(tileWidth));
+      fl_value_set_string_take(tile, "height", fl_value_new_int(tileHeight));
+      fl_value_set_string_take(tile, "pixels", fl_value_new_uint8_list(data, size));
+      g_bytes_unref(pixels);
+      fl_value_append_take(tiles, tile);
+    }
+  }
+
+  FlValue *result = fl_value_new_map();
+  fl_value_set_string_take(result, "scale", fl_value_new_float(bucketScale));
+  fl_value_set_string_take(result, "tileSize", fl_value_new_int(pdfviewer::kGridTileSize));
+  fl_value_set_string_take(result, "tiles", fl_value_ref(tiles));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Number of values per page in the renderPages requests: page number, width
+// and height
+static const int kRenderPagesStride = 3;
+
+// Function to render many pages in one call, such as a strip of thumbnails.
+//
+// Every page is rendered straight into its slot of a single buffer, so the
+// batch costs one method call and one allocation. The result holds the
+// `pixels` of all pages, each as tightly packed RGBA rows, and the `offsets`
+// of each page in them, with one more offset marking the end. Pages that are missing or not yet available are
+// left empty, their start and end offsets are equal.
+FlMethodResponse *RenderPages(FlMethodCall *method_call, const pdfviewer::RenderToken *token)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
+
+  FlValue *documentIDKey = fl_value_lookup_string(args, "documentID");
+  const gchar *documentID = documentIDKey ? fl_value_get_string(documentIDKey) : nullptr;
+  if (!documentID)
+    return create_error_response("InvalidArguments", "Document ID not provided");
+
+  FlValue *requestsKey = fl_value_lookup_string(args, "requests");
+  if (!requestsKey || fl_value_get_type(requestsKey) != FL_VALUE_TYPE_INT32_LIST)
+    return create_error_response("InvalidArguments", "Page requests not provided");
+
+  auto documentPtr = pdfviewer::GetPdfDocument(documentID);
+  if (!documentPtr)
+    return create_error_response("DocumentNotFound", "Document not found");
+
+  const int32_t *requests = fl_value_get_int32_list(requestsKey);
+  size_t count = fl_value_get_length(requestsKey) / kRenderPagesStride;
+  gsize capacity = 0;
+  for (size_t i = 0; i < count; ++i)
   {
-    response = GetPdfPageImage(method_call);
+    int width = std::max(0, static_cast<int>(requests[i * kRenderPagesStride + 1]));
+    int height = std::max(0, static_cast<int>(requests[i * kRenderPagesStride + 2]));
+    capacity += static_cast<gsize>(width) * height * 4;
   }
-  else if (g_strcmp0(method, "getTileImage") == 0)
+
+  guint8 *pixels = static_cast<guint8 *>(g_try_malloc(std::max<gsize>(capacity, 1)));
+  if (!pixels)
+    return create_error_response("OutOfMemory", "Unable to allocate the page bitmaps");
+
+  // Pages that fail take no space, the next page starts where they would have
+  std::vector<int64_t> offsets(count + 1, 0);
+  for (size_t i = 0; i < count; ++i)
   {
-    response = GetPdfPageTileImage(method_call);
+    int pageNumber = requests[i * kRenderPagesStride];
+    int width = std::max(0, static_cast<int>(requests[i * kRenderPagesStride + 1]));
+    int height = std::max(0, static_cast<int>(requests[i * kRenderPagesStride + 2]));
+    offsets[i + 1] = offsets[i];
+
+    if (width <= 0 || height <= 0)
+      continue;
+
+    pdfviewer::PinnedPage pinnedPage(documentPtr, pageNumber - 1);
+    FPDF_PAGE page = pinnedPage.page();
+    FPDF_BITMAP bitmap =
+        page ? FPDFBitmap_CreateEx(width, height, FPDFBitmap_BGRx, pixels + offsets[i], width * 4) : nullptr;
+    if (!bitmap)
+      continue;
+
+    FPDFBitmap_FillRect(bitmap, 0, 0, width, height, 0xFFFFFFFF);
+    pdfviewer::RenderStatus status = pdfviewer::RenderPageProgressive(
+        bitmap, page, 0, 0, width, height, FPDF_LCD_TEXT | FPDF_REVERSE_BYTE_ORDER, token, documentID);
+    FPDFBitmap_Destroy(bitmap);
+    if (status == pdfviewer::RenderStatus::kCancelled)
+    {
+      g_free(pixels);
+      return create_error_response("RenderCancelled", "Render request was cancelled");
+    }
+    if (status == pdfviewer::RenderStatus::kDone)
+      offsets[i + 1] += static_cast<int64_t>(width) * height * 4;
   }
-  else if (g_strcmp0(method, "closeDocument") == 0)
+
+  FlValue *result = fl_value_new_map();
+  fl_value_set_string_take(result, "pixels", fl_value_new_uint8_list(pixels, offsets[count]));
+  fl_value_set_string_take(result, "offsets", fl_value_new_int64_list(offsets.data(), offsets.size()));
+  g_free(pixels);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Number of values per page in the startThumbnails layout: atlas index, x, y,
+// width, height and ThumbnailSource
+static const int kThumbnailLayoutStride = 6;
+
+// Function to lay out the thumbnails of every page at the given height. The
+// result holds the `atlases` as width and height pairs and the `layout` of
+// the pages in page order. Thumbnails are generated afterwards and announced
+// with thumbnailsReady events.
+FlMethodResponse *StartThumbnails(FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
+
+  FlValue *documentIDKey = fl_value_lookup_string(args, "documentID");
+  if (!documentIDKey || fl_value_get_type(documentIDKey) != FL_VALUE_TYPE_STRING)
+    return create_error_response("InvalidArguments", "Document ID not provided");
+  FlValue *thumbnailHeightKey = fl_value_lookup_string(args, "thumbnailHeight");
+  int thumbnailHeight = thumbnailHeightKey && fl_value_get_type(thumbnailHeightKey) == FL_VALUE_TYPE_INT
+                            ? static_cast<int>(fl_value_get_int(thumbnailHeightKey))
+                            : 0;
+  if (thumbnailHeight < pdfviewer::kMinimumThumbnailHeight || thumbnailHeight > pdfviewer::kMaximumThumbnailHeight)
+    return create_error_response("InvalidArguments", "Thumbnail height out of range");
+
+  auto documentPtr = pdfviewer::GetPdfDocument(fl_value_get_string(documentIDKey));
+  if (!documentPtr)
+    return create_error_response("DocumentNotFound", "Document not found");
+
+  pdfviewer::ThumbnailAtlas *thumbnails = documentPtr->StartThumbnails(thumbnailHeight);
+  std::vector<int32_t> atlases;
+  for (const pdfviewer::Atlas &atlas : thumbnails->atlases())
   {
-    response = CloseDocument(method_call);
+    atlases.push_back(atlas.width);
+    atlases.push_back(atlas.height);
   }
-  else
+  std::vector<int32_t> layout;
+  for (const pdfviewer::ThumbnailCell &cell : thumbnails->cells())
   {
-    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+    layout.push_back(cell.atlas);
+    layout.push_back(cell.x);
+    layout.push_back(cell.y);
+    layout.push_back(cell.width);
+    layout.push_back(cell.height);
+    layout.push_back(static_cast<int32_t>(cell.source));
   }
 
-  fl_method_call_respond(method_call, response, nullptr);
+  FlValue *result = fl_value_new_map();
+  fl_value_set_string_take(result, "thumbnailHeight", fl_value_new_int(thumbnails->thumbnailHeight()));
+  fl_value_set_string_take(result, "stride", fl_value_new_int(kThumbnailLayoutStride));
+  fl_value_set_string_take(result, "atlases", fl_value_new_int32_list(atlases.data(), atlases.size()));
+  fl_value_set_string_take(result, "layout", fl_value_new_int32_list(layout.data(), layout.size()));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
 }
 
-// Initialization and disposal methods
-static void syncfusion_pdfviewer_linux_plugin_dispose(GObject *object)
+// Function to set the first and last page number of the thumbnails on screen.
+// Atlases without any of them are the first memory given up after the tiles.
+FlMethodResponse *SetVisibleThumbnails(FlMethodCall *method_call)
 {
-  G_OBJECT_CLASS(syncfusion_pdfviewer_linux_plugin_parent_class)->dispose(object);
-}
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
 
-static void syncfusion_pdfviewer_linux_plugin_class_init(SyncfusionPdfviewerLinuxPluginClass *klass)
-{
-  G_OBJECT_CLASS(klass)->dispose = syncfusion_pdfviewer_linux_plugin_dispose;
-}
+  FlValue *documentIDKey = fl_value_lookup_string(args, "documentID");
+  FlValue *firstKey = fl_value_lookup_string(args, "firstPageNumber");
+  FlValue *lastKey = fl_value_lookup_string(args, "lastPageNumber");
+  if (!documentIDKey || fl_value_get_type(documentIDKey) != FL_VALUE_TYPE_STRING || !firstKey ||
+      fl_value_get_type(firstKey) != FL_VALUE_TYPE_INT || !lastKey || fl_value_get_type(lastKey) != FL_VALUE_TYPE_INT)
+    return create_error_response("InvalidArguments", "Document ID or page range not provided");
 
-static void syncfusion_pdfviewer_linux_plugin_init(SyncfusionPdfviewerLinuxPlugin *self) {}
+  auto documentPtr = pdfviewer::GetPdfDocument(fl_value_get_string(documentIDKey));
+  if (!documentPtr)
+    return create_error_response("DocumentNotFound", "Document not found");
 
-static void method_call_cb(FlMethodChannel *channel, FlMethodCall *method_call, gpointer user_data)
-{
-  SyncfusionPdfviewerLinuxPlugin *plugin = SYNCFUSION_PDFVIEWER_LINUX_PLUGIN(user_data);
-  syncfusion_pdfviewer_linux_plugin_handle_method_call(plugin, method_call);
+  pdfviewer::ThumbnailAtlas *thumbnails = documentPtr->thumbnails();
+  if (thumbnails)
+    thumbnails->SetVisiblePages(static_cast<int>(fl_value_get_int(firstKey)) - 1,
+                                static_cast<int>(fl_value_get_int(lastKey)) - 1);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_bool(thumbnails != nullptr)));
 }
 
-// Plugin registration
-void syncfusion_pdfviewer_linux_plugin_register_with_registrar(FlPluginRegistrar *registrar)
+// Function to get the thumbnails of an atlas generated since the last call,
+// or all generated ones when `all` is set, so that Dart only uploads the
+// cells that changed. The result holds their `pageNumbers`, the tightly
+// packed RGBA `pixels` of each cell one after another with their start
+// `offsets`, and whether the atlas is `complete`.
+FlMethodResponse *GetThumbnailAtlas(FlMethodCall *method_call)
 {
-  SyncfusionPdfviewerLinuxPlugin *plugin = SYNCFUSION_PDFVIEWER_LINUX_PLUGIN(
-      g_object_new(syncfusion_pdfviewer_linux_plugin_get_type(), nullptr));
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
 
-  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
-  g_autoptr(FlMethodChannel) channel =
-      fl_method_channel_new(fl_plugin_registrar_get_messenger(registrar),
-                            "syncfusion_flutter_pdfviewer",
-                            FL_METHOD_CODEC(codec));
-  fl_method_channel_set_method_call_handler(channel, method_call_cb,
-                                            g_object_ref(plugin),
-                                            g_object_unref);
+  FlValue *documentIDKey = fl_value_lookup_string(args, "documentID");
+  FlValue *atlasIndexKey = fl_value_lookup_string(args, "atlasIndex");
+  if (!documentIDKey || fl_value_get_type(documentIDKey) != FL_VALUE_TYPE_STRING ||
+      !atlasIndexKey || fl_value_get_type(atlasIndexKey) != FL_VALUE_TYPE_INT)
+    return create_error_response("InvalidArguments", "Document ID or atlas index not provided");
+  FlValue *allKey = fl_value_lookup_string(args, "all");
+  bool all = allKey && fl_value_get_type(allKey) == FL_VALUE_TYPE_BOOL && fl_value_get_bool(allKey);
 
-  g_object_unref(plugin);
+  auto documentPtr = pdfviewer::GetPdfDocument(fl_value_get_string(documentIDKey));
+  if (!documentPtr)
+    return create_error_response("DocumentNotFound", "Document not found");
+
+  pdfviewer::ThumbnailAtlas *thumbnails = documentPtr->thumbnails();
+  int64_t atlasIndex = fl_value_get_int(atlasIndexKey);
+  if (!thumbnails || atlasIndex < 0 || atlasIndex >= static_cast<int64_t>(thumbnails->atlases().size()))
+    return create_error_response("AtlasNotFound", "Thumbnail atlas not found");
+
+  std::vector<int> pages = thumbnails->TakeUpdatedPages(static_cast<int>(atlasIndex), all);
+  std::vector<int32_t> pageNumbers;
+  std::vector<int64_t> offsets(1, 0);
+  for (int index : pages)
+  {
+    const pdfviewer::ThumbnailCell &cell = thumbnails->cells()[index];
+    pageNumbers.push_back(index + 1);
+    offsets.push_back(offsets.back() + static_cast<int64_t>(cell.width) * cell.height * 4);
+  }
+  guint8 *pixels = static_cast<guint8 *>(g_malloc(offsets.back()));
+  for (size_t i = 0; i < pages.size(); ++i)
+    thumbnails->ReadCell(pages[i], pixels + offsets[i]);
+
+  const pdfviewer::Atlas &atlas = thumbnails->atlases()[atlasIndex];
+  FlValue *result = fl_value_new_map();
+  fl_value_set_string_take(result, "complete", fl_value_new_bool(atlas.pending == 0));
+  fl_value_set_string_take(result, "pageNumbers", fl_value_new_int32_list(pageNumbers.data(), pageNumbers.size()));
+  fl_value_set_string_take(result, "pixels", fl_value_new_uint8_list(pixels, offsets.back()));
+  fl_value_set_string_take(result, "offsets", fl_value_new_int64_list(offsets.data(), offsets.size()));
+  g_free(pixels);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
 }
 
-// Function to initialize PDF renderer
-FlMethodResponse *InitializePDFRenderer(FlMethodCall *method_call)
+// Function to get the text of a page
+FlMethodResponse *GetPageText(FlMethodCall *method_call)
 {
   FlValue *args = fl_method_call_get_args(method_call);
-  if (args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP)
-  {
-    FlValue *idKey = fl_value_lookup_string(args, "documentID");
-    const gchar *documentID = idKey ? fl_value_get_string(idKey) : "";
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
 
-    FlValue *documentBytesKey = fl_value_lookup_string(args, "documentBytes");
-    const uint8_t *bytesValue = documentBytesKey ? fl_value_get_uint8_list(documentBytesKey) : nullptr;
-    gsize size = fl_value_get_length(documentBytesKey);
+  FlValue *documentIDKey = fl_value_lookup_string(args, "documentID");
+  FlValue *pageNumberKey = fl_value_lookup_string(args, "pageNumber");
+  if (!documentIDKey || fl_value_get_type(documentIDKey) != FL_VALUE_TYPE_STRING ||
+      !pageNumberKey || fl_value_get_type(pageNumberKey) != FL_VALUE_TYPE_INT)
+    return create_error_response("InvalidArguments", "Document ID or page number not provided");
 
-    FlValue *passwordKey = fl_value_lookup_string(args, "password");
-    const gchar *password = "";
-    if (passwordKey && fl_value_get_type(passwordKey) == FL_VALUE_TYPE_STRING) {
-      password = fl_value_get_string(passwordKey);
-    }
+  auto documentPtr = pdfviewer::GetPdfDocument(fl_value_get_string(documentIDKey));
+  if (!documentPtr)
+    return create_error_response("DocumentNotFound", "Document not found");
 
-    if (documentID && bytesValue != nullptr && size > 0)
-    {
-      g_autoptr(GBytes) data = g_bytes_new(bytesValue, size);
-      auto document = pdfviewer::InitializePdfRenderer(data, password, documentID);
-      if (document)
-      {
-        int pageCount = FPDF_GetPageCount(document->pdfDocument());
-        FlValue *result = fl_value_new_string(g_strdup_printf("%d", pageCount));
-        return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
-      }
-    }
-  }
-  return create_error_response("InvalidArguments", "Initialization failed");
+  g_autofree gchar *text = pdfviewer::ExtractPageText(documentPtr, fl_value_get_int(pageNumberKey) - 1);
+  if (!text)
+    return create_error_response("PageNotFound", "Page not found or not available");
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_string(text)));
 }
 
-// Function to initialize PDF renderer from a URI
-FlMethodResponse *LoadPdfFromFile(FlMethodCall *method_call) {
+// Function to close a PDF document
+FlMethodResponse *CloseDocument(FlMethodCall *method_call)
+{
   FlValue *args = fl_method_call_get_args(method_call);
-  if (args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP) {
-    FlValue *path_key = fl_value_lookup_string(args, "path");
-    const gchar *path = fl_value_get_string(path_key);
-    FlValue *idKey = fl_value_lookup_string(args, "documentID");
-    const gchar *documentID = idKey ? fl_value_get_string(idKey) : "";
-    FlValue *passwordKey = fl_value_lookup_string(args, "password");
-    const gchar *password = "";
-    if (passwordKey && fl_value_get_type(passwordKey) == FL_VALUE_TYPE_STRING) {
-      password = fl_value_get_string(passwordKey);
-    }
+  const gchar *documentID = args ? fl_value_get_string(args) : "";
 
-    auto document = pdfviewer::LoadPdfFromFile(path, password, documentID);    
-    if (document) {
-      int pageCount = FPDF_GetPageCount(document->pdfDocument());
-      FlValue *result = fl_value_new_string(g_strdup_printf("%d", pageCount));
-      return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
-    }
-    return create_error_response("InitializationFailed", "Unable to initialize PDF document from provided path");
+  if (documentID)
+  {
+    pdfviewer::ClosePdfDocument(documentID);
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_string("Success")));
   }
-  return create_error_response("InvalidArguments", "Expected a map of arguments");
+
+  return create_error_response("Error", "Document ID not provided");
 }
 
-// Function to get pages' heights
-FlMethodResponse *GetPagesHeight(FlMethodCall *method_call)
+// Function to apply the viewport hint sent while scrolling, pages far from the
+// visible range are released from the document's page cache. The optional
+// visible region, velocity and scale plan the tiles prefetched ahead of the
+// viewport; without them the prefetch stops.
+FlMethodResponse *ViewportHint(FlMethodCall *method_call)
 {
   FlValue *args = fl_method_call_get_args(method_call);
-  const gchar *documentID = fl_value_get_string(args) ?: "";
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
 
-  if (!documentID)
-    return create_error_response("InvalidArguments", "Document ID not provided");
+  const gchar *documentID = fl_value_get_string(fl_value_lookup_string(args, "documentID"));
+  int firstPage = fl_value_get_int(fl_value_lookup_string(args, "firstPage"));
+  int lastPage = fl_value_get_int(fl_value_lookup_string(args, "lastPage"));
 
   auto documentPtr = pdfviewer::GetPdfDocument(documentID);
   if (!documentPtr)
     return create_error_response("DocumentNotFound", "Document not found");
 
-  int pageCount = FPDF_GetPageCount(documentPtr->pdfDocument());
-  FlValue *flPageHeights = fl_value_new_list();
+  documentPtr->SetVisiblePages(firstPage - 1, lastPage - 1);
 
-  for (int i = 0; i < pageCount; ++i)
+  pdfviewer::ViewportHint hint{};
+  hint.first_page = firstPage - 1;
+  hint.last_page = lastPage - 1;
+  FlValue *rectKey = fl_value_lookup_string(args, "visibleRect");
+  if (rectKey && fl_value_get_type(rectKey) == FL_VALUE_TYPE_FLOAT_LIST && fl_value_get_length(rectKey) == 4)
   {
-    FPDF_PAGE page = FPDF_LoadPage(documentPtr->pdfDocument(), i);
-    if (page)
-    {
-      double height = FPDF_GetPageHeightF(page);
-      fl_value_append_take(flPageHeights, fl_value_new_float(height));
-      FPDF_ClosePage(page);
-    }
+    const double *rect = fl_value_get_float_list(rectKey);
+    hint.has_region = true;
+    hint.left = rect[0];
+    hint.top = rect[1];
+    hint.width = rect[2];
+    hint.height = rect[3];
   }
-  return FL_METHOD_RESPONSE(fl_method_success_response_new(flPageHeights));
+  hint.velocity_x = read_float(args, "velocityX", 0);
+  hint.velocity_y = read_float(args, "velocityY", 0);
+  hint.scale = read_float(args, "scale", 0);
+  FlValue *horizontalKey = fl_value_lookup_string(args, "horizontal");
+  hint.horizontal = horizontalKey && fl_value_get_type(horizontalKey) == FL_VALUE_TYPE_BOOL &&
+                    fl_value_get_bool(horizontalKey);
+  documentPtr->StartPrefetcher()->Update(hint);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
 }
 
-// Function to get pages' widths
-FlMethodResponse *GetPagesWidth(FlMethodCall *method_call)
+// Function to start the helper processes that render page and tile images in
+// parallel, replacing the running ones. A process count of 0 stops them and
+// the images are rendered on the render worker again. Runs on the render
+// worker, which the helpers are forked from.
+FlMethodResponse *SetRenderProcessCount(FlMethodCall *method_call)
 {
   FlValue *args = fl_method_call_get_args(method_call);
-  const gchar *documentID = fl_value_get_string(args) ?: "";
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
 
-  if (!documentID)
-    return create_error_response("InvalidArguments", "Document ID not provided");
+  FlValue *processCountKey = fl_value_lookup_string(args, "processCount");
+  if (!processCountKey || fl_value_get_type(processCountKey) != FL_VALUE_TYPE_INT ||
+      fl_value_get_int(processCountKey) < 0)
+    return create_error_response("InvalidArguments", "Process count not provided");
 
-  auto documentPtr = pdfviewer::GetPdfDocument(documentID);
-  if (!documentPtr)
-    return create_error_response("DocumentNotFound", "Document not found");
+  int started = pdfviewer::RenderFarm::Shared().Start(static_cast<int>(fl_value_get_int(processCountKey)));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_int(started)));
+}
 
-  int pageCount = FPDF_GetPageCount(documentPtr->pdfDocument());
-  FlValue *flPageWidths = fl_value_new_list();
+// Function to set the limit of the memory held by the caches of all
+// documents, 0 for the default share of the physical memory. Caches over the
+// new limit are trimmed right away. Returns the limit in effect.
+FlMethodResponse *SetMemoryBudget(FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
 
-  for (int i = 0; i < pageCount; ++i)
-  {
-    FPDF_PAGE page = FPDF_LoadPage(documentPtr->pdfDocument(), i);
-    if (page)
-    {
-      double width = FPDF_GetPageWidthF(page);
-      fl_value_append_take(flPageWidths, fl_value_new_float(width));
-      FPDF_ClosePage(page);
-    }
-  }
-  return FL_METHOD_RESPONSE(fl_method_success_response_new(flPageWidths));
+  FlValue *bytesKey = fl_value_lookup_string(args, "bytes");
+  if (!bytesKey || fl_value_get_type(bytesKey) != FL_VALUE_TYPE_INT || fl_value_get_int(bytesKey) < 0)
+    return create_error_response("InvalidArguments", "Memory budget not provided");
+
+  pdfviewer::MemoryBudget &budget = pdfviewer::MemoryBudget::Shared();
+  budget.SetLimit(static_cast<gsize>(fl_value_get_int(bytesKey)));
+  if (budget.IsOverLimit())
+    pdfviewer::ReclaimMemory(pdfviewer::MemoryTier::kPageHandles, budget.limit());
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_int(static_cast<gint64>(budget.limit()))));
 }
 
-// Function to convert FPDF_BITMAP to FlValue using a raw array
-FlValue *ConvertBitmapToFlValue(FPDF_BITMAP bitmap, int width, int height)
+// Function to enable or disable the disk caches, off until enabled. Caches
+// already on disk are kept, clearDiskCache removes them.
+FlMethodResponse *SetDiskCacheEnabled(FlMethodCall *method_call)
 {
-  // Calculate buffer size: width * height * 4 (for RGBA)
-  size_t bufferSize = width * height * 4;
+  FlValue *args = fl_method_call_get_args(method_call);
+  FlValue *enabledKey = args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                            ? fl_value_lookup_string(args, "enabled")
+                            : nullptr;
+  if (!enabledKey || fl_value_get_type(enabledKey) != FL_VALUE_TYPE_BOOL)
+    return create_error_response("InvalidArguments", "Enabled flag not provided");
+
+  pdfviewer::SetDiskCacheEnabled(fl_value_get_bool(enabledKey));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+}
 
-  // Allocate memory for the raw array
-  std::vector<uint8_t> imageData(bufferSize);
+// Function to remove everything the disk caches hold. Runs on the render
+// worker, after the tiles and indexes stored by the jobs queued before it.
+FlMethodResponse *ClearDiskCache(FlMethodCall *method_call)
+{
+  pdfviewer::DiskTileCache::Shared().Clear();
+  pdfviewer::TextIndex::ClearCache();
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+}
 
-  // Copy data from the bitmap to the raw array
-  std::memcpy(imageData.data(), FPDFBitmap_GetBuffer(bitmap), bufferSize);
+// Function to get the memory held by the caches in bytes per category, for
+// the document when its ID is given or for all documents otherwise
+FlMethodResponse *GetMemoryUsage(FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  FlValue *documentIDKey = args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                               ? fl_value_lookup_string(args, "documentID")
+                               : nullptr;
 
-  // Create an FlValue from the raw array
-  return fl_value_new_uint8_list(imageData.data(), bufferSize);
+  pdfviewer::MemoryBudget &budget = pdfviewer::MemoryBudget::Shared();
+  pdfviewer::MemoryUsage usage = documentIDKey && fl_value_get_type(documentIDKey) == FL_VALUE_TYPE_STRING
+                                     ? budget.GetUsage(fl_value_get_string(documentIDKey))
+                                     : budget.GetTotalUsage();
+  FlValue *result = fl_value_new_map();
+  fl_value_set_string_take(result, "documentData",
+                           fl_value_new_int(usage.Get(pdfviewer::MemoryCategory::kDocumentData)));
+  fl_value_set_string_take(result, "pageHandles", fl_value_new_int(usage.Get(pdfviewer::MemoryCategory::kPageHandles)));
+  fl_value_set_string_take(result, "tiles", fl_value_new_int(usage.Get(pdfviewer::MemoryCategory::kTiles)));
+  fl_value_set_string_take(result, "thumbnails", fl_value_new_int(usage.Get(pdfviewer::MemoryCategory::kThumbnails)));
+  fl_value_set_string_take(result, "total", fl_value_new_int(usage.Total()));
+  fl_value_set_string_take(result, "limit", fl_value_new_int(budget.limit()));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
 }
 
-// Function to get a page's image
-FlMethodResponse *GetPdfPageImage(FlMethodCall *method_call)
+// Function to get the render statistics of a document, or of all documents
+// when no ID is given, and optionally reset them. Each phase holds its count,
+// total and maximum duration, estimated percentiles and the histogram buckets,
+// all in microseconds; see LatencyHistogram for the bucket bounds.
+FlMethodResponse *GetRenderStats(FlMethodCall *method_call)
 {
   FlValue *args = fl_method_call_get_args(method_call);
-  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
-    return create_error_response("InvalidArguments", "Invalid arguments");
+  bool isMap = args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP;
+  FlValue *documentIDKey = isMap ? fl_value_lookup_string(args, "documentID") : nullptr;
+  FlValue *resetKey = isMap ? fl_value_lookup_string(args, "reset") : nullptr;
+  const gchar *documentID = documentIDKey && fl_value_get_type(documentIDKey) == FL_VALUE_TYPE_STRING
+                                ? fl_value_get_string(documentIDKey)
+                                : nullptr;
+  bool reset = resetKey && fl_value_get_type(resetKey) == FL_VALUE_TYPE_BOOL && fl_value_get_bool(resetKey);
 
-  int index = fl_value_get_int(fl_value_lookup_string(args, "index"));
-  int width = fl_value_get_int(fl_value_lookup_string(args, "width"));
-  int height = fl_value_get_int(fl_value_lookup_string(args, "height"));
-  const gchar *documentID = fl_value_get_string(fl_value_lookup_string(args, "documentID"));
+  pdfviewer::RenderStatsSnapshot stats = pdfviewer::RenderStats::Shared().Get(documentID, reset);
+  FlValue *phases = fl_value_new_map();
+  for (int i = 0; i < static_cast<int>(pdfviewer::RenderPhase::kCount); ++i)
+  {
+    const pdfviewer::LatencyHistogram &histogram = stats.phases[i];
+    int64_t buckets[pdfviewer::LatencyHistogram::kBucketCount];
+    for (int j = 0; j < pdfviewer::LatencyHistogram::kBucketCount; ++j)
+      buckets[j] = static_cast<int64_t>(histogram.buckets[j]);
 
-  if (!documentID)
-    return create_error_response("InvalidArguments", "Document ID not provided");
+    FlValue *phase = fl_value_new_map();
+    fl_value_set_string_take(phase, "count", fl_value_new_int(histogram.count));
+    fl_value_set_string_take(phase, "total", fl_value_new_int(histogram.total));
+    fl_value_set_string_take(phase, "max", fl_value_new_int(histogram.maximum));
+    fl_value_set_string_take(phase, "p50", fl_value_new_int(histogram.GetQuantile(0.5)));
+    fl_value_set_string_take(phase, "p90", fl_value_new_int(histogram.GetQuantile(0.9)));
+    fl_value_set_string_take(phase, "p99", fl_value_new_int(histogram.GetQuantile(0.99)));
+    fl_value_set_string_take(phase, "buckets",
+                             fl_value_new_int64_list(buckets, pdfviewer::LatencyHistogram::kBucketCount));
+    fl_value_set_string_take(phases, pdfviewer::GetRenderPhaseName(static_cast<pdfviewer::RenderPhase>(i)), phase);
+  }
+  FlValue *counters = fl_value_new_map();
+  for (int i = 0; i < static_cast<int>(pdfviewer::RenderCounter::kCount); ++i)
+    fl_value_set_string_take(counters, pdfviewer::GetRenderCounterName(static_cast<pdfviewer::RenderCounter>(i)),
+                             fl_value_new_int(stats.counters[i]));
 
-  auto documentPtr = pdfviewer::GetPdfDocument(documentID);
-  if (!documentPtr)
-    return create_error_response("DocumentNotFound", "Document not found");
+  FlValue *result = fl_value_new_map();
+  fl_value_set_string_take(result, "phases", phases);
+  fl_value_set_string_take(result, "counters", counters);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
 
-  FPDF_DOCUMENT document = documentPtr->pdfDocument();
-  FPDF_PAGE page = FPDF_LoadPage(document, index - 1);
-  if (!page)
-    return create_error_response("PageNotFound", "Page not found");
+// Function to move the jobs of the render worker, PDFium included, to the
+// GTK main loop or back to the worker thread. On the main loop renders run in
+// slices of a few milliseconds between which input and frames are handled.
+FlMethodResponse *SetCooperativeRendering(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
 
-  FPDF_BITMAP bitmap = FPDFBitmap_Create(width, height, 0);
-  FPDFBitmap_FillRect(bitmap, 0, 0, width, height, 0xFFFFFFFF);
-  FPDF_RenderPageBitmap(bitmap, page, 0, 0, width, height, 0, FPDF_LCD_TEXT | FPDF_REVERSE_BYTE_ORDER);
+  FlValue *enabledKey = fl_value_lookup_string(args, "enabled");
+  if (!enabledKey || fl_value_get_type(enabledKey) != FL_VALUE_TYPE_BOOL)
+    return create_error_response("InvalidArguments", "Enabled flag not provided");
 
-  // Convert and get FlValue
-  FlValue *result = ConvertBitmapToFlValue(bitmap, width, height);
+  self->worker->SetCooperative(fl_value_get_bool(enabledKey), G_OBJECT(self));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+}
 
-  FPDFBitmap_Destroy(bitmap);
-  FPDF_ClosePage(page);
+// Function to cancel a pending page or tile render
+FlMethodResponse *CancelRender(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
+    return create_error_response("InvalidArguments", "Invalid arguments");
 
-  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  FlValue *requestIDKey = fl_value_lookup_string(args, "requestID");
+  if (!requestIDKey || fl_value_get_type(requestIDKey) != FL_VALUE_TYPE_INT)
+    return create_error_response("InvalidArguments", "Request ID not provided");
+
+  gboolean cancelled = self->render_requests->Cancel(fl_value_get_int(requestIDKey));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_bool(cancelled)));
 }
 
-// Function to get tile image from a PDF page
-FlMethodResponse *GetPdfPageTileImage(FlMethodCall *method_call)
+// Function to stop a pending text search
+FlMethodResponse *CancelTextSearch(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call)
 {
   FlValue *args = fl_method_call_get_args(method_call);
   if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP)
     return create_error_response("InvalidArguments", "Invalid arguments");
 
+  FlValue *searchIDKey = fl_value_lookup_string(args, "searchID");
+  if (!searchIDKey || fl_value_get_type(searchIDKey) != FL_VALUE_TYPE_INT)
+    return create_error_response("InvalidArguments", "Search ID not provided");
+
+  gboolean cancelled = self->text_searches->Cancel(fl_value_get_int(searchIDKey));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_bool(cancelled)));
+}
+
+// Function to create an external texture that displays a page
+FlMethodResponse *CreatePageTexture(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call)
+{
+  PdfPageTexture *texture = pdf_page_texture_new();
+  if (!fl_texture_registrar_register_texture(self->texture_registrar, FL_TEXTURE(texture)))
+  {
+    g_object_unref(texture);
+    return create_error_response("TextureRegistrationFailed", "Unable to register the page texture");
+  }
+
+  gint64 textureID = fl_texture_get_id(FL_TEXTURE(texture));
+  (*self->textures)[textureID] = texture;
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_int(textureID)));
+}
+
+// Function to release a page texture
+FlMethodResponse *DisposePageTexture(SyncfusionPdfviewerLinuxPlugin *self, FlMethodCall *method_call)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
+  FlValue *textureIDKey = args && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                              ? fl_value_lookup_string(args, "textureID")
+                              : nullptr;
+  if (!textureIDKey || fl_value_get_type(textureIDKey) != FL_VALUE_TYPE_INT)
+    return create_error_response("InvalidArguments", "Texture ID not provided");
+
+  auto it = self->textures->find(fl_value_get_int(textureIDKey));
+  if (it != self->textures->end())
+  {
+    // A render in progress keeps its own reference until it completes
+    fl_texture_registrar_unregister_texture(self->texture_registrar, FL_TEXTURE(it->second));
+    g_object_unref(it->second);
+    self->textures->erase(it);
+  }
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+}
+
+// Function to render a page into its texture, runs on the render worker
+FlMethodResponse *RenderPageTexture(FlMethodCall *method_call, PdfPageTexture *texture,
+                                    const pdfviewer::RenderToken *token)
+{
+  FlValue *args = fl_method_call_get_args(method_call);
   int pageNumber = fl_value_get_int(fl_value_lookup_string(args, "pageNumber"));
-  double scale = fl_value_get_float(fl_value_lookup_string(args, "scale"));
+  int width = fl_value_get_int(fl_value_lookup_string(args, "width"));
+  int height = fl_value_get_int(fl_value_lookup_string(args, "height"));
   const gchar *documentID = fl_value_get_string(fl_value_lookup_string(args, "documentID"));
-  double x = fl_value_get_float(fl_value_lookup_string(args, "x"));
-  double y = fl_value_get_float(fl_value_lookup_string(args, "y"));
-  int width = static_cast<int>(fl_value_get_float(fl_value_lookup_string(args, "width")));
-  int height = static_cast<int>(fl_value_get_float(fl_value_lookup_string(args, "height")));
+  pdfviewer::RenderQuality quality;
 
   if (!documentID)
     return create_error_response("InvalidArguments", "Document ID not provided");
+  if (!read_render_quality(args, &quality))
+    return create_error_response("InvalidArguments", "Unknown render quality");
 
   auto documentPtr = pdfviewer::GetPdfDocument(documentID);
   if (!documentPtr)
     return create_error_response("DocumentNotFound", "Document not found");
 
-  FPDF_DOCUMENT document = documentPtr->pdfDocument();
-  FPDF_PAGE page = FPDF_LoadPage(document, pageNumber - 1);
+  // A page the prefetcher prerendered ahead of a fling is presented as is
+  int flags = pdfviewer::GetQualityRenderFlags(FPDF_LCD_TEXT | FPDF_REVERSE_BYTE_ORDER, quality);
+  pdfviewer::PageImageCache &pageImages = documentPtr->pageImages();
+  pageImages.SetLastRequest(pageNumber - 1, width, height, flags);
+  gsize prerenderedCapacity = 0;
+  guint8 *prerendered = pageImages.Take(pageNumber - 1, width, height, flags, &prerenderedCapacity);
+  if (prerendered)
+  {
+    pdf_page_texture_present(texture, prerendered, prerenderedCapacity, width, height);
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_bool(TRUE)));
+  }
+
+  pdfviewer::PinnedPage pinnedPage(documentPtr, pageNumber - 1);
+  FPDF_PAGE page = pinnedPage.page();
   if (!page)
     return create_error_response("PageNotFound", "Page not found");
 
-  FS_MATRIX matrix = {static_cast<float>(scale), 0, 0, static_cast<float>(scale),
-                      static_cast<float>(-x * scale), static_cast<float>(-y * scale)};
-  FS_RECTF rect = {0, 0, static_cast<float>(width * scale), static_cast<float>(height * scale)};
-
-  FPDF_BITMAP bitmap = FPDFBitmap_Create(width, height, 0);
+  pdfviewer::PooledBitmap pooledBitmap(width, height);
+  FPDF_BITMAP bitmap = pooledBitmap.bitmap();
+  if (!bitmap)
+    return create_error_response("OutOfMemory", "Unable to allocate the page bitmap");
   FPDFBitmap_FillRect(bitmap, 0, 0, width, height, 0xFFFFFFFF);
-  FPDF_RenderPageBitmapWithMatrix(bitmap, page, &matrix, &rect, FPDF_LCD_TEXT | FPDF_REVERSE_BYTE_ORDER);
-
-  // Convert and get FlValue
-  FlValue *result = ConvertBitmapToFlValue(bitmap, width, height);
+  pdfviewer::RenderStatus status =
+      pdfviewer::RenderPageProgressive(bitmap, page, 0, 0, width, height, flags, token, documentID);
 
-  FPDFBitmap_Destroy(bitmap);
-  FPDF_ClosePage(page);
+  if (status != pdfviewer::RenderStatus::kDone)
+    return CreateRenderResponse(status, bitmap, width, height, documentID);
 
-  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  // The texture reads the pixels directly, nothing is sent over the channel
+  gsize capacity = 0;
+  guint8 *pixels = pooledBitmap.TakeBuffer(&capacity);
+  pdf_page_texture_present(texture, pixels, capacity, width, height);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_bool(TRUE)));
 }
-
-// Function to close a PDF document
-FlMethodResponse *CloseDocument(FlMethodCall *method_call)
-{
-  FlValue *args = fl_method_call_get_args(method_call);
-  const gchar *documentID = args ? fl_value_get_string(args) : "";
-
-  if (documentID)
-  {
-    pdfviewer::ClosePdfDocument(documentID);
-    return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_string("Success")));
-  }
-
-  return create_error_response("Error", "Document ID not provided");
-}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "downsample.h"
+
+namespace pdfviewer
+{
+  namespace test
+  {
+    // Scalar 2x2 box filter averaging the two rows first, then the two
+    // pixels of each pair, each rounding up
+    static guint8 AverageBlock(guint8 top_left, guint8 top_right, guint8 bottom_left, guint8 bottom_right)
+    {
+      int left = (top_left + bottom_left + 1) >> 1;
+      int right = (top_right + bottom_right + 1) >> 1;
+      return static_cast<guint8>((left + right + 1) >> 1);
+    }
+
+    TEST(Downsample, RoundsLikeTheReference)
+    {
+      const guint8 source[16] = {0, 0, 0, 0, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255};
+      guint8 target[4] = {};
+      Downsample2x(source, 8, target, 4, 1, 1);
+      for (int channel = 0; channel < 4; ++channel)
+        EXPECT_EQ(target[channel], 192);
+    }
+
+    // Every width up to a few vector steps, so that the vector paths and the
+    // scalar tail each cover some of the rows
+    TEST(Downsample, MatchesScalarReferenceForEveryWidth)
+    {
+      guint32 seed = 12345;
+      for (int width = 1; width <= 37; ++width)
+      {
+        const int height = 3;
+        // Padded strides, the padding of the target must stay untouched
+        int sourceStride = width * 8 + 12;
+        int targetStride = width * 4 + 4;
+        std::vector<guint8> source(static_cast<size_t>(sourceStride) * height * 2);
+        for (guint8 &value : source)
+        {
+          seed = seed * 1103515245 + 12345;
+          value = static_cast<guint8>(seed >> 16);
+        }
+        std::vector<guint8> target(static_cast<size_t>(targetStride) * height, 0xAA);
+        Downsample2x(source.data(), sourceStride, target.data(), targetStride, width, height);
+
+        for (int y = 0; y < height; ++y)
+        {
+          const guint8 *top = source.data() + static_cast<size_t>(y) * 2 * sourceStride;
+          const guint8 *bottom = top + sourceStride;
+          const guint8 *row = target.data() + static_cast<size_t>(y) * targetStride;
+          for (int x = 0; x < width * 4; ++x)
+          {
+            int pixel = x / 4;
+            int channel = x % 4;
+            ASSERT_EQ(row[x], AverageBlock(top[pixel * 8 + channel], top[pixel * 8 + 4 + channel],
+                                           bottom[pixel * 8 + channel], bottom[pixel * 8 + 4 + channel]))
+                << "width " << width << " row " << y << " byte " << x;
+          }
+          for (int x = width * 4; x < targetStride; ++x)
+            ASSERT_EQ(row[x], 0xAA) << "width " << width << " row " << y;
+        }
+      }
+    }
+  } // namespace test
+} // namespace pdfviewer
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include "memory_budget.h"
+
+namespace pdfviewer
+{
+  namespace test
+  {
+    TEST(MemoryBudget, ChargesPerDocumentAndCategory)
+    {
+      MemoryBudget &budget = MemoryBudget::Shared();
+      MemoryUsage before = budget.GetTotalUsage();
+      budget.Charge("budget-first", MemoryCategory::kDocumentData, 4000);
+      budget.Charge("budget-first", MemoryCategory::kTiles, 1000);
+      budget.Charge("budget-second", MemoryCategory::kThumbnails, 300);
+
+      MemoryUsage first = budget.GetUsage("budget-first");
+      EXPECT_EQ(first.Get(MemoryCategory::kDocumentData), 4000u);
+      EXPECT_EQ(first.Get(MemoryCategory::kTiles), 1000u);
+      EXPECT_EQ(first.Get(MemoryCategory::kThumbnails), 0u);
+      EXPECT_EQ(first.Total(), 5000u);
+      // The document data is not evictable
+      EXPECT_EQ(first.Evictable(), 1000u);
+      EXPECT_EQ(budget.GetUsage("budget-second").Total(), 300u);
+
+      MemoryUsage total = budget.GetTotalUsage();
+      EXPECT_EQ(total.Total() - before.Total(), 5300u);
+      EXPECT_EQ(total.Evictable() - before.Evictable(), 1300u);
+
+      // A release never takes the usage of the document below zero
+      budget.Charge("budget-first", MemoryCategory::kTiles, -400);
+      EXPECT_EQ(budget.GetUsage("budget-first").Get(MemoryCategory::kTiles), 600u);
+      budget.Charge("budget-first", MemoryCategory::kTiles, -600);
+      budget.Charge("budget-first", MemoryCategory::kDocumentData, -4000);
+      budget.Charge("budget-second", MemoryCategory::kThumbnails, -300);
+      EXPECT_EQ(budget.GetUsage("budget-first").Total(), 0u);
+      EXPECT_EQ(budget.GetUsage("budget-second").Total(), 0u);
+      EXPECT_EQ(budget.GetTotalUsage().Total(), before.Total());
+    }
+
+    TEST(MemoryBudget, HoldsOnlyEvictableUsageAgainstLimit)
+    {
+      MemoryBudget &budget = MemoryBudget::Shared();
+      gsize evictable = budget.GetTotalUsage().Evictable();
+      budget.SetLimit(evictable + 1000);
+
+      budget.Charge("budget-limit", MemoryCategory::kDocumentData, 5000);
+      EXPECT_FALSE(budget.IsOverLimit());
+      budget.Charge("budget-limit", MemoryCategory::kPageHandles, 1001);
+      EXPECT_TRUE(budget.IsOverLimit());
+      budget.Charge("budget-limit", MemoryCategory::kPageHandles, -1001);
+      EXPECT_FALSE(budget.IsOverLimit());
+      budget.Charge("budget-limit", MemoryCategory::kDocumentData, -5000);
+
+      // 0 restores the default limit, a share of the physical memory
+      budget.SetLimit(0);
+      EXPECT_GE(budget.limit(), static_cast<gsize>(256 * 1024 * 1024));
+    }
+  } // namespace test
+} // namespace pdfviewer
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "pdfviewer.h"
+#include "prefetcher.h"
+#include "test/test_document.h"
+#include "tile_engine.h"
+
+namespace pdfviewer
+{
+  namespace test
+  {
+    // Six square pages of 200 points, a single grid tile each at scale 1
+    static PdfDocument *OpenPrefetchDocument(const gchar *document_id)
+    {
+      std::string pdf = BuildTestDocument(std::vector<std::string>(6, ""), 200, 200);
+      g_autoptr(GBytes) data = g_bytes_new(pdf.data(), pdf.size());
+      return InitializePdfRenderer(data, nullptr, document_id, nullptr);
+    }
+
+    static ViewportHint GetPageHint(int first_page, int last_page, double velocity_y)
+    {
+      ViewportHint hint = {};
+      hint.first_page = first_page;
+      hint.last_page = last_page;
+      hint.velocity_y = velocity_y;
+      return hint;
+    }
+
+    static bool IsTileCached(const gchar *document_id, int page_index)
+    {
+      TileKey key{document_id, page_index, GetZoomBucket(1.0), 0, 0};
+      int width = 0;
+      int height = 0;
+      GBytes *tile = TileCache::Shared().Lookup(key, &width, &height);
+      if (!tile)
+        return false;
+      g_bytes_unref(tile);
+      return true;
+    }
+
+    TEST(Prefetcher, PlansNothingWhileScrollingSlowly)
+    {
+      PdfDocument *document = OpenPrefetchDocument("prefetch-slow");
+      ASSERT_NE(document, nullptr);
+
+      Prefetcher prefetcher(document);
+      prefetcher.Update(GetPageHint(0, 1, 30));
+      EXPECT_FALSE(prefetcher.HasPending());
+
+      ClosePdfDocument("prefetch-slow");
+    }
+
+    TEST(Prefetcher, PrerendersThePagesAheadInTheDirectionOfTravel)
+    {
+      PdfDocument *document = OpenPrefetchDocument("prefetch-pages");
+      ASSERT_NE(document, nullptr);
+      document->pageImages().SetLastRequest(0, 100, 100, 0);
+
+      // 0.6 seconds at 1000 points per second travel 3 pages of 200 points
+      Prefetcher prefetcher(document);
+      prefetcher.Update(GetPageHint(0, 1, 1000));
+      for (int i = 0; i < 3; ++i)
+      {
+        ASSERT_TRUE(prefetcher.HasPending());
+        prefetcher.PrefetchNext();
+      }
+      EXPECT_FALSE(prefetcher.HasPending());
+      EXPECT_FALSE(document->pageImages().Contains(1, 100, 100, 0));
+      EXPECT_TRUE(document->pageImages().Contains(2, 100, 100, 0));
+      EXPECT_TRUE(document->pageImages().Contains(3, 100, 100, 0));
+      EXPECT_TRUE(document->pageImages().Contains(4, 100, 100, 0));
+      EXPECT_FALSE(document->pageImages().Contains(5, 100, 100, 0));
+
+      // Scrolling up warms the pages above the viewport instead
+      prefetcher.Update(GetPageHint(4, 5, -400));
+      ASSERT_TRUE(prefetcher.HasPending());
+      document->pageImages().Clear();
+      prefetcher.PrefetchNext();
+      prefetcher.PrefetchNext();
+      EXPECT_FALSE(prefetcher.HasPending());
+      EXPECT_TRUE(document->pageImages().Contains(3, 100, 100, 0));
+      EXPECT_TRUE(document->pageImages().Contains(2, 100, 100, 0));
+
+      ClosePdfDocument("prefetch-pages");
+    }
+
+    TEST(Prefetcher, RendersTheTilesAheadOfTheVisibleRegion)
+    {
+      PdfDocument *document = OpenPrefetchDocument("prefetch-tiles");
+      ASSERT_NE(document, nullptr);
+
+      // The visible region covers the first page, the travel of 600 points
+      // reaches the fourth
+      ViewportHint hint = GetPageHint(0, 0, 1000);
+      hint.has_region = true;
+      hint.width = 200;
+      hint.height = 200;
+      hint.scale = 1.0;
+      Prefetcher prefetcher(document);
+      prefetcher.Update(hint);
+      while (prefetcher.HasPending())
+        prefetcher.PrefetchNext();
+
+      // The visible tile is left to the request of Dart
+      EXPECT_FALSE(IsTileCached("prefetch-tiles", 0));
+      EXPECT_TRUE(IsTileCached("prefetch-tiles", 1));
+      EXPECT_TRUE(IsTileCached("prefetch-tiles", 2));
+      EXPECT_TRUE(IsTileCached("prefetch-tiles", 3));
+      EXPECT_FALSE(IsTileCached("prefetch-tiles", 4));
+
+      ClosePdfDocument("prefetch-tiles");
+    }
+  } // namespace test
+} // namespace pdfviewer
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "render_stats.h"
+
+namespace pdfviewer
+{
+  namespace test
+  {
+    TEST(LatencyHistogram, QuantileOfEmptyHistogramIsZero)
+    {
+      LatencyHistogram histogram = {};
+      EXPECT_EQ(histogram.GetQuantile(0.5), 0u);
+      EXPECT_EQ(histogram.GetQuantile(1.0), 0u);
+    }
+
+    TEST(LatencyHistogram, QuantileIsUpperBoundOfItsBucket)
+    {
+      LatencyHistogram histogram = {};
+      for (guint64 microseconds = 1; microseconds <= 100; ++microseconds)
+        histogram.Record(microseconds);
+
+      EXPECT_EQ(histogram.count, 100u);
+      EXPECT_EQ(histogram.total, 5050u);
+      EXPECT_EQ(histogram.maximum, 100u);
+      EXPECT_EQ(histogram.GetQuantile(0.01), 1u);
+      // The 50th duration falls in the bucket from 32 to 63
+      EXPECT_EQ(histogram.GetQuantile(0.5), 63u);
+      // The bucket from 64 to 127 is capped at the maximum
+      EXPECT_EQ(histogram.GetQuantile(0.99), 100u);
+    }
+
+    TEST(LatencyHistogram, DurationsUnderAMicrosecondAndBeyondTheLastBucket)
+    {
+      LatencyHistogram histogram = {};
+      histogram.Record(0);
+      EXPECT_EQ(histogram.GetQuantile(1.0), 0u);
+
+      guint64 longest = G_GUINT64_CONSTANT(1) << 40;
+      histogram.Record(longest);
+      EXPECT_EQ(histogram.buckets[LatencyHistogram::kBucketCount - 1], 1u);
+      EXPECT_EQ(histogram.GetQuantile(0.5), 0u);
+      EXPECT_EQ(histogram.GetQuantile(1.0), longest);
+    }
+
+    TEST(LatencyHistogram, MergeAddsTheBuckets)
+    {
+      LatencyHistogram first = {};
+      LatencyHistogram second = {};
+      first.Record(10);
+      second.Record(1000);
+      second.Record(1000);
+      first.Merge(second);
+
+      EXPECT_EQ(first.count, 3u);
+      EXPECT_EQ(first.total, 2010u);
+      EXPECT_EQ(first.maximum, 1000u);
+      EXPECT_EQ(first.GetQuantile(0.3), 15u);
+      EXPECT_EQ(first.GetQuantile(0.9), 1000u);
+    }
+  } // namespace test
+} // namespace pdfviewer
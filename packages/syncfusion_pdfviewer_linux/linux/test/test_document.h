@@ -0,0 +1,61 @@
+#ifndef PDFVIEWER_TEST_DOCUMENT_H_
+#define PDFVIEWER_TEST_DOCUMENT_H_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace pdfviewer
+{
+  namespace test
+  {
+    // Builds a document with a page of the given size in points per text,
+    // the text drawn in 4 point Helvetica near the top left corner. The text
+    // must not hold parentheses or backslashes.
+    inline std::string BuildTestDocument(const std::vector<std::string> &page_texts, int width, int height)
+    {
+      int pageCount = static_cast<int>(page_texts.size());
+      int objectCount = 3 + pageCount * 2;
+      std::vector<size_t> offsets(objectCount + 1, 0);
+      std::string pdf = "%PDF-1.4\n";
+      auto addObject = [&pdf, &offsets](int number, const std::string &body)
+      {
+        offsets[number] = pdf.size();
+        pdf += std::to_string(number) + " 0 obj\n" + body + "\nendobj\n";
+      };
+
+      std::string kids;
+      for (int i = 0; i < pageCount; ++i)
+        kids += std::to_string(4 + i * 2) + " 0 R ";
+      addObject(1, "<< /Type /Catalog /Pages 2 0 R >>");
+      addObject(2, "<< /Type /Pages /Kids [" + kids + "] /Count " + std::to_string(pageCount) + " >>");
+      addObject(3, "<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica >>");
+      for (int i = 0; i < pageCount; ++i)
+      {
+        std::string content =
+            page_texts[i].empty()
+                ? ""
+                : "BT /F1 4 Tf 10 " + std::to_string(height - 20) + " Td (" + page_texts[i] + ") Tj ET";
+        addObject(4 + i * 2, "<< /Type /Page /Parent 2 0 R /MediaBox [0 0 " + std::to_string(width) + " " +
+                                 std::to_string(height) + "] /Resources << /Font << /F1 3 0 R >> >> /Contents " +
+                                 std::to_string(5 + i * 2) + " 0 R >>");
+        addObject(5 + i * 2, "<< /Length " + std::to_string(content.size()) + " >>\nstream\n" + content +
+                                 "\nendstream");
+      }
+
+      size_t xref = pdf.size();
+      pdf += "xref\n0 " + std::to_string(objectCount + 1) + "\n0000000000 65535 f \n";
+      for (int number = 1; number <= objectCount; ++number)
+      {
+        char entry[21];
+        snprintf(entry, sizeof(entry), "%010zu 00000 n \n", offsets[number]);
+        pdf += entry;
+      }
+      pdf += "trailer\n<< /Size " + std::to_string(objectCount + 1) + " /Root 1 0 R >>\nstartxref\n" +
+             std::to_string(xref) + "\n%%EOF\n";
+      return pdf;
+    }
+  } // namespace test
+} // namespace pdfviewer
+
+#endif
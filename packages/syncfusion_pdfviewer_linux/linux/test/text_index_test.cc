@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "pdfviewer.h"
+#include "test/test_document.h"
+#include "text_index.h"
+
+namespace pdfviewer
+{
+  namespace test
+  {
+    static const int kIndexedPageCount = 200;
+
+    // Pages of filler text, with the words the tests look for on a few of
+    // them. The page deltas up to page 150 and the offset of the word on it
+    // take more than one byte in the postings.
+    static std::string BuildIndexedDocument()
+    {
+      std::vector<std::string> texts(kIndexedPageCount, "page");
+      texts[0] = "needle";
+      texts[1] = "Alpha";
+      texts[2] = "alpha beta";
+      texts[3] = "Beta";
+      std::string filler;
+      for (int i = 0; i < 70; ++i)
+        filler += "x ";
+      texts[150] = filler + "needle";
+      texts[199] = "needle and needle";
+      return BuildTestDocument(texts, 612, 792);
+    }
+
+    // Indexes every page of the open document
+    static void IndexDocument(TextIndex *index)
+    {
+      while (index->HasPending())
+        index->IndexPages(G_USEC_PER_SEC);
+    }
+
+    TEST(TextIndex, FindsPagesAcrossMultiByteDeltas)
+    {
+      std::string pdf = BuildIndexedDocument();
+      g_autoptr(GBytes) data = g_bytes_new(pdf.data(), pdf.size());
+      PdfDocument *document = InitializePdfRenderer(data, nullptr, "indexed-deltas", nullptr);
+      ASSERT_NE(document, nullptr);
+
+      TextIndex index(document);
+      IndexDocument(&index);
+      EXPECT_TRUE(index.IsComplete());
+      EXPECT_EQ(index.FindPages("needle"), (std::vector<int>{0, 150, 199}));
+      EXPECT_EQ(index.FindPages("page").size(), static_cast<size_t>(kIndexedPageCount - 6));
+
+      ClosePdfDocument("indexed-deltas");
+    }
+
+    TEST(TextIndex, FindsPagesHoldingEveryWordOfTheQuery)
+    {
+      std::string pdf = BuildIndexedDocument();
+      g_autoptr(GBytes) data = g_bytes_new(pdf.data(), pdf.size());
+      PdfDocument *document = InitializePdfRenderer(data, nullptr, "indexed-words", nullptr);
+      ASSERT_NE(document, nullptr);
+
+      TextIndex index(document);
+      IndexDocument(&index);
+      EXPECT_EQ(index.FindPages("alpha beta"), (std::vector<int>{2}));
+      // Words are case folded, and may be part of a longer word of the page
+      EXPECT_EQ(index.FindPages("ALPHA"), (std::vector<int>{1, 2}));
+      EXPECT_EQ(index.FindPages("eta"), (std::vector<int>{2, 3}));
+      EXPECT_TRUE(index.FindPages("missing").empty());
+      // A query without words can match any page
+      EXPECT_EQ(index.FindPages("!").size(), static_cast<size_t>(kIndexedPageCount));
+
+      ClosePdfDocument("indexed-words");
+    }
+  } // namespace test
+} // namespace pdfviewer
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "pdfviewer.h"
+#include "text_search.h"
+
+namespace pdfviewer
+{
+  namespace test
+  {
+    // Single page rotated by 90 degrees whose crop box is inset from the
+    // media box, with "Hello" drawn at 50, 100 in the page space
+    static const char kRotatedPage[] =
+        "%PDF-1.4\n"
+        "1 0 obj\n"
+        "<< /Type /Catalog /Pages 2 0 R >>\n"
+        "endobj\n"
+        "2 0 obj\n"
+        "<< /Type /Pages /Kids [3 0 R] /Count 1 >>\n"
+        "endobj\n"
+        "3 0 obj\n"
+        "<< /Type /Page /Parent 2 0 R /MediaBox [0 0 300 200] /CropBox [20 10 300 200] /Rotate 90 "
+        "/Resources << /Font << /F1 5 0 R >> >> /Contents 4 0 R >>\n"
+        "endobj\n"
+        "4 0 obj\n"
+        "<< /Length 36 >>\n"
+        "stream\n"
+        "BT /F1 20 Tf 50 100 Td (Hello) Tj ET\n"
+        "endstream\n"
+        "endobj\n"
+        "5 0 obj\n"
+        "<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica >>\n"
+        "endobj\n"
+        "xref\n"
+        "0 6\n"
+        "0000000000 65535 f \n"
+        "0000000009 00000 n \n"
+        "0000000058 00000 n \n"
+        "0000000115 00000 n \n"
+        "0000000277 00000 n \n"
+        "0000000363 00000 n \n"
+        "trailer\n"
+        "<< /Size 6 /Root 1 0 R >>\n"
+        "startxref\n"
+        "433\n"
+        "%%EOF\n";
+
+    TEST(TextSearch, RectsOfRotatedPageAreInUnrotatedCropBoxSpace)
+    {
+      g_autoptr(GBytes) data = g_bytes_new_static(kRotatedPage, strlen(kRotatedPage));
+      PdfDocument *document = InitializePdfRenderer(data, nullptr, "rotated", nullptr);
+      ASSERT_NE(document, nullptr);
+
+      TextSearch search("rotated", "Hello", 0, nullptr);
+      std::vector<TextMatch> matches;
+      EXPECT_EQ(search.SearchNextPage(document, &matches), 0);
+      ASSERT_EQ(matches.size(), 1u);
+      ASSERT_EQ(matches[0].rects.size(), 1u);
+
+      // The word runs along the unrotated x axis, from 50 - 20 to the right
+      // of the crop box, with its baseline 200 - 100 below the top
+      const FS_RECTF &rect = matches[0].rects[0];
+      EXPECT_NEAR(rect.left, 30, 2);
+      EXPECT_NEAR(rect.bottom, 100, 5);
+      EXPECT_LT(rect.top, rect.bottom);
+      EXPECT_GT(rect.right - rect.left, rect.bottom - rect.top);
+
+      EXPECT_EQ(search.SearchNextPage(document, &matches), -1);
+      ClosePdfDocument("rotated");
+    }
+  } // namespace test
+} // namespace pdfviewer
@@ -0,0 +1,339 @@
+#include "text_index.h"
+
+#include <glib/gstdio.h>
+#include <fpdf_text.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include "disk_cache.h"
+#include "pdfviewer.h"
+#include "render_worker.h"
+
+namespace pdfviewer
+{
+  // Start of an index file, followed by the format version
+  static const char kIndexMagic[4] = {'S', 'F', 'T', 'X'};
+  static const guint64 kIndexVersion = 1;
+  // Index files kept in the disk cache, the oldest are removed beyond it
+  static const int kMaximumCachedIndexes = 64;
+
+  // Splits the characters into words of letters and digits and passes each
+  // case folded word with the index of its first character
+  static void SplitWords(const std::vector<gunichar> &chars,
+                         const std::function<void(const std::string &word, int offset)> &callback)
+  {
+    std::string word;
+    int offset = 0;
+    for (size_t i = 0; i <= chars.size(); ++i)
+    {
+      if (i < chars.size() && g_unichar_isalnum(chars[i]))
+      {
+        if (word.empty())
+          offset = static_cast<int>(i);
+        gchar utf8[6];
+        word.append(utf8, g_unichar_to_utf8(chars[i], utf8));
+      }
+      else if (!word.empty())
+      {
+        gchar *folded = g_utf8_casefold(word.data(), static_cast<gssize>(word.size()));
+        callback(folded, offset);
+        g_free(folded);
+        word.clear();
+      }
+    }
+  }
+
+  static void WriteVarint(std::vector<guint8> *buffer, guint64 value)
+  {
+    while (value >= 0x80)
+    {
+      buffer->push_back(static_cast<guint8>(value | 0x80));
+      value >>= 7;
+    }
+    buffer->push_back(static_cast<guint8>(value));
+  }
+
+  static bool ReadVarint(const guint8 **data, const guint8 *end, guint64 *value)
+  {
+    *value = 0;
+    for (int shift = 0; *data < end && shift < 64; shift += 7)
+    {
+      guint8 byte = *(*data)++;
+      *value |= static_cast<guint64>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  // Marks the pages of the encoded occurrences of a word
+  static void DecodePages(const std::vector<guint8> &postings, std::vector<bool> *pages)
+  {
+    const guint8 *data = postings.data();
+    const guint8 *end = data + postings.size();
+    guint64 page = 0;
+    guint64 pageDelta = 0;
+    guint64 offset = 0;
+    while (ReadVarint(&data, end, &pageDelta) && ReadVarint(&data, end, &offset))
+    {
+      page += pageDelta;
+      if (page < pages->size())
+        (*pages)[page] = true;
+    }
+  }
+
+  // Path of the index file of the document, empty while the document has no
+  // identity or must not be cached. The words of an encrypted document are
+  // never written out in clear.
+  static std::string GetCachePath(PdfDocument *document)
+  {
+    if (!IsDiskCacheEnabled() || document->isEncrypted())
+      return "";
+
+    const std::string &identity = document->identity();
+    if (identity.empty())
+      return "";
+
+    gchar *path = g_build_filename(GetCacheDirectory("text_index").c_str(), (identity + ".idx").c_str(), nullptr);
+    std::string result = path;
+    g_free(path);
+    return result;
+  }
+
+  // Removes the least recently used index files once the cache holds too
+  // many, a load refreshes the modification time of its file
+  static void PruneCache(const gchar *directory)
+  {
+    GDir *dir = g_dir_open(directory, 0, nullptr);
+    if (!dir)
+      return;
+
+    std::vector<std::pair<gint64, std::string>> files;
+    while (const gchar *name = g_dir_read_name(dir))
+    {
+      if (!g_str_has_suffix(name, ".idx"))
+        continue;
+      gchar *path = g_build_filename(directory, name, nullptr);
+      GStatBuf stat;
+      if (g_stat(path, &stat) == 0)
+        files.emplace_back(static_cast<gint64>(stat.st_mtime), path);
+      g_free(path);
+    }
+    g_dir_close(dir);
+
+    if (static_cast<int>(files.size()) <= kMaximumCachedIndexes)
+      return;
+    std::sort(files.begin(), files.end());
+    for (size_t i = 0; i + kMaximumCachedIndexes < files.size(); ++i)
+      g_remove(files[i].second.c_str());
+  }
+
+  TextIndex::TextIndex(PdfDocument *document)
+      : document_(document), page_count_(document->pageCount()), next_page_(0), has_pending_(true),
+        scheduled_(false), cached_(false), cache_path_(GetCachePath(document))
+  {
+    if (Load())
+    {
+      next_page_ = page_count_;
+      has_pending_ = false;
+      cached_ = true;
+    }
+  }
+
+  void TextIndex::IndexPages(gint64 duration)
+  {
+    gint64 deadline = g_get_monotonic_time() + duration;
+    while (!IsComplete())
+    {
+      // Pages are indexed in order, which keeps the page deltas positive
+      if (!document_->IsPageAvailable(next_page_))
+      {
+        has_pending_ = false;
+        return;
+      }
+
+      // Loaded outside the page cache, indexing every page must not evict
+      // the pages being viewed
+      FPDF_PAGE page = FPDF_LoadPage(document_->pdfDocument(), next_page_);
+      if (page)
+      {
+        IndexPage(page, next_page_);
+        FPDF_ClosePage(page);
+      }
+      ++next_page_;
+      if (g_get_monotonic_time() >= deadline)
+        break;
+      RenderWorker::YieldSlice();
+    }
+
+    if (IsComplete())
+    {
+      has_pending_ = false;
+      Save();
+    }
+  }
+
+  void TextIndex::IndexPage(FPDF_PAGE page, int index)
+  {
+    FPDF_TEXTPAGE textPage = FPDFText_LoadPage(page);
+    if (!textPage)
+      return;
+
+    int count = FPDFText_CountChars(textPage);
+    std::vector<unsigned short> text(std::max(count, 0) + 1);
+    int written = count > 0 ? FPDFText_GetText(textPage, 0, count, text.data()) : 0;
+    FPDFText_ClosePage(textPage);
+
+    // Characters outside the basic plane take two UTF-16 units but count as
+    // one character in the offsets
+    std::vector<gunichar> chars;
+    for (int i = 0; i + 1 < written; ++i)
+    {
+      gunichar c = text[i];
+      if (c >= 0xD800 && c < 0xDC00 && i + 2 < written && text[i + 1] >= 0xDC00 && text[i + 1] < 0xE000)
+      {
+        c = 0x10000 + ((c - 0xD800) << 10) + (text[i + 1] - 0xDC00);
+        ++i;
+      }
+      chars.push_back(c);
+    }
+    SplitWords(chars, [this, index](const std::string &word, int offset)
+               { AddWord(word, index, offset); });
+  }
+
+  void TextIndex::AddWord(const std::string &word, int page, int offset)
+  {
+    // Each occurrence is the page delta, then the offset delta within the
+    // same page or the offset on a new page
+    auto inserted = words_.emplace(word, Postings{{}, 0, 0});
+    Postings &postings = inserted.first->second;
+    WriteVarint(&postings.data, static_cast<guint64>(page - postings.last_page));
+    WriteVarint(&postings.data, static_cast<guint64>(page == postings.last_page ? offset - postings.last_offset
+                                                                                : offset));
+    postings.last_page = page;
+    postings.last_offset = offset;
+  }
+
+  std::vector<int> TextIndex::FindPages(const std::string &query) const
+  {
+    std::vector<std::string> queryWords;
+    glong length = 0;
+    gunichar *ucs4 = g_utf8_to_ucs4(query.c_str(), -1, nullptr, &length, nullptr);
+    if (ucs4)
+    {
+      SplitWords(std::vector<gunichar>(ucs4, ucs4 + length), [&queryWords](const std::string &word, int)
+                 {
+        if (std::find(queryWords.begin(), queryWords.end(), word) == queryWords.end())
+          queryWords.push_back(word); });
+      g_free(ucs4);
+    }
+
+    // A query without words, such as punctuation, can match any page
+    std::vector<bool> candidates(page_count_, true);
+    for (const std::string &queryWord : queryWords)
+    {
+      // The first and last words of the query may be the end or the start of
+      // a longer word of the page
+      std::vector<bool> pages(page_count_, false);
+      for (const auto &entry : words_)
+      {
+        if (entry.first.find(queryWord) != std::string::npos)
+          DecodePages(entry.second.data, &pages);
+      }
+      for (int i = 0; i < page_count_; ++i)
+        candidates[i] = candidates[i] && pages[i];
+    }
+
+    std::vector<int> result;
+    for (int i = 0; i < page_count_; ++i)
+    {
+      if (candidates[i])
+        result.push_back(i);
+    }
+    return result;
+  }
+
+  // The file is the magic and the version, the page count and the word
+  // count, then each word with its length and its encoded occurrences
+  bool TextIndex::Load()
+  {
+    gchar *contents = nullptr;
+    gsize size = 0;
+    if (cache_path_.empty() || !g_file_get_contents(cache_path_.c_str(), &contents, &size, nullptr))
+      return false;
+
+    const guint8 *data = reinterpret_cast<const guint8 *>(contents);
+    const guint8 *end = data + size;
+    guint64 version = 0;
+    guint64 pageCount = 0;
+    guint64 wordCount = 0;
+    bool valid = size > sizeof(kIndexMagic) && memcmp(data, kIndexMagic, sizeof(kIndexMagic)) == 0;
+    data += sizeof(kIndexMagic);
+    valid = valid && ReadVarint(&data, end, &version) && version == kIndexVersion &&
+            ReadVarint(&data, end, &pageCount) && pageCount == static_cast<guint64>(page_count_) &&
+            ReadVarint(&data, end, &wordCount);
+    for (guint64 i = 0; valid && i < wordCount; ++i)
+    {
+      guint64 wordLength = 0;
+      guint64 postingsLength = 0;
+      valid = ReadVarint(&data, end, &wordLength) && wordLength <= static_cast<guint64>(end - data);
+      if (!valid)
+        break;
+      std::string word(reinterpret_cast<const char *>(data), wordLength);
+      data += wordLength;
+      valid = ReadVarint(&data, end, &postingsLength) && postingsLength <= static_cast<guint64>(end - data);
+      if (!valid)
+        break;
+      words_[word] = Postings{std::vector<guint8>(data, data + postingsLength), 0, 0};
+      data += postingsLength;
+    }
+    g_free(contents);
+
+    if (!valid)
+    {
+      words_.clear();
+      return false;
+    }
+    g_utime(cache_path_.c_str(), nullptr);
+    return true;
+  }
+
+  void TextIndex::ClearCache()
+  {
+    ClearCacheDirectory("text_index", ".idx");
+  }
+
+  void TextIndex::Save()
+  {
+    // A progressive document has its identity once all of it arrived
+    if (cache_path_.empty())
+      cache_path_ = GetCachePath(document_);
+    if (cache_path_.empty())
+      return;
+
+    std::vector<guint8> buffer(kIndexMagic, kIndexMagic + sizeof(kIndexMagic));
+    WriteVarint(&buffer, kIndexVersion);
+    WriteVarint(&buffer, static_cast<guint64>(page_count_));
+    WriteVarint(&buffer, words_.size());
+    for (const auto &entry : words_)
+    {
+      WriteVarint(&buffer, entry.first.size());
+      buffer.insert(buffer.end(), entry.first.begin(), entry.first.end());
+      WriteVarint(&buffer, entry.second.data.size());
+      buffer.insert(buffer.end(), entry.second.data.begin(), entry.second.data.end());
+    }
+
+    // Written to a temporary file and renamed, a reader never sees half an
+    // index
+    gchar *directory = g_path_get_dirname(cache_path_.c_str());
+    if (g_mkdir_with_parents(directory, 0700) == 0 &&
+        g_file_set_contents(cache_path_.c_str(), reinterpret_cast<const gchar *>(buffer.data()),
+                            static_cast<gssize>(buffer.size()), nullptr))
+    {
+      PruneCache(directory);
+    }
+    g_free(directory);
+  }
+} // namespace pdfviewer
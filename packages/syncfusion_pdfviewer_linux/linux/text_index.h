@@ -0,0 +1,87 @@
+#ifndef PDFVIEWER_TEXT_INDEX_H_
+#define PDFVIEWER_TEXT_INDEX_H_
+
+#include <glib.h>
+#include <fpdfview.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pdfviewer
+{
+  class PdfDocument;
+
+  // Inverted index of the words of a document, from each case folded word to
+  // the pages and character offsets it occurs at.
+  //
+  // The index is built once in the background, a few pages per pass on the
+  // render worker. While the disk cache is enabled it is saved to the user
+  // cache directory under the identity of the document, unless the document
+  // is encrypted, and opening the same document again, even after a restart,
+  // loads it from there. Searches then only visit the pages that hold every
+  // word of the query instead of the whole document.
+  class TextIndex
+  {
+  public:
+    // Loads the index of the document from the disk cache when it was built
+    // before, otherwise starts an empty index
+    explicit TextIndex(PdfDocument *document);
+
+    TextIndex(const TextIndex &) = delete;
+    TextIndex &operator=(const TextIndex &) = delete;
+
+    // Whether every page is indexed
+    bool IsComplete() const { return next_page_ >= page_count_; }
+    // Whether the index was read from the disk cache
+    bool isCached() const { return cached_; }
+
+    // Indexes the pages in order until the duration in microseconds is used
+    // up. Stops at a page whose data has not arrived, the index resumes there
+    // once it does. Saves the index once it is complete.
+    void IndexPages(gint64 duration);
+    // Whether a pass could still index pages
+    bool HasPending() const { return has_pending_; }
+    // Lets a new pass retry the page it stopped at, once more data arrived
+    void Resume() { has_pending_ = !IsComplete(); }
+
+    // Whether indexing passes are queued on the render worker
+    bool isScheduled() const { return scheduled_; }
+    void SetScheduled(bool scheduled) { scheduled_ = scheduled; }
+
+    // Returns the zero based indexes of the pages that may contain the UTF-8
+    // query, in order: the pages holding every word of the query, either
+    // whole or as part of a longer word. Only meaningful once complete.
+    std::vector<int> FindPages(const std::string &query) const;
+
+    // Removes every index saved in the disk cache
+    static void ClearCache();
+
+  private:
+    // Occurrences of a word, as variable length page and offset deltas
+    struct Postings
+    {
+      std::vector<guint8> data;
+      int last_page;
+      int last_offset;
+    };
+
+    void IndexPage(FPDF_PAGE page, int index);
+    void AddWord(const std::string &word, int page, int offset);
+    bool Load();
+    void Save();
+
+    PdfDocument *document_;
+    int page_count_;
+    int next_page_;
+    bool has_pending_;
+    bool scheduled_;
+    bool cached_;
+    // File of the index in the disk cache, empty while the document has no
+    // identity
+    std::string cache_path_;
+    std::unordered_map<std::string, Postings> words_;
+  };
+} // namespace pdfviewer
+
+#endif
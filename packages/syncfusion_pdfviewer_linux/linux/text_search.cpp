@@ -0,0 +1,137 @@
+#include "text_search.h"
+
+#include <fpdf_edit.h>
+#include <fpdf_text.h>
+#include <fpdf_transformpage.h>
+
+#include <algorithm>
+
+#include "pdfviewer.h"
+#include "render_worker.h"
+
+namespace pdfviewer
+{
+  // Maps a rectangle of the page space to points from the top left corner of
+  // the crop box, before the page rotation, the space the page sizes of the
+  // Dart side are in
+  static FS_RECTF PageToCropBox(const FS_RECTF &crop_box, double left, double top, double right, double bottom)
+  {
+    FS_RECTF rect;
+    rect.left = static_cast<float>(std::min(left, right) - crop_box.left);
+    rect.top = static_cast<float>(crop_box.top - std::max(top, bottom));
+    rect.right = static_cast<float>(std::max(left, right) - crop_box.left);
+    rect.bottom = static_cast<float>(crop_box.top - std::min(top, bottom));
+    return rect;
+  }
+
+  TextSearch::TextSearch(const std::string &document_id, const gchar *query, int flags,
+                         std::shared_ptr<RenderToken> token)
+      : document_id_(document_id), flags_(0), token_(token), has_pages_(false), next_page_(0), match_count_(0)
+  {
+    glong length = 0;
+    gunichar2 *utf16 = g_utf8_to_utf16(query ? query : "", -1, nullptr, &length, nullptr);
+    if (utf16 && length > 0)
+    {
+      query_.assign(utf16, utf16 + length);
+      // FPDFText_FindStart expects a terminated string
+      query_.push_back(0);
+    }
+    g_free(utf16);
+
+    if (flags & kTextSearchMatchCase)
+      flags_ |= FPDF_MATCHCASE;
+    if (flags & kTextSearchWholeWord)
+      flags_ |= FPDF_MATCHWHOLEWORD;
+  }
+
+  void TextSearch::SetPages(std::vector<int> pages)
+  {
+    pages_ = std::move(pages);
+    has_pages_ = true;
+    next_page_ = 0;
+  }
+
+  bool TextSearch::IsComplete(PdfDocument *document) const
+  {
+    int pageCount = has_pages_ ? static_cast<int>(pages_.size()) : (document ? document->pageCount() : 0);
+    return query_.empty() || !document || next_page_ >= pageCount || (token_ && token_->IsCancelled());
+  }
+
+  int TextSearch::SearchNextPage(PdfDocument *document, std::vector<TextMatch> *matches)
+  {
+    matches->clear();
+    if (IsComplete(document))
+      return -1;
+
+    int index = has_pages_ ? pages_[next_page_++] : next_page_++;
+    if (index >= document->pageCount() || !document->IsPageAvailable(index))
+      return index;
+
+    // Loaded outside the page cache, a search over every page must not evict
+    // the pages being viewed
+    FPDF_PAGE page = FPDF_LoadPage(document->pdfDocument(), index);
+    if (!page)
+      return index;
+
+    FPDF_TEXTPAGE textPage = FPDFText_LoadPage(page);
+    if (textPage)
+    {
+      FS_RECTF cropBox = {0, 0, 0, 0};
+      if (!FPDFPage_GetCropBox(page, &cropBox.left, &cropBox.bottom, &cropBox.right, &cropBox.top) &&
+          !FPDFPage_GetMediaBox(page, &cropBox.left, &cropBox.bottom, &cropBox.right, &cropBox.top))
+      {
+        // Neither box is set, the page space starts at the bottom left corner
+        cropBox.top = FPDFPage_GetRotation(page) % 2 ? FPDF_GetPageWidthF(page) : FPDF_GetPageHeightF(page);
+      }
+      FPDF_SCHHANDLE search = FPDFText_FindStart(textPage, reinterpret_cast<FPDF_WIDESTRING>(query_.data()),
+                                                 flags_, 0);
+      while (search && FPDFText_FindNext(search))
+      {
+        if (token_ && token_->IsCancelled())
+          break;
+        RenderWorker::YieldSlice();
+
+        TextMatch match;
+        match.char_index = FPDFText_GetSchResultIndex(search);
+        match.char_count = FPDFText_GetSchCount(search);
+        int rectCount = FPDFText_CountRects(textPage, match.char_index, match.char_count);
+        for (int i = 0; i < rectCount; ++i)
+        {
+          double left = 0, top = 0, right = 0, bottom = 0;
+          if (FPDFText_GetRect(textPage, i, &left, &top, &right, &bottom))
+            match.rects.push_back(PageToCropBox(cropBox, left, top, right, bottom));
+        }
+        matches->push_back(std::move(match));
+      }
+      if (search)
+        FPDFText_FindClose(search);
+      FPDFText_ClosePage(textPage);
+    }
+    FPDF_ClosePage(page);
+
+    match_count_ += static_cast<int>(matches->size());
+    return index;
+  }
+
+  gchar *ExtractPageText(PdfDocument *document, int index)
+  {
+    if (index < 0 || index >= document->pageCount() || !document->IsPageAvailable(index))
+      return nullptr;
+
+    FPDF_PAGE page = document->LoadPage(index);
+    FPDF_TEXTPAGE textPage = page ? FPDFText_LoadPage(page) : nullptr;
+    if (!textPage)
+      return nullptr;
+
+    // FPDFText_GetText writes the characters and a terminator
+    int count = FPDFText_CountChars(textPage);
+    std::vector<unsigned short> buffer(std::max(count, 0) + 1);
+    int written = FPDFText_GetText(textPage, 0, std::max(count, 0), buffer.data());
+    FPDFText_ClosePage(textPage);
+
+    glong length = std::max(written - 1, 0);
+    gchar *text = g_utf16_to_utf8(reinterpret_cast<const gunichar2 *>(buffer.data()), length, nullptr, nullptr,
+                                  nullptr);
+    return text ? text : g_strdup("");
+  }
+} // namespace pdfviewer
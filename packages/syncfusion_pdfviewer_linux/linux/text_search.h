@@ -0,0 +1,85 @@
+#ifndef PDFVIEWER_TEXT_SEARCH_H_
+#define PDFVIEWER_TEXT_SEARCH_H_
+
+#include <glib.h>
+#include <fpdfview.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "render_request.h"
+
+namespace pdfviewer
+{
+  class PdfDocument;
+
+  // Options of a text search
+  enum TextSearchFlags
+  {
+    kTextSearchMatchCase = 1 << 0,
+    kTextSearchWholeWord = 1 << 1,
+  };
+
+  // Occurrence of the searched text on a page. A match that wraps over lines
+  // has a rectangle per line, each as left, top, right and bottom in points
+  // from the top left corner of the crop box. The page rotation is not
+  // applied, like to the page sizes of the Dart side.
+  struct TextMatch
+  {
+    int char_index;
+    int char_count;
+    std::vector<FS_RECTF> rects;
+  };
+
+  // Search of a text through all pages of a document.
+  //
+  // The search runs on the render worker a few pages at a time in the
+  // background class, so renders queued meanwhile are not held up behind a
+  // long document. Pages whose data has not arrived in a progressively opened
+  // document are skipped.
+  class TextSearch
+  {
+  public:
+    // Starts a search of the UTF-8 query with the TextSearchFlags. The token
+    // stops the search once cancelled.
+    TextSearch(const std::string &document_id, const gchar *query, int flags,
+               std::shared_ptr<RenderToken> token);
+
+    TextSearch(const TextSearch &) = delete;
+    TextSearch &operator=(const TextSearch &) = delete;
+
+    const std::string &documentID() const { return document_id_; }
+    const RenderToken *token() const { return token_.get(); }
+
+    // Searches only the pages of the zero based indexes, in order, such as
+    // the pages the text index found the words of the query on
+    void SetPages(std::vector<int> pages);
+
+    // Searches the next page and returns its zero based index, filling the
+    // matches found on it. Returns -1 once all pages were searched.
+    int SearchNextPage(PdfDocument *document, std::vector<TextMatch> *matches);
+    bool IsComplete(PdfDocument *document) const;
+
+    // Number of matches found so far
+    int matchCount() const { return match_count_; }
+
+  private:
+    std::string document_id_;
+    // Query as the UTF-16 string PDFium expects
+    std::vector<unsigned short> query_;
+    unsigned long flags_;
+    std::shared_ptr<RenderToken> token_;
+    // Pages to search, all pages when not set
+    std::vector<int> pages_;
+    bool has_pages_;
+    int next_page_;
+    int match_count_;
+  };
+
+  // Returns the text of the page at the zero based index as a newly allocated
+  // UTF-8 string, null when the page is not available
+  gchar *ExtractPageText(PdfDocument *document, int index);
+} // namespace pdfviewer
+
+#endif
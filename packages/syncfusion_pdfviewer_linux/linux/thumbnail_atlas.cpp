@@ -0,0 +1,376 @@
+#include "thumbnail_atlas.h"
+
+#include <fpdf_thumbnail.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "disk_cache.h"
+#include "memory_budget.h"
+#include "pdfviewer.h"
+#include "render_request.h"
+#include "render_worker.h"
+
+namespace pdfviewer
+{
+  // Upper bound of the atlas size in pixels, 4 MB of pixels at most
+  static const int kMaximumAtlasWidth = 1024;
+  static const int kMaximumAtlasHeight = 1024;
+  // Atlases holding pixels at a time per document
+  static const int kMaximumResidentAtlases = 4;
+  // Gap between two thumbnails, so that filtering never bleeds a neighbour in
+  static const int kThumbnailPadding = 1;
+  // Thumbnails are small, anti-aliasing is not worth its cost there
+  static const int kThumbnailRenderFlags = FPDF_REVERSE_BYTE_ORDER | FPDF_RENDER_NO_SMOOTHTEXT |
+                                           FPDF_RENDER_NO_SMOOTHIMAGE | FPDF_RENDER_NO_SMOOTHPATH;
+
+  // Scales an embedded thumbnail bitmap into the RGBA cell with bilinear
+  // filtering
+  static void CopyScaled(FPDF_BITMAP source, guint8 *target, int target_stride, int width, int height)
+  {
+    const guint8 *pixels = static_cast<const guint8 *>(FPDFBitmap_GetBuffer(source));
+    int sourceWidth = FPDFBitmap_GetWidth(source);
+    int sourceHeight = FPDFBitmap_GetHeight(source);
+    int sourceStride = FPDFBitmap_GetStride(source);
+    int format = FPDFBitmap_GetFormat(source);
+    int pixelSize = format == FPDFBitmap_Gray ? 1 : format == FPDFBitmap_BGR ? 3 : 4;
+
+    for (int y = 0; y < height; ++y)
+    {
+      double sourceY = std::max(0.0, (y + 0.5) * sourceHeight / height - 0.5);
+      int y0 = std::min(static_cast<int>(sourceY), sourceHeight - 1);
+      int y1 = std::min(y0 + 1, sourceHeight - 1);
+      double fractionY = sourceY - y0;
+      guint8 *row = target + static_cast<gsize>(y) * target_stride;
+      for (int x = 0; x < width; ++x)
+      {
+        double sourceX = std::max(0.0, (x + 0.5) * sourceWidth / width - 0.5);
+        int x0 = std::min(static_cast<int>(sourceX), sourceWidth - 1);
+        int x1 = std::min(x0 + 1, sourceWidth - 1);
+        double fractionX = sourceX - x0;
+        const guint8 *corners[4] = {
+            pixels + y0 * sourceStride + x0 * pixelSize,
+            pixels + y0 * sourceStride + x1 * pixelSize,
+            pixels + y1 * sourceStride + x0 * pixelSize,
+            pixels + y1 * sourceStride + x1 * pixelSize,
+        };
+        // BGR order in the source, RGB in the atlas
+        for (int channel = 0; channel < 3; ++channel)
+        {
+          int offset = pixelSize == 1 ? 0 : 2 - channel;
+          double top = corners[0][offset] + (corners[1][offset] - corners[0][offset]) * fractionX;
+          double bottom = corners[2][offset] + (corners[3][offset] - corners[2][offset]) * fractionX;
+          row[x * 4 + channel] = static_cast<guint8>(std::lround(top + (bottom - top) * fractionY));
+        }
+        row[x * 4 + 3] = 0xFF;
+      }
+    }
+  }
+
+  ThumbnailAtlas::ThumbnailAtlas(PdfDocument *document, int thumbnail_height)
+      : document_(document),
+        thumbnail_height_(std::min(std::max(thumbnail_height, kMinimumThumbnailHeight), kMaximumThumbnailHeight)),
+        next_page_(0), has_pending_(true), scheduled_(false), pass_(0), first_visible_page_(-1), last_visible_page_(-1)
+  {
+    // Shelf packing, rows of thumbnails of the same height filled left to
+    // right, a new atlas once the rows reach the maximum height
+    int pageCount = document_->pageCount();
+    cells_.resize(pageCount);
+    int x = 0;
+    int y = 0;
+    for (int i = 0; i < pageCount; ++i)
+    {
+      const PageGeometry &geometry = document_->GetPageGeometry(i, false);
+      double aspect = geometry.width > 0 && geometry.height > 0 ? geometry.width / geometry.height : 1.0;
+      int width = std::min(std::max(1, static_cast<int>(std::lround(thumbnail_height_ * aspect))), kMaximumAtlasWidth);
+      int height = std::min(thumbnail_height_, std::max(1, static_cast<int>(std::lround(width / aspect))));
+
+      if (x > 0 && x + width > kMaximumAtlasWidth)
+      {
+        x = 0;
+        y += thumbnail_height_ + kThumbnailPadding;
+      }
+      if (atlases_.empty() || y + thumbnail_height_ > kMaximumAtlasHeight)
+      {
+        atlases_.push_back(Atlas{0, 0, nullptr, 0, 0, false, {}, 0});
+        x = 0;
+        y = 0;
+      }
+
+      Atlas &atlas = atlases_.back();
+      cells_[i] = ThumbnailCell{static_cast<int>(atlases_.size()) - 1, x, y, width, height, ThumbnailSource::kPending};
+      atlas.width = std::max(atlas.width, x + width);
+      atlas.height = std::max(atlas.height, y + height);
+      ++atlas.pending;
+      x += width + kThumbnailPadding;
+    }
+  }
+
+  ThumbnailAtlas::~ThumbnailAtlas()
+  {
+    for (Atlas &atlas : atlases_)
+    {
+      if (!atlas.pixels)
+        continue;
+      g_free(atlas.pixels);
+      MemoryBudget::Shared().Charge(document_->documentID(), MemoryCategory::kThumbnails,
+                                    -static_cast<gssize>(static_cast<gsize>(atlas.width) * atlas.allocated_height * 4));
+    }
+  }
+
+  std::vector<int> ThumbnailAtlas::GenerateNext(int count)
+  {
+    std::vector<int> generated;
+    int pageCount = static_cast<int>(cells_.size());
+    ++pass_;
+    while (next_page_ < pageCount && static_cast<int>(generated.size()) < count)
+    {
+      int index = next_page_++;
+      if (cells_[index].source != ThumbnailSource::kPending || atlases_[cells_[index].atlas].evicted)
+        continue;
+      if (Generate(index))
+      {
+        generated.push_back(index);
+      }
+      else if (RenderWorker::IsPreempted())
+      {
+        // The render gave way to a more urgent job, the next pass retries it
+        next_page_ = index;
+        return generated;
+      }
+    }
+    if (next_page_ >= pageCount)
+    {
+      has_pending_ = false;
+      next_page_ = 0;
+    }
+    return generated;
+  }
+
+  bool ThumbnailAtlas::IsAtlasVisible(int atlas) const
+  {
+    for (int i = std::max(first_visible_page_, 0); i <= last_visible_page_ && i < static_cast<int>(cells_.size()); ++i)
+    {
+      if (cells_[i].atlas == atlas)
+        return true;
+    }
+    return false;
+  }
+
+  void ThumbnailAtlas::SetVisiblePages(int first_index, int last_index)
+  {
+    first_visible_page_ = first_index;
+    last_visible_page_ = last_index;
+    for (int i = 0; i < static_cast<int>(atlases_.size()); ++i)
+    {
+      if (atlases_[i].evicted && IsAtlasVisible(i))
+      {
+        atlases_[i].evicted = false;
+        Resume();
+      }
+    }
+  }
+
+  gsize ThumbnailAtlas::Evict(int atlas_index)
+  {
+    Atlas &atlas = atlases_[atlas_index];
+    gsize size = static_cast<gsize>(atlas.width) * atlas.allocated_height * 4;
+    g_free(atlas.pixels);
+    atlas.pixels = nullptr;
+    atlas.allocated_height = 0;
+    atlas.evicted = true;
+    atlas.updated_pages.clear();
+    MemoryBudget::Shared().Charge(document_->documentID(), MemoryCategory::kThumbnails, -static_cast<gssize>(size));
+
+    // Every thumbnail of the atlas has to be generated again
+    atlas.pending = 0;
+    for (ThumbnailCell &cell : cells_)
+    {
+      if (cell.atlas != atlas_index)
+        continue;
+      cell.source = ThumbnailSource::kPending;
+      ++atlas.pending;
+    }
+    return size;
+  }
+
+  gsize ThumbnailAtlas::EvictHiddenAtlases()
+  {
+    gsize freed = 0;
+    for (int i = 0; i < static_cast<int>(atlases_.size()); ++i)
+    {
+      if (atlases_[i].pixels && !IsAtlasVisible(i))
+        freed += Evict(i);
+    }
+    return freed;
+  }
+
+  bool ThumbnailAtlas::Allocate(int atlas_index, int rows)
+  {
+    Atlas &atlas = atlases_[atlas_index];
+    if (rows <= atlas.allocated_height)
+      return true;
+
+    if (!atlas.pixels)
+    {
+      // A new atlas takes the place of the least recently used hidden one
+      int resident = 0;
+      int oldest = -1;
+      for (int i = 0; i < static_cast<int>(atlases_.size()); ++i)
+      {
+        if (!atlases_[i].pixels)
+          continue;
+        ++resident;
+        if (!IsAtlasVisible(i) && (oldest < 0 || atlases_[i].last_used < atlases_[oldest].last_used))
+          oldest = i;
+      }
+      if (resident >= kMaximumResidentAtlases)
+      {
+        if (oldest < 0)
+        {
+          // Every resident atlas is on screen, this one waits until it is
+          atlas.evicted = true;
+          return false;
+        }
+        Evict(oldest);
+      }
+    }
+
+    gsize rowSize = static_cast<gsize>(atlas.width) * 4;
+    guint8 *pixels = static_cast<guint8 *>(g_try_realloc(atlas.pixels, rowSize * rows));
+    if (!pixels)
+      return false;
+    memset(pixels + rowSize * atlas.allocated_height, 0xFF, rowSize * (rows - atlas.allocated_height));
+    MemoryBudget::Shared().Charge(document_->documentID(), MemoryCategory::kThumbnails,
+                                  static_cast<gssize>(rowSize * (rows - atlas.allocated_height)));
+    atlas.pixels = pixels;
+    atlas.allocated_height = rows;
+    return true;
+  }
+
+  std::vector<int> ThumbnailAtlas::TakeUpdatedPages(int atlas_index, bool all)
+  {
+    Atlas &atlas = atlases_[atlas_index];
+    std::vector<int> pages;
+    if (all)
+    {
+      for (int i = 0; i < static_cast<int>(cells_.size()); ++i)
+      {
+        if (cells_[i].atlas == atlas_index && cells_[i].source != ThumbnailSource::kPending &&
+            cells_[i].source != ThumbnailSource::kFailed)
+          pages.push_back(i);
+      }
+      atlas.updated_pages.clear();
+    }
+    else
+    {
+      pages.swap(atlas.updated_pages);
+    }
+    return pages;
+  }
+
+  // Copies the rows of a cell between the atlas and tightly packed pixels
+  static void CopyCell(const guint8 *source, int source_stride, guint8 *target, int target_stride, int width,
+                       int height)
+  {
+    for (int y = 0; y < height; ++y)
+      memcpy(target + static_cast<gsize>(y) * target_stride, source + static_cast<gsize>(y) * source_stride,
+             static_cast<gsize>(width) * 4);
+  }
+
+  void ThumbnailAtlas::ReadCell(int index, guint8 *target) const
+  {
+    const ThumbnailCell &cell = cells_[index];
+    const Atlas &atlas = atlases_[cell.atlas];
+    CopyCell(atlas.pixels + (static_cast<gsize>(cell.y) * atlas.width + cell.x) * 4, atlas.width * 4, target,
+             cell.width * 4, cell.width, cell.height);
+  }
+
+  // Returns false when the page stays pending
+  bool ThumbnailAtlas::Generate(int index)
+  {
+    if (!document_->IsPageAvailable(index))
+      return false;
+
+    ThumbnailCell &cell = cells_[index];
+    Atlas &atlas = atlases_[cell.atlas];
+    if (!Allocate(cell.atlas, cell.y + cell.height))
+      return false;
+    atlas.last_used = pass_;
+
+    guint8 *target = atlas.pixels + (static_cast<gsize>(cell.y) * atlas.width + cell.x) * 4;
+    int stride = atlas.width * 4;
+    int cellStride = cell.width * 4;
+    gsize cellSize = static_cast<gsize>(cellStride) * cell.height;
+    std::string diskKey = GetThumbnailCacheKey(document_, index, cell.height);
+    GBytes *stored = DiskTileCache::Shared().Lookup(diskKey, cellSize);
+    if (stored)
+    {
+      CopyCell(static_cast<const guint8 *>(g_bytes_get_data(stored, nullptr)), cellStride, target, stride, cell.width,
+               cell.height);
+      g_bytes_unref(stored);
+      cell.source = ThumbnailSource::kCached;
+      --atlas.pending;
+      atlas.updated_pages.push_back(index);
+      return true;
+    }
+
+    // Loaded outside the page cache, a pass over every page must not evict
+    // the pages being viewed
+    FPDF_PAGE page = FPDF_LoadPage(document_->pdfDocument(), index);
+    if (page)
+    {
+      RenderStatus status = RenderStatus::kDone;
+      FPDF_BITMAP thumbnail = FPDFPage_GetThumbnailAsBitmap(page);
+      if (thumbnail && FPDFBitmap_GetWidth(thumbnail) > 0 && FPDFBitmap_GetHeight(thumbnail) > 0)
+      {
+        CopyScaled(thumbnail, target, stride, cell.width, cell.height);
+        cell.source = ThumbnailSource::kEmbedded;
+      }
+      else
+      {
+        // The bitmap points into the atlas, the page is rendered in place
+        FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(cell.width, cell.height, FPDFBitmap_BGRx, target, stride);
+        if (bitmap)
+        {
+          // Cleared first, a preempted render may have left part of the page
+          FPDFBitmap_FillRect(bitmap, 0, 0, cell.width, cell.height, 0xFFFFFFFF);
+          status = RenderPageProgressive(bitmap, page, 0, 0, cell.width, cell.height, kThumbnailRenderFlags, nullptr,
+                                         document_->documentID());
+          FPDFBitmap_Destroy(bitmap);
+          cell.source = status == RenderStatus::kDone ? ThumbnailSource::kRendered : ThumbnailSource::kFailed;
+        }
+        else
+        {
+          cell.source = ThumbnailSource::kFailed;
+        }
+      }
+      if (thumbnail)
+        FPDFBitmap_Destroy(thumbnail);
+      FPDF_ClosePage(page);
+      if (status == RenderStatus::kPreempted)
+      {
+        cell.source = ThumbnailSource::kPending;
+        return false;
+      }
+
+      if (cell.source != ThumbnailSource::kFailed && !diskKey.empty())
+      {
+        guint8 *pixels = static_cast<guint8 *>(g_malloc(cellSize));
+        CopyCell(target, stride, pixels, cellStride, cell.width, cell.height);
+        GBytes *cellPixels = g_bytes_new_take(pixels, cellSize);
+        DiskTileCache::Shared().Store(diskKey, cellPixels);
+        g_bytes_unref(cellPixels);
+      }
+    }
+    else
+    {
+      cell.source = ThumbnailSource::kFailed;
+    }
+    --atlas.pending;
+    if (cell.source != ThumbnailSource::kFailed)
+      atlas.updated_pages.push_back(index);
+    return true;
+  }
+} // namespace pdfviewer
@@ -0,0 +1,135 @@
+#ifndef PDFVIEWER_THUMBNAIL_ATLAS_H_
+#define PDFVIEWER_THUMBNAIL_ATLAS_H_
+
+#include <glib.h>
+#include <fpdfview.h>
+
+#include <vector>
+
+namespace pdfviewer
+{
+  class PdfDocument;
+
+  // Bounds of the thumbnail height in pixels
+  const int kMinimumThumbnailHeight = 16;
+  const int kMaximumThumbnailHeight = 512;
+
+  // How the thumbnail of a page was produced
+  enum class ThumbnailSource
+  {
+    // Not generated yet, or the page data has not arrived
+    kPending,
+    // Decoded from the thumbnail image embedded in the page
+    kEmbedded,
+    // Rendered at low quality, the page has no embedded thumbnail
+    kRendered,
+    // The page could not be loaded
+    kFailed,
+    // Read back from the disk cache, generated in an earlier session
+    kCached,
+  };
+
+  // Cell of a page thumbnail in an atlas
+  struct ThumbnailCell
+  {
+    int atlas;
+    int x;
+    int y;
+    int width;
+    int height;
+    ThumbnailSource source;
+  };
+
+  // Bitmap holding many page thumbnails, tightly packed RGBA rows
+  struct Atlas
+  {
+    int width;
+    int height;
+    // Rows from the top down to the lowest thumbnail generated so far, grown
+    // as the shelves fill
+    guint8 *pixels;
+    int allocated_height;
+    // Thumbnails of the atlas that are not generated yet
+    int pending;
+    // The pixels were given up on memory pressure or to stay within the
+    // resident atlases, its thumbnails are only generated again once one of
+    // them is visible
+    bool evicted;
+    // Zero based indexes of the pages generated since Dart last read the atlas
+    std::vector<int> updated_pages;
+    // Generation pass that last wrote to the atlas, the least recent hidden
+    // atlas is evicted first
+    guint64 last_used;
+  };
+
+  // Thumbnails of all pages of a document, packed into a few atlas bitmaps.
+  //
+  // The layout is computed up front from the page geometry index, so the
+  // thumbnail pane can be laid out before any thumbnail exists. Thumbnails are
+  // then generated a few pages at a time on the render worker, preferring the
+  // thumbnail image embedded in the page and falling back to a fast low
+  // quality render when there is none. Only a few atlases are resident at a
+  // time, hidden ones are given up for new ones.
+  class ThumbnailAtlas
+  {
+  public:
+    // Lays out the thumbnails of the document at the given height in pixels
+    ThumbnailAtlas(PdfDocument *document, int thumbnail_height);
+    ~ThumbnailAtlas();
+
+    ThumbnailAtlas(const ThumbnailAtlas &) = delete;
+    ThumbnailAtlas &operator=(const ThumbnailAtlas &) = delete;
+
+    int thumbnailHeight() const { return thumbnail_height_; }
+    const std::vector<ThumbnailCell> &cells() const { return cells_; }
+    const std::vector<Atlas> &atlases() const { return atlases_; }
+
+    // Generates up to |count| pending thumbnails and returns the zero based
+    // indexes of the pages that were generated. Pages whose data has not
+    // arrived stay pending and are retried on the next pass.
+    std::vector<int> GenerateNext(int count);
+    // Whether a pass could still generate thumbnails
+    bool HasPending() const { return has_pending_; }
+    // Lets a new pass retry pages that were pending, once more data arrived
+    void Resume() { has_pending_ = true; next_page_ = 0; }
+
+    // Whether generation passes are queued on the render worker
+    bool isScheduled() const { return scheduled_; }
+    void SetScheduled(bool scheduled) { scheduled_ = scheduled; }
+
+    // Sets the zero based range of the pages whose thumbnails are displayed.
+    // Evicted atlases holding one of them are generated again.
+    void SetVisiblePages(int first_index, int last_index);
+    // Frees the atlases holding no thumbnail of the visible pages, on memory
+    // pressure, and returns the number of bytes freed
+    gsize EvictHiddenAtlases();
+
+    // Returns the zero based indexes of the pages of the atlas generated since
+    // the last call, or of every generated page when |all| is set
+    std::vector<int> TakeUpdatedPages(int atlas, bool all);
+    // Copies the thumbnail of the page as tightly packed RGBA rows
+    void ReadCell(int index, guint8 *target) const;
+
+  private:
+    bool Generate(int index);
+    bool IsAtlasVisible(int atlas) const;
+    // Makes room for the rows of the cell, false when out of memory or when
+    // no hidden atlas can be evicted for a new one
+    bool Allocate(int atlas, int rows);
+    gsize Evict(int atlas);
+
+    PdfDocument *document_;
+    int thumbnail_height_;
+    std::vector<ThumbnailCell> cells_;
+    std::vector<Atlas> atlases_;
+    int next_page_;
+    bool has_pending_;
+    bool scheduled_;
+    guint64 pass_;
+    // Visible pages, none before the first SetVisiblePages
+    int first_visible_page_;
+    int last_visible_page_;
+  };
+} // namespace pdfviewer
+
+#endif
@@ -0,0 +1,306 @@
+#include "tile_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "disk_cache.h"
+#include "downsample.h"
+#include "memory_budget.h"
+#include "pdfviewer.h"
+#include "render_worker.h"
+
+namespace pdfviewer
+{
+  // Tiles kept while over the memory budget, enough to cover the viewport
+  static const gsize kMinimumTileCacheBytes = 16 * 1024 * 1024;
+  // Zoom buckets per doubling of the scale
+  static const int kZoomBucketsPerOctave = 4;
+  // Octaves below a rendered tile that are derived from it by downsampling
+  static const int kPyramidLevels = 3;
+
+  int GetZoomBucket(double scale)
+  {
+    // Round up so that tiles are never rendered below the requested resolution
+    return static_cast<int>(std::ceil(std::log2(scale) * kZoomBucketsPerOctave - 1e-6));
+  }
+
+  double GetZoomBucketScale(int bucket)
+  {
+    return std::exp2(static_cast<double>(bucket) / kZoomBucketsPerOctave);
+  }
+
+  TileCache &TileCache::Shared()
+  {
+    static TileCache cache;
+    return cache;
+  }
+
+  TileCache::~TileCache()
+  {
+    for (Entry &entry : tiles_)
+      g_bytes_unref(entry.tile.pixels);
+  }
+
+  GBytes *TileCache::Lookup(const TileKey &key, int *width, int *height)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+      return nullptr;
+
+    tiles_.splice(tiles_.begin(), tiles_, it->second);
+    *width = it->second->tile.width;
+    *height = it->second->tile.height;
+    return g_bytes_ref(it->second->tile.pixels);
+  }
+
+  void TileCache::Insert(const TileKey &key, GBytes *pixels, int width, int height)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end())
+      Evict(it->second);
+
+    tiles_.push_front(Entry{key, Tile{g_bytes_ref(pixels), width, height}});
+    entries_[key] = tiles_.begin();
+    gsize size = g_bytes_get_size(pixels);
+    memory_usage_ += size;
+    MemoryBudget::Shared().Charge(key.document_id, MemoryCategory::kTiles, static_cast<gssize>(size));
+    EvictToBudget();
+  }
+
+  void TileCache::RemoveDocument(const gchar *document_id)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = tiles_.begin(); it != tiles_.end();)
+    {
+      auto current = it++;
+      if (current->key.document_id == document_id)
+        Evict(current);
+    }
+  }
+
+  gsize TileCache::Trim(gsize bytes)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    gsize released = 0;
+    while (released < bytes && !tiles_.empty())
+    {
+      released += g_bytes_get_size(tiles_.back().tile.pixels);
+      Evict(std::prev(tiles_.end()));
+    }
+    return released;
+  }
+
+  void TileCache::Evict(std::list<Entry>::iterator it)
+  {
+    gsize size = g_bytes_get_size(it->tile.pixels);
+    memory_usage_ -= size;
+    MemoryBudget::Shared().Charge(it->key.document_id, MemoryCategory::kTiles, -static_cast<gssize>(size));
+    g_bytes_unref(it->tile.pixels);
+    entries_.erase(it->key);
+    tiles_.erase(it);
+  }
+
+  // Tiles are the first to go when the plugin is over its memory budget, down
+  // to a floor that keeps the tiles of the viewport
+  void TileCache::EvictToBudget()
+  {
+    while (tiles_.size() > 1 && memory_usage_ > kMinimumTileCacheBytes && MemoryBudget::Shared().IsOverLimit())
+      Evict(std::prev(tiles_.end()));
+  }
+
+  void GetPagePixelSize(FPDF_PAGE page, int zoom_bucket, int *width, int *height)
+  {
+    double scale = GetZoomBucketScale(zoom_bucket);
+    *width = static_cast<int>(std::ceil(FPDF_GetPageWidthF(page) * scale));
+    *height = static_cast<int>(std::ceil(FPDF_GetPageHeightF(page) * scale));
+  }
+
+  // Size in pixels of the page at the zoom bucket, from the geometry index so
+  // that the page is not loaded
+  static void GetGeometryPixelSize(PdfDocument *document, int page_index, int zoom_bucket, int *width, int *height)
+  {
+    const PageGeometry &geometry = document->GetPageGeometry(page_index, false);
+    double scale = GetZoomBucketScale(zoom_bucket);
+    *width = static_cast<int>(std::ceil(geometry.width * scale));
+    *height = static_cast<int>(std::ceil(geometry.height * scale));
+  }
+
+  // Derives the tile at half the scale from the 2x2 tiles of the bucket that
+  // cover it, once all of them are cached, then carries on with the next
+  // coarser level. Zooming out then shows the tiles already seen at a higher
+  // zoom after a filter pass instead of a render.
+  static void BuildCoarserLevels(PdfDocument *document, int page_index, int zoom_bucket, int column, int row)
+  {
+    for (int level = 0; level < kPyramidLevels; ++level)
+    {
+      int parentBucket = zoom_bucket - kZoomBucketsPerOctave;
+      int parentColumn = column / 2;
+      int parentRow = row / 2;
+      TileKey parentKey{document->documentID(), page_index, parentBucket, parentColumn, parentRow};
+      int tileWidth = 0;
+      int tileHeight = 0;
+      GBytes *existing = TileCache::Shared().Lookup(parentKey, &tileWidth, &tileHeight);
+      if (existing)
+      {
+        g_bytes_unref(existing);
+        return;
+      }
+
+      int pageWidth = 0;
+      int pageHeight = 0;
+      GetGeometryPixelSize(document, page_index, parentBucket, &pageWidth, &pageHeight);
+      tileWidth = std::min(kGridTileSize, pageWidth - parentColumn * kGridTileSize);
+      tileHeight = std::min(kGridTileSize, pageHeight - parentRow * kGridTileSize);
+      int finePageWidth = 0;
+      int finePageHeight = 0;
+      GetGeometryPixelSize(document, page_index, zoom_bucket, &finePageWidth, &finePageHeight);
+      int sourceWidth = tileWidth * 2;
+      int sourceHeight = tileHeight * 2;
+      // The fine page can be a pixel narrower than twice the coarse one, its
+      // last column and row are then repeated
+      int coveredWidth = std::min(sourceWidth, finePageWidth - parentColumn * 2 * kGridTileSize);
+      int coveredHeight = std::min(sourceHeight, finePageHeight - parentRow * 2 * kGridTileSize);
+      if (tileWidth <= 0 || tileHeight <= 0 || coveredWidth <= 0 || coveredHeight <= 0)
+        return;
+
+      int sourceStride = sourceWidth * 4;
+      std::vector<guint8> source(static_cast<gsize>(sourceStride) * sourceHeight);
+      for (int y = 0; y < 2; ++y)
+      {
+        for (int x = 0; x < 2; ++x)
+        {
+          if (x * kGridTileSize >= coveredWidth || y * kGridTileSize >= coveredHeight)
+            continue;
+          TileKey childKey{document->documentID(), page_index, zoom_bucket, parentColumn * 2 + x, parentRow * 2 + y};
+          int childWidth = 0;
+          int childHeight = 0;
+          GBytes *child = TileCache::Shared().Lookup(childKey, &childWidth, &childHeight);
+          if (!child)
+            return;
+
+          const guint8 *pixels = static_cast<const guint8 *>(g_bytes_get_data(child, nullptr));
+          int copyWidth = std::min(childWidth, coveredWidth - x * kGridTileSize);
+          int copyHeight = std::min(childHeight, coveredHeight - y * kGridTileSize);
+          guint8 *target = source.data() + static_cast<gsize>(y * kGridTileSize) * sourceStride + x * kGridTileSize * 4;
+          for (int line = 0; line < copyHeight; ++line)
+            memcpy(target + static_cast<gsize>(line) * sourceStride, pixels + static_cast<gsize>(line) * childWidth * 4,
+                   static_cast<gsize>(copyWidth) * 4);
+          g_bytes_unref(child);
+        }
+      }
+      for (int line = 0; line < coveredHeight; ++line)
+      {
+        guint8 *sourceRow = source.data() + static_cast<gsize>(line) * sourceStride;
+        for (int x = coveredWidth; x < sourceWidth; ++x)
+          memcpy(sourceRow + x * 4, sourceRow + (coveredWidth - 1) * 4, 4);
+      }
+      for (int line = coveredHeight; line < sourceHeight; ++line)
+        memcpy(source.data() + static_cast<gsize>(line) * sourceStride,
+               source.data() + static_cast<gsize>(coveredHeight - 1) * sourceStride, sourceStride);
+
+      gsize size = static_cast<gsize>(tileWidth) * tileHeight * 4;
+      guint8 *pixels = static_cast<guint8 *>(g_try_malloc(size));
+      if (!pixels)
+        return;
+      Downsample2x(source.data(), sourceStride, pixels, tileWidth * 4, tileWidth, tileHeight);
+      GBytes *tile = g_bytes_new_take(pixels, size);
+      TileCache::Shared().Insert(parentKey, tile, tileWidth, tileHeight);
+      g_bytes_unref(tile);
+
+      zoom_bucket = parentBucket;
+      column = parentColumn;
+      row = parentRow;
+    }
+  }
+
+  // Builds the coarser levels above a tile in a prefetch job, so that the
+  // filter passes never delay the response carrying the tile
+  static void ScheduleCoarserLevels(PdfDocument *document, int page_index, int zoom_bucket, int column, int row)
+  {
+    std::string documentID = document->documentID();
+    RenderWorker::PostFollowUp(
+        [documentID, page_index, zoom_bucket, column, row]()
+        {
+          PdfDocument *document = GetPdfDocument(documentID.c_str());
+          if (document)
+            BuildCoarserLevels(document, page_index, zoom_bucket, column, row);
+        },
+        RenderPriority::kPrefetch);
+  }
+
+  GBytes *GetGridTile(PdfDocument *document, int page_index, int zoom_bucket, int column, int row,
+                      const RenderToken *token, int *width, int *height)
+  {
+    TileKey key{document->documentID(), page_index, zoom_bucket, column, row};
+    GBytes *cached = TileCache::Shared().Lookup(key, width, height);
+    if (cached)
+      return cached;
+
+    // Tiles of a document seen in an earlier session are read back from
+    // disk, sized from the geometry index so that the page is not loaded
+    std::string diskKey;
+    if (document->IsPageAvailable(page_index))
+    {
+      diskKey = GetTileCacheKey(document, page_index, zoom_bucket, column, row);
+      int pageWidth = 0;
+      int pageHeight = 0;
+      GetGeometryPixelSize(document, page_index, zoom_bucket, &pageWidth, &pageHeight);
+      int tileWidth = std::min(kGridTileSize, pageWidth - column * kGridTileSize);
+      int tileHeight = std::min(kGridTileSize, pageHeight - row * kGridTileSize);
+      gsize size = static_cast<gsize>(std::max(tileWidth, 0)) * std::max(tileHeight, 0) * 4;
+      GBytes *stored = size > 0 ? DiskTileCache::Shared().Lookup(diskKey, size) : nullptr;
+      if (stored)
+      {
+        *width = tileWidth;
+        *height = tileHeight;
+        TileCache::Shared().Insert(key, stored, tileWidth, tileHeight);
+        ScheduleCoarserLevels(document, page_index, zoom_bucket, column, row);
+        return stored;
+      }
+    }
+
+    // Pinned, the jobs run while the render yields cannot close the page
+    PinnedPage pinnedPage(document, page_index);
+    FPDF_PAGE page = pinnedPage.page();
+    if (!page)
+      return nullptr;
+
+    int pageWidth = 0;
+    int pageHeight = 0;
+    GetPagePixelSize(page, zoom_bucket, &pageWidth, &pageHeight);
+    *width = std::min(kGridTileSize, pageWidth - column * kGridTileSize);
+    *height = std::min(kGridTileSize, pageHeight - row * kGridTileSize);
+    if (*width <= 0 || *height <= 0)
+      return nullptr;
+
+    // Render straight into the memory the cache keeps
+    int stride = *width * 4;
+    gsize size = static_cast<gsize>(stride) * *height;
+    guint8 *pixels = static_cast<guint8 *>(g_try_malloc(size));
+    if (!pixels)
+      return nullptr;
+
+    FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(*width, *height, FPDFBitmap_BGRx, pixels, stride);
+    FPDFBitmap_FillRect(bitmap, 0, 0, *width, *height, 0xFFFFFFFF);
+    RenderStatus status = RenderPageProgressive(bitmap, page, -column * kGridTileSize, -row * kGridTileSize,
+                                                pageWidth, pageHeight, FPDF_LCD_TEXT | FPDF_REVERSE_BYTE_ORDER,
+                                                token, document->documentID());
+    FPDFBitmap_Destroy(bitmap);
+    if (status != RenderStatus::kDone)
+    {
+      g_free(pixels);
+      return nullptr;
+    }
+
+    GBytes *tile = g_bytes_new_take(pixels, size);
+    DiskTileCache::Shared().Store(diskKey, tile);
+    TileCache::Shared().Insert(key, tile, *width, *height);
+    ScheduleCoarserLevels(document, page_index, zoom_bucket, column, row);
+    return tile;
+  }
+} // namespace pdfviewer
@@ -0,0 +1,111 @@
+#ifndef PDFVIEWER_TILE_ENGINE_H_
+#define PDFVIEWER_TILE_ENGINE_H_
+
+#include <glib.h>
+#include <fpdfview.h>
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "render_request.h"
+
+namespace pdfviewer
+{
+  class PdfDocument;
+
+  // Edge length in pixels of the grid tiles
+  const int kGridTileSize = 256;
+
+  // Zoom levels are quantized to quarter octaves, so that nearby scales share
+  // the same grid and therefore the same cached tiles.
+  int GetZoomBucket(double scale);
+  double GetZoomBucketScale(int bucket);
+
+  // Identifies a tile of a page rendered at a zoom bucket
+  struct TileKey
+  {
+    std::string document_id;
+    int page_index;
+    int zoom_bucket;
+    int column;
+    int row;
+
+    bool operator==(const TileKey &other) const
+    {
+      return page_index == other.page_index && zoom_bucket == other.zoom_bucket &&
+             column == other.column && row == other.row && document_id == other.document_id;
+    }
+  };
+
+  struct TileKeyHash
+  {
+    std::size_t operator()(const TileKey &key) const
+    {
+      std::size_t hash = std::hash<std::string>()(key.document_id);
+      hash = hash * 31 + static_cast<std::size_t>(key.page_index);
+      hash = hash * 31 + static_cast<std::size_t>(key.zoom_bucket);
+      hash = hash * 31 + static_cast<std::size_t>(key.column);
+      hash = hash * 31 + static_cast<std::size_t>(key.row);
+      return hash;
+    }
+  };
+
+  // Rendered tile, tightly packed RGBA rows
+  struct Tile
+  {
+    GBytes *pixels;
+    int width;
+    int height;
+  };
+
+  // LRU of rendered grid tiles shared by all documents, bounded by the global
+  // memory budget.
+  class TileCache
+  {
+  public:
+    static TileCache &Shared();
+
+    ~TileCache();
+
+    // Returns a new reference to the cached tile pixels, or null on a miss
+    GBytes *Lookup(const TileKey &key, int *width, int *height);
+    // Stores the tile, the cache takes its own reference to the pixels
+    void Insert(const TileKey &key, GBytes *pixels, int width, int height);
+    // Drops every tile of the document
+    void RemoveDocument(const gchar *document_id);
+    // Drops the least recently used tiles until at least |bytes| are released,
+    // returns the bytes released
+    gsize Trim(gsize bytes);
+
+  private:
+    struct Entry
+    {
+      TileKey key;
+      Tile tile;
+    };
+
+    TileCache() : memory_usage_(0) {}
+
+    void Evict(std::list<Entry>::iterator it);
+    void EvictToBudget();
+
+    std::mutex mutex_;
+    // Most recently used tile first
+    std::list<Entry> tiles_;
+    std::unordered_map<TileKey, std::list<Entry>::iterator, TileKeyHash> entries_;
+    gsize memory_usage_;
+  };
+
+  // Size in pixels of the page at the zoom bucket
+  void GetPagePixelSize(FPDF_PAGE page, int zoom_bucket, int *width, int *height);
+
+  // Returns the tile from the cache, rendering and caching it on a miss.
+  // Returns null when the page is missing or the render was cancelled. The
+  // coarser levels derived from a new tile are built in a later prefetch job.
+  GBytes *GetGridTile(PdfDocument *document, int page_index, int zoom_bucket, int column, int row,
+                      const RenderToken *token, int *width, int *height);
+} // namespace pdfviewer
+
+#endif
@@ -68,8 +68,10 @@ class SyncfusionFlutterPdfViewerPlugin extends PdfViewerPlatform {
     int pageNumber,
     int fullWidth,
     int fullHeight,
-    String documentID,
-  ) async {
+    String documentID, {
+    int? requestID,
+    PdfRenderQuality quality = PdfRenderQuality.full,
+  }) async {
     if (_documentRepo[documentID] != null) {
       PdfJsPage page =
           await (_documentRepo[documentID]!.getPage(pageNumber)).toDart;
@@ -87,8 +89,10 @@ class SyncfusionFlutterPdfViewerPlugin extends PdfViewerPlatform {
     double y,
     double width,
     double height,
-    String documentID,
-  ) async {
+    String documentID, {
+    int? requestID,
+    PdfRenderQuality quality = PdfRenderQuality.full,
+  }) async {
     if (_documentRepo[documentID] != null) {
       PdfJsPage page =
           await (_documentRepo[documentID]!.getPage(pageNumber)).toDart;
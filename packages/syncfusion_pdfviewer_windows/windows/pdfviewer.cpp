@@ -52,7 +52,7 @@ namespace pdfviewer
       FPDF_InitLibraryWithConfig(nullptr);
     }
 
-    std::shared_ptr<PdfDocument> doc = std::make_shared<PdfDocument>(data, password, docID);
+    std::shared_ptr<PdfDocument> doc = std::make_shared<PdfDocument>(std::move(data), password, docID);
     documentRepo[docID] = doc;
 
     return doc;
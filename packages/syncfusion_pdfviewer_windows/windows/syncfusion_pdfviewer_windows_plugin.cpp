@@ -87,7 +87,7 @@ namespace pdfviewer
     }
 
     std::string docID = std::get<std::string>(documentID->second);
-    std::shared_ptr<PdfDocument> pdfDoc = initializePdfRenderer(bytes, password.value_or(""), docID);
+    std::shared_ptr<PdfDocument> pdfDoc = initializePdfRenderer(std::move(bytes), password.value_or(""), docID);
     int pageCount = FPDF_GetPageCount(pdfDoc->pdfDocument);
     result->Success(flutter::EncodableValue(std::to_string(pageCount)));
   }
@@ -217,22 +217,18 @@ namespace pdfviewer
     }
     FPDF_DOCUMENT document = documentPtr->pdfDocument;
     FPDF_PAGE page = FPDF_LoadPage(document, index - 1);
-   
-    // Create empty bitmap and render page onto it
-    auto bitmap = FPDFBitmap_Create(width, height, 0);
+
+    // Render straight into the vector that is handed over to the codec, with
+    // tightly packed rows, so the pixels are never copied on the native side.
+    std::vector<uint8_t> imageData(static_cast<size_t>(width) * height * 4);
+    auto bitmap = FPDFBitmap_CreateEx(width, height, FPDFBitmap_BGRx, imageData.data(), width * 4);
     FPDFBitmap_FillRect(bitmap, 0, 0, width, height, 0xFFFFFFFF);
     FPDF_RenderPageBitmap(bitmap, page, 0, 0, width, height, 0, FPDF_LCD_TEXT | FPDF_REVERSE_BYTE_ORDER);
 
-    uint8_t *scanArg = static_cast<uint8_t *>(FPDFBitmap_GetBuffer(bitmap));
-     
-    // Calculate the total size of the pixel buffer
-    size_t bufferSize = width * height * 4; 
-    std::vector<uint8_t> imageData(scanArg, scanArg + bufferSize);
-
     FPDFBitmap_Destroy(bitmap);
     FPDF_ClosePage(page);
 
-    result->Success(flutter::EncodableValue(imageData));
+    result->Success(flutter::EncodableValue(std::move(imageData)));
   }
 
   void GetPdfPageTileImage(
@@ -260,20 +256,16 @@ namespace pdfviewer
     FS_MATRIX matrix = {(float)scale, 0, 0, (float)scale, (float)(-x * scale), (float)(-y * scale)};
     FS_RECTF rect = {0,0, (float)(width * scale), (float)(height * scale)};
 
-    // Create empty bitmap and render page onto it
-    auto bitmap = FPDFBitmap_Create(width, height, 0);
+    // Render straight into the vector that is handed over to the codec
+    std::vector<uint8_t> imageData(static_cast<size_t>(width) * height * 4);
+    auto bitmap = FPDFBitmap_CreateEx(width, height, FPDFBitmap_BGRx, imageData.data(), width * 4);
     FPDFBitmap_FillRect(bitmap, 0, 0, width, height, 0xFFFFFFFF);
     FPDF_RenderPageBitmapWithMatrix(bitmap, page, &matrix, &rect, FPDF_LCD_TEXT | FPDF_REVERSE_BYTE_ORDER);
-    uint8_t *scanArg = static_cast<uint8_t *>(FPDFBitmap_GetBuffer(bitmap));
-     
-    // Calculate the total size of the pixel buffer
-    size_t bufferSize = width * height * 4; 
-    std::vector<uint8_t> imageData(scanArg, scanArg + bufferSize);
 
     FPDFBitmap_Destroy(bitmap);
     FPDF_ClosePage(page);
 
-    result->Success(flutter::EncodableValue(imageData));
+    result->Success(flutter::EncodableValue(std::move(imageData)));
   }
 
   void SyncfusionPdfviewerWindowsPlugin::HandleMethodCall(